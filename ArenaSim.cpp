@@ -0,0 +1,293 @@
+#include "ArenaSim.h"
+#include "SnakeRules.h"
+
+const Vec2i ArenaSim::kDirs[4] = { { 0, 1 }, { 0, -1 }, { -1, 0 }, { 1, 0 } };
+
+int ArenaSim::DirCode(Vec2i dir) {
+    for (int i = 0; i < 4; ++i)
+        if (kDirs[i] == dir) return i;
+    return -1;
+}
+
+void ArenaSim::TickEvents::Clear() {
+    aliveBefore = 0;
+    spawns.clear();
+    food.clear();
+}
+
+ArenaSim::ArenaSim(int gridWidth, int gridHeight, int foods, uint64_t seed)
+    : width(gridWidth), height(gridHeight), foodCount(foods < kMaxFood ? foods : kMaxFood),
+      grid(gridWidth, gridHeight), rng(seed) {
+    size_t cells = (size_t)width * height;
+    foodAt.assign(cells, 0);
+    headCount.assign(cells, 0);
+    vacating.assign(cells, 0);
+}
+
+uint32_t ArenaSim::AliveMask() const {
+    uint32_t mask = 0;
+    for (int s = 0; s < kMaxSnakes; ++s)
+        if (snakes[s].alive) mask |= 1u << s;
+    return mask;
+}
+
+int ArenaSim::Join() {
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (joined[s] || snakes[s].alive) continue;
+        joined[s] = true;
+        leaving[s] = false;
+        respawnIn[s] = 0;
+        queueHead[s] = queueSize[s] = 0;
+        players++;
+        return s;
+    }
+    return -1;
+}
+
+void ArenaSim::Leave(int slot) {
+    if (slot >= 0 && slot < kMaxSnakes && joined[slot]) leaving[slot] = true;
+}
+
+bool ArenaSim::QueueDirection(int slot, Vec2i dir) {
+    // 与队列里最后一个方向比，连按两次反方向也掉不了头
+    Vec2i last = queueSize[slot] > 0 ? dirQueue[slot][(queueHead[slot] + queueSize[slot] - 1) % kMaxQueued] : snakes[slot].direction;
+    if (SnakeRules::IsReverse(last, dir) || last == dir) return false;
+    if (queueSize[slot] == kMaxQueued) return false;
+    dirQueue[slot][(queueHead[slot] + queueSize[slot]) % kMaxQueued] = dir;
+    queueSize[slot]++;
+    return true;
+}
+
+void ArenaSim::Step() {
+    events.Clear();
+    events.aliveBefore = AliveMask();
+
+    // 先定下每条蛇的新头，再统一判定碰撞：所有蛇看到的都是 tick 开始时的棋盘
+    // 没有算新头的槽位留在 (0, 0)，那是墙
+    Vec2i heads[kMaxSnakes] = {};
+    bool dead[kMaxSnakes] = {}, grow[kMaxSnakes] = {};
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        Snake& snake = snakes[s];
+        if (!snake.alive) continue;
+        if (leaving[s]) {
+            dead[s] = true;
+            continue;
+        }
+        if (queueSize[s] > 0) {
+            Vec2i next = dirQueue[s][queueHead[s]];
+            queueHead[s] = (queueHead[s] + 1) % kMaxQueued;
+            queueSize[s]--;
+            if (!SnakeRules::IsReverse(snake.direction, next)) snake.direction = next;
+        }
+        Vec2i h = { snake.body.Front().x + snake.direction.x, snake.body.Front().y + snake.direction.y };
+        heads[s] = h;
+        grow[s] = !SnakeRules::HitsWall(h, width, height) && foodAt[Index(h)];
+        if (!grow[s]) vacating[Index(snake.body.Back())] = 1;
+    }
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (!snakes[s].alive || dead[s]) continue;
+        if (SnakeRules::HitsWall(heads[s], width, height)) {
+            dead[s] = true;
+            continue;
+        }
+        size_t i = Index(heads[s]);
+        if (SnakeRules::HitsBody(grid.Occupied(heads[s]), vacating[i] != 0, false)) dead[s] = true;
+        else headCount[i]++;
+    }
+    // 两条一节的蛇互换位置：各自走进对方让开的尾格，上面的判定放过了，算迎面相撞，两条都死
+    // 长一点的蛇头后面还有身体，走进它的头格已经算撞身体
+    bool swapped[kMaxSnakes] = {};
+    for (int a = 0; a < kMaxSnakes; ++a) {
+        if (!snakes[a].alive || dead[a] || snakes[a].body.Size() != 1) continue;
+        for (int b = a + 1; b < kMaxSnakes; ++b) {
+            if (!snakes[b].alive || dead[b] || snakes[b].body.Size() != 1) continue;
+            if (heads[a] == snakes[b].body.Front() && heads[b] == snakes[a].body.Front()) swapped[a] = swapped[b] = true;
+        }
+    }
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (!snakes[s].alive) continue;
+        if (!dead[s] && (swapped[s] || headCount[Index(heads[s])] > 1)) dead[s] = true;
+        events.result[s] = dead[s] ? kDied : (uint8_t)(DirCode(snakes[s].direction) | (grow[s] ? kGrew : 0));
+    }
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (!snakes[s].alive) continue;
+        vacating[Index(snakes[s].body.Back())] = 0;
+        if (!SnakeRules::HitsWall(heads[s], width, height)) headCount[Index(heads[s])] = 0;
+    }
+    ApplyMoves(events);
+
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (leaving[s]) {
+            joined[s] = leaving[s] = false;
+            players--;
+        }
+        else if ((events.aliveBefore >> s & 1) && (events.result[s] & kDied)) {
+            respawnIn[s] = kRespawnTicks;
+        }
+    }
+    // 重生在移动之后，看到的是本 tick 结束时的棋盘；蛇头朝向离得远的那面墙
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (!joined[s] || snakes[s].alive) continue;
+        if (respawnIn[s] > 0) {
+            respawnIn[s]--;
+            continue;
+        }
+        Vec2i cell;
+        if (!RandomFreeCell(cell)) continue;
+        Spawn spawn;
+        spawn.slot = (uint8_t)s;
+        spawn.dir = (uint8_t)(cell.x < width / 2 ? 3 : 2);
+        spawn.cell = cell;
+        Vec2i ahead = { cell.x + kDirs[spawn.dir].x, cell.y };
+        if (!Free(ahead)) continue;
+        queueHead[s] = queueSize[s] = 0;
+        events.spawns.push_back(spawn);
+        SpawnSnake(spawn);
+    }
+    Vec2i cell;
+    while ((int)food.size() < foodCount && RandomFreeCell(cell)) {
+        events.food.push_back(cell);
+        AddFood(cell);
+    }
+}
+
+bool ArenaSim::Apply(const TickEvents& e) {
+    if (!ApplyMoves(e)) return false;
+    for (const Spawn& s : e.spawns) {
+        if (s.slot >= kMaxSnakes || s.dir > 3 || snakes[s.slot].alive || !Free(s.cell)) return false;
+        SpawnSnake(s);
+    }
+    for (Vec2i c : e.food) {
+        if (!PlaceFood(c)) return false;
+    }
+    return true;
+}
+
+// 两遍：先移除死掉的蛇、让出蛇尾，再放新头，走进别的蛇刚让出的尾格不会出错
+bool ArenaSim::ApplyMoves(const TickEvents& e) {
+    if (e.aliveBefore != AliveMask()) return false;
+    tick++;
+    Vec2i heads[kMaxSnakes];
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (!(e.aliveBefore >> s & 1)) continue;
+        Snake& snake = snakes[s];
+        uint8_t r = e.result[s];
+        snake.body.BeginTick();
+        if (r & kDied) {
+            Kill(s);
+            continue;
+        }
+        Vec2i d = kDirs[r & 3];
+        heads[s] = { snake.body.Front().x + d.x, snake.body.Front().y + d.y };
+        snake.direction = d;
+        if (!(r & kGrew)) {
+            grid.Release(snake.body.Back());
+            snake.body.PopBack();
+        }
+    }
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        if (!(e.aliveBefore >> s & 1) || (e.result[s] & kDied)) continue;
+        Vec2i h = heads[s];
+        if (SnakeRules::HitsWall(h, width, height) || grid.Occupied(h)) return false;
+        if ((e.result[s] & kGrew) && !HasFood(h)) return false;
+        snakes[s].body.PushFront(h);
+        grid.Occupy(h);
+        if (e.result[s] & kGrew) EatFood(h);
+    }
+    return true;
+}
+
+void ArenaSim::ResetTo(unsigned long long t) {
+    for (int s = 0; s < kMaxSnakes; ++s)
+        if (snakes[s].alive) Kill(s);
+    for (Vec2i c : food) foodAt[Index(c)] = 0;
+    food.clear();
+    tick = t;
+}
+
+bool ArenaSim::PlaceSnake(int slot, const Vec2i* cells, size_t count, Vec2i direction) {
+    if (slot < 0 || slot >= kMaxSnakes || count == 0 || snakes[slot].alive) return false;
+    for (size_t i = 0; i < count; ++i)
+        if (!Free(cells[i])) return false;
+    Snake& snake = snakes[slot];
+    snake.body.Clear();
+    for (size_t i = count; i-- > 0;) {
+        snake.body.PushFront(cells[i]);
+        grid.Occupy(cells[i]);
+    }
+    snake.body.BeginTick();
+    snake.direction = direction;
+    snake.alive = true;
+    return true;
+}
+
+bool ArenaSim::PlaceFood(Vec2i cell) {
+    if (!Free(cell) || (int)food.size() >= kMaxFood) return false;
+    AddFood(cell);
+    return true;
+}
+
+bool ArenaSim::Free(Vec2i cell) const {
+    return !SnakeRules::HitsWall(cell, width, height) && !grid.Occupied(cell) && !foodAt[Index(cell)];
+}
+
+void ArenaSim::Kill(int slot) {
+    Snake& snake = snakes[slot];
+    for (size_t i = 0; i < snake.body.Size(); ++i) grid.Release(snake.body[i]);
+    snake.body.Clear();
+    snake.alive = false;
+}
+
+void ArenaSim::SpawnSnake(const Spawn& s) {
+    Snake& snake = snakes[s.slot];
+    snake.body.Clear();
+    snake.body.PushFront(s.cell);
+    snake.body.BeginTick();
+    snake.direction = kDirs[s.dir];
+    snake.alive = true;
+    grid.Occupy(s.cell);
+}
+
+void ArenaSim::AddFood(Vec2i cell) {
+    foodAt[Index(cell)] = 1;
+    food.push_back(cell);
+}
+
+// 交换删除；服务器和客户端按同样的顺序吃，食物数组的顺序两边一致
+void ArenaSim::EatFood(Vec2i cell) {
+    foodAt[Index(cell)] = 0;
+    for (size_t i = 0; i < food.size(); ++i) {
+        if (food[i] == cell) {
+            food[i] = food.back();
+            food.pop_back();
+            return;
+        }
+    }
+}
+
+bool ArenaSim::RandomFreeCell(Vec2i& cell) {
+    for (int i = 0; i < 64 && grid.FreeCount() > 0; ++i) {
+        cell = grid.FreeCell(rng.Below(grid.FreeCount()));
+        if (!foodAt[Index(cell)]) return true;
+    }
+    return false;
+}
+
+uint32_t ArenaSim::StateHash() const {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            h ^= (v >> (i * 8)) & 0xFF;
+            h *= 16777619u;
+        }
+    };
+    mix((uint32_t)tick);
+    for (int s = 0; s < kMaxSnakes; ++s) {
+        const Snake& snake = snakes[s];
+        if (!snake.alive) continue;
+        mix((uint32_t)s << 24 | (uint32_t)snake.body.Size());
+        for (size_t i = 0; i < snake.body.Size(); ++i) mix((uint32_t)snake.body[i].x << 16 | (uint32_t)snake.body[i].y);
+    }
+    for (Vec2i c : food) mix((uint32_t)c.x << 16 | (uint32_t)c.y);
+    return h;
+}
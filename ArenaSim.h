@@ -0,0 +1,115 @@
+// ArenaSim.h
+#pragma once
+#include "SnakeBody.h"
+#include "OccupancyGrid.h"
+#include "Rng.h"
+#include <cstdint>
+#include <vector>
+
+// 联机房间：多条蛇在同一张棋盘上，同时移动
+// 每条蛇自己的规则与 SnakeSim 相同（SnakeRules.h），另外加上蛇与蛇之间的碰撞：
+//   头撞到任何一条蛇的身体（包括自己）都死；两个头走进同一格或互换位置都同归于尽；
+//   本 tick 不长的蛇尾会让开，任何蛇都可以走进去
+// 死掉的蛇整条移除，kRespawnTicks 之后在随机空格以一节重生；食物保持 foodCount 个
+// 房间按固定节拍推进，没有单人模式里按长度加速的规则
+//
+// 每个 tick 的变化记在 TickEvents 里，服务器用 Step 算出并应用，客户端收到后用 Apply 得到相同的局面
+class ArenaSim {
+public:
+    static constexpr int kMaxSnakes = 32;
+    static constexpr int kMaxSize = 64;
+    static constexpr int kMaxFood = 63;
+    static constexpr int kMaxQueued = 4;
+    static constexpr int kRespawnTicks = 20;
+
+    // 每条在 tick 开始时活着的蛇的结果：低 2 位方向码（与录像相同，上下左右），kGrew 表示吃到食物
+    static const uint8_t kGrew = 4;
+    static const uint8_t kDied = 8;
+
+    struct Spawn {
+        uint8_t slot;
+        uint8_t dir;
+        Vec2i cell;
+    };
+    struct TickEvents {
+        uint32_t aliveBefore = 0;           // tick 开始时活着的蛇，按槽位的位图
+        uint8_t result[kMaxSnakes] = {};    // 只有 aliveBefore 里的槽位有效
+        std::vector<Spawn> spawns;
+        std::vector<Vec2i> food;            // 新放下的食物，按顺序追加到 Food() 末尾
+
+        void Clear();
+    };
+
+    struct Snake {
+        SnakeBody body;
+        Vec2i direction = { 1, 0 };
+        bool alive = false;
+    };
+
+    // 宽高不超过 kMaxSize，foodCount 不超过 kMaxFood；客户端的副本 seed 随意
+    ArenaSim(int width, int height, int foodCount, uint64_t seed);
+
+    // 服务器：占一个空槽位，下一个 tick 出生；没有空位返回 -1
+    int Join();
+    // 服务器：下一个 tick 移除这条蛇并空出槽位
+    void Leave(int slot);
+    // 服务器：与 SnakeSim::QueueDirection 相同，反方向或队列已满时丢弃；与队尾相同的方向也丢弃
+    bool QueueDirection(int slot, Vec2i dir);
+    // 服务器：推进一个 tick，变化写进 Events()
+    void Step();
+    const TickEvents& Events() const { return events; }
+
+    // 客户端：应用服务器发来的一个 tick；与当前局面对不上时返回 false，之后要等完整快照
+    bool Apply(const TickEvents& e);
+    // 客户端：清空，之后用 Place* 逐个放回完整快照里的蛇（从头到尾）和食物，格子被占时返回 false
+    void ResetTo(unsigned long long tick);
+    bool PlaceSnake(int slot, const Vec2i* cells, size_t count, Vec2i direction);
+    bool PlaceFood(Vec2i cell);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    unsigned long long Tick() const { return tick; }
+    const Snake& GetSnake(int slot) const { return snakes[slot]; }
+    uint32_t AliveMask() const;
+    const std::vector<Vec2i>& Food() const { return food; }
+    // 墙和所有蛇身；食物不算
+    bool Occupied(Vec2i cell) const { return grid.Occupied(cell); }
+    bool HasFood(Vec2i cell) const { return foodAt[Index(cell)] != 0; }
+    int Players() const { return players; }
+
+    // tick、每条活着的蛇和食物的摘要，客户端用来发现与服务器不同步
+    uint32_t StateHash() const;
+
+    static const Vec2i kDirs[4];
+    static int DirCode(Vec2i dir);
+
+private:
+    size_t Index(Vec2i cell) const { return (size_t)cell.y * width + cell.x; }
+    bool ApplyMoves(const TickEvents& e);
+    bool Free(Vec2i cell) const;
+    void Kill(int slot);
+    void SpawnSnake(const Spawn& s);
+    void AddFood(Vec2i cell);
+    void EatFood(Vec2i cell);
+    // 不是墙、不被占用、没有食物的随机格子，找不到时返回 false
+    bool RandomFreeCell(Vec2i& cell);
+
+    int width, height, foodCount;
+    OccupancyGrid grid;
+    std::vector<uint8_t> foodAt;
+    std::vector<uint8_t> headCount;     // Step 里数每格有几个新蛇头
+    std::vector<uint8_t> vacating;      // Step 里标记本 tick 让开的蛇尾
+    std::vector<Vec2i> food;
+    Snake snakes[kMaxSnakes];
+    Rng rng;
+    unsigned long long tick = 0;
+    int players = 0;
+
+    // 以下只有服务器用
+    bool joined[kMaxSnakes] = {};
+    bool leaving[kMaxSnakes] = {};
+    int respawnIn[kMaxSnakes] = {};
+    Vec2i dirQueue[kMaxSnakes][kMaxQueued];
+    int queueHead[kMaxSnakes] = {}, queueSize[kMaxSnakes] = {};
+    TickEvents events;
+};
@@ -0,0 +1,61 @@
+#include "AssetPack.h"
+#include <cstring>
+
+namespace AssetPack {
+
+// 按字节查表的 CRC-32（IEEE 802.3，与 zlib 相同）
+static const uint32_t* CrcTable() {
+    static uint32_t table[256];
+    static bool ready = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)ready;
+    return table;
+}
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc) {
+    const uint32_t* table = CrcTable();
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+bool Parse(const uint8_t* data, size_t size, const PakHeader*& header, const PakEntry*& entries, const char*& names) {
+    if (size < sizeof(PakHeader)) return false;
+    const PakHeader* h = (const PakHeader*)data;
+    if (std::memcmp(h->magic, "SNPK", 4) != 0 || h->version != kVersion) return false;
+    size_t tableEnd = sizeof(PakHeader) + (size_t)h->count * sizeof(PakEntry);
+    if (h->count > size / sizeof(PakEntry) || tableEnd + h->namesSize > size) return false;
+    const PakEntry* e = (const PakEntry*)(data + sizeof(PakHeader));
+    for (uint32_t i = 0; i < h->count; ++i) {
+        if ((uint64_t)e[i].nameOffset + e[i].nameLength > h->namesSize) return false;
+        if (e[i].offset > size || e[i].size > size - e[i].offset) return false;
+    }
+    header = h;
+    entries = e;
+    names = (const char*)data + tableEnd;
+    return true;
+}
+
+int Find(const PakHeader& header, const PakEntry* entries, const char* names, const std::string& name) {
+    int lo = 0, hi = (int)header.count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const PakEntry& e = entries[mid];
+        size_t n = e.nameLength < name.size() ? e.nameLength : name.size();
+        int c = std::memcmp(names + e.nameOffset, name.data(), n);
+        if (c == 0) c = e.nameLength < name.size() ? -1 : (e.nameLength > name.size() ? 1 : 0);
+        if (c == 0) return mid;
+        if (c < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+}
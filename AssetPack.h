@@ -0,0 +1,39 @@
+// AssetPack.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 资源包文件（.pak）：shaders/ 与 textures/ 打成一个文件，运行时映射一次即可
+//   PakHeader | PakEntry × count（按名字字节序排好，二分查找）| 名字区 | 各文件内容
+//   每个文件内容的偏移按 kAlignment 对齐，可以直接交给 GL 或解码器；每项带 CRC32
+// 名字是相对资源根目录的路径，分隔符统一为 '/'，例如 "shaders/border.vert"
+// 全部字段小端
+
+struct PakHeader {
+    char magic[4];          // "SNPK"
+    uint32_t version;
+    uint32_t count;
+    uint32_t namesSize;
+};
+
+struct PakEntry {
+    uint64_t offset;        // 相对文件开头
+    uint64_t size;
+    uint32_t nameOffset;    // 相对名字区开头
+    uint32_t nameLength;
+    uint32_t crc;
+    uint32_t reserved;
+};
+
+namespace AssetPack {
+    const uint32_t kVersion = 1;
+    const size_t kAlignment = 64;
+
+    uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+
+    // 检查文件头、索引和各项范围，通过时 entries/names 指向 data 内部
+    bool Parse(const uint8_t* data, size_t size, const PakHeader*& header, const PakEntry*& entries, const char*& names);
+    // 在排好序的索引里二分查找，找不到时返回 -1
+    int Find(const PakHeader& header, const PakEntry* entries, const char* names, const std::string& name);
+}
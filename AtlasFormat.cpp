@@ -0,0 +1,117 @@
+#include "AtlasFormat.h"
+#include <cstring>
+
+namespace Atlas {
+
+int LevelCount(int size) {
+    int levels = 1;
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+size_t LevelBytes(int size, int layers, int level) {
+    size_t edge = (size_t)(size >> level);
+    if (edge == 0) edge = 1;
+    return edge * edge * 4 * (size_t)layers;
+}
+
+size_t DataOffset(int layers) {
+    return sizeof(AtlasHeader) + sizeof(AtlasEntry) * (size_t)layers;
+}
+
+// 对源图 [x0, x1) x [y0, y1) 的像素求 alpha 加权平均
+static void Average(const uint8_t* rgba, int width, int x0, int x1, int y0, int y1, uint8_t* out) {
+    unsigned long long r = 0, g = 0, b = 0, a = 0, n = 0;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const uint8_t* p = rgba + ((size_t)y * width + x) * 4;
+            r += (unsigned long long)p[0] * p[3];
+            g += (unsigned long long)p[1] * p[3];
+            b += (unsigned long long)p[2] * p[3];
+            a += p[3];
+            n++;
+        }
+    }
+    if (a > 0) {
+        out[0] = (uint8_t)((r + a / 2) / a);
+        out[1] = (uint8_t)((g + a / 2) / a);
+        out[2] = (uint8_t)((b + a / 2) / a);
+    }
+    else {
+        out[0] = out[1] = out[2] = 0;
+    }
+    out[3] = (uint8_t)((a + n / 2) / n);
+}
+
+void FitToLayer(const uint8_t* rgba, int width, int height, int size, uint8_t* layer, AtlasEntry& entry) {
+    std::memset(layer, 0, (size_t)size * size * 4);
+    // 比层大的图按长边等比缩小
+    int w = width, h = height;
+    if (w > size || h > size) {
+        if (w >= h) {
+            h = (int)((long long)h * size / w);
+            w = size;
+        }
+        else {
+            w = (int)((long long)w * size / h);
+            h = size;
+        }
+        if (w < 1) w = 1;
+        if (h < 1) h = 1;
+    }
+    for (int y = 0; y < h; ++y) {
+        int sy0 = (int)((long long)y * height / h), sy1 = (int)((long long)(y + 1) * height / h);
+        if (sy1 <= sy0) sy1 = sy0 + 1;
+        // 第 y 行（从上往下）放到层的第 h-1-y 行（从下往上）
+        uint8_t* row = layer + (size_t)(h - 1 - y) * size * 4;
+        for (int x = 0; x < w; ++x) {
+            int sx0 = (int)((long long)x * width / w), sx1 = (int)((long long)(x + 1) * width / w);
+            if (sx1 <= sx0) sx1 = sx0 + 1;
+            Average(rgba, width, sx0, sx1, sy0, sy1, row + (size_t)x * 4);
+        }
+    }
+    entry.u0 = 0.0f;
+    entry.v0 = 0.0f;
+    entry.u1 = (float)w / size;
+    entry.v1 = (float)h / size;
+}
+
+void Downsample(const uint8_t* src, int srcSize, uint8_t* dst) {
+    int dstSize = srcSize > 1 ? srcSize / 2 : 1;
+    for (int y = 0; y < dstSize; ++y)
+        for (int x = 0; x < dstSize; ++x)
+            Average(src, srcSize, x * 2, x * 2 + 2, y * 2, y * 2 + 2, dst + ((size_t)y * dstSize + x) * 4);
+}
+
+void AppendLevels(std::vector<uint8_t>& data, int size, int layers) {
+    size_t levelStart = data.size() - LevelBytes(size, layers, 0);
+    int levels = LevelCount(size);
+    for (int level = 1; level < levels; ++level) {
+        int srcEdge = size >> (level - 1), dstEdge = size >> level;
+        size_t srcLayerBytes = (size_t)srcEdge * srcEdge * 4, dstLayerBytes = (size_t)dstEdge * dstEdge * 4;
+        size_t dstStart = data.size();
+        data.resize(dstStart + dstLayerBytes * layers);
+        for (int i = 0; i < layers; ++i)
+            Downsample(&data[levelStart + srcLayerBytes * i], srcEdge, &data[dstStart + dstLayerBytes * i]);
+        levelStart = dstStart;
+    }
+}
+
+bool Parse(const uint8_t* data, size_t size, const AtlasHeader*& header, const AtlasEntry*& entries) {
+    if (size < sizeof(AtlasHeader)) return false;
+    const AtlasHeader* h = (const AtlasHeader*)data;
+    if (std::memcmp(h->magic, "SNKA", 4) != 0 || h->version != kVersion) return false;
+    if (h->size == 0 || (h->size & (h->size - 1)) != 0 || h->size > 8192) return false;
+    if (h->layers == 0 || h->layers > (uint32_t)kMaxLayers || h->levels != (uint32_t)LevelCount((int)h->size)) return false;
+    size_t need = DataOffset((int)h->layers);
+    for (uint32_t level = 0; level < h->levels; ++level) need += LevelBytes((int)h->size, (int)h->layers, (int)level);
+    if (size < need) return false;
+    header = h;
+    entries = (const AtlasEntry*)(data + sizeof(AtlasHeader));
+    return true;
+}
+
+}
@@ -0,0 +1,45 @@
+// AtlasFormat.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 纹理图集文件（.atlas）：所有图片放进同一张数组纹理，每张一层
+//   AtlasHeader | AtlasEntry × layers | 第 0 级全部层 | 第 1 级全部层 | ...
+//   每一级是 layers 张 (size >> level)² 的 RGBA8 图像，排布与 glTexImage3D 要的数据一致，整块拷进 PBO 就能上传
+//   图像已经上下翻转成 OpenGL 的纹理坐标方向；比层小的图片放在左下角，AtlasEntry 给出它占的 UV 范围
+// 全部字段小端、4 字节对齐
+
+struct AtlasHeader {
+    char magic[4];          // "SNKA"
+    uint32_t version;
+    uint32_t size;          // 层的边长，2 的幂
+    uint32_t layers;
+    uint32_t levels;        // mip 级数，包括第 0 级
+};
+
+struct AtlasEntry {
+    char name[48];          // 文件名，例如 "snake_head.png"
+    float u0, v0, u1, v1;
+};
+
+namespace Atlas {
+    const uint32_t kVersion = 1;
+    const int kMaxLayers = 32;      // 与精灵着色器中 layerRect 数组的长度一致
+
+    // size 到 1 的级数
+    int LevelCount(int size);
+    size_t LevelBytes(int size, int layers, int level);
+    // 图像数据区相对文件开头的偏移
+    size_t DataOffset(int layers);
+
+    // 解码得到的 RGBA（首行在上）缩放放进 size×size 的层，同时上下翻转；返回占用的 UV 范围
+    void FitToLayer(const uint8_t* rgba, int width, int height, int size, uint8_t* layer, AtlasEntry& entry);
+    // 2x2 平均得到下一级，颜色按 alpha 加权，透明像素不会把边缘染黑
+    void Downsample(const uint8_t* src, int srcSize, uint8_t* dst);
+    // 在第 0 级之后追加全部 mip 级，levels 为 LevelCount(size)
+    void AppendLevels(std::vector<uint8_t>& data, int size, int layers);
+
+    // 检查文件头和长度，通过时 header/entries 指向 data 内部
+    bool Parse(const uint8_t* data, size_t size, const AtlasHeader*& header, const AtlasEntry*& entries);
+}
@@ -0,0 +1,170 @@
+#include "Autopilot.h"
+
+static const Vec2i kDirs[4] = { { 0, 1 }, { 0, -1 }, { -1, 0 }, { 1, 0 } };
+
+Autopilot::Autopilot(int gridWidth, int gridHeight)
+    : width(gridWidth), height(gridHeight) {
+    size_t cells = (size_t)width * height;
+    stamp.assign(cells, 0);
+    parent.assign(cells, 0);
+    frontier.assign(cells, 0);
+    path.assign(cells, 0);
+    cycleNext.assign(cells, 0);
+    bodyStamp.assign(cells, 0);
+    BuildCycle();
+}
+
+// 内部区域 W x H 中有一边为偶数时存在哈密顿回路：
+// 以第 0 列为回程通道，其余列按行来回扫
+void Autopilot::BuildCycle() {
+    int W = width - 2, H = height - 2;
+    bool transpose = H % 2 != 0;
+    if (transpose) { int t = W; W = H; H = t; }
+    if (W < 2 || H % 2 != 0) return;
+
+    auto at = [&](int x, int y) -> uint32_t {
+        return transpose ? Index({ y + 1, x + 1 }) : Index({ x + 1, y + 1 });
+    };
+    std::vector<uint32_t> order;
+    order.reserve((size_t)W * H);
+    for (int y = 0; y < H; ++y) {
+        if (y % 2 == 0) for (int x = 1; x < W; ++x) order.push_back(at(x, y));
+        else for (int x = W - 1; x >= 1; --x) order.push_back(at(x, y));
+    }
+    for (int y = H - 1; y >= 0; --y) order.push_back(at(0, y));
+    for (size_t i = 0; i < order.size(); ++i) cycleNext[order[i]] = order[(i + 1) % order.size()];
+    hasCycle = true;
+}
+
+void Autopilot::NextStamp() {
+    // 代数戳回绕时才真正清零一次
+    if (++currentStamp == 0) {
+        for (uint32_t& s : stamp) s = 0;
+        currentStamp = 1;
+    }
+}
+
+bool Autopilot::Passable(const SnakeSim& sim, uint32_t cell, uint32_t tail) const {
+    return !sim.Occupied(CellOf(cell)) || cell == tail;
+}
+
+uint32_t Autopilot::MarkVirtualBody(const SnakeBody& body, size_t n) {
+    if (++currentBodyStamp == 0) {
+        for (uint32_t& s : bodyStamp) s = 0;
+        currentBodyStamp = 1;
+    }
+    // 新蛇身从蛇头起依次是 path[n-1] ... path[0]，再接上原来蛇身的前段
+    size_t length = body.Size() + 1, marked = 0;
+    uint32_t tail = 0;
+    for (size_t i = n; i > 0 && marked < length; --i, ++marked) {
+        tail = path[i - 1];
+        bodyStamp[tail] = currentBodyStamp;
+    }
+    for (size_t j = 0; marked < length; ++j, ++marked) {
+        tail = Index(body[j]);
+        bodyStamp[tail] = currentBodyStamp;
+    }
+    return tail;
+}
+
+bool Autopilot::Search(const SnakeSim& sim, uint32_t from, uint32_t to, uint32_t blocked, bool virtualBody) {
+    NextStamp();
+    uint32_t tail = Index(sim.Body().Back());
+    size_t head = 0, tailPos = 0;
+    frontier[tailPos++] = from;
+    stamp[from] = currentStamp;
+    while (head < tailPos) {
+        uint32_t cur = frontier[head++];
+        if (cur == to) return true;
+        Vec2i c = CellOf(cur);
+        for (Vec2i d : kDirs) {
+            uint32_t next = Index({ c.x + d.x, c.y + d.y });
+            if (stamp[next] == currentStamp || next == blocked) continue;
+            // 假想的局面里，原蛇身中不属于新蛇身的格子都已经让开
+            bool passable = virtualBody
+                ? bodyStamp[next] != currentBodyStamp && !IsWall(next)
+                : Passable(sim, next, tail);
+            if (!passable && next != to) continue;
+            stamp[next] = currentStamp;
+            parent[next] = cur;
+            frontier[tailPos++] = next;
+        }
+    }
+    return false;
+}
+
+Vec2i Autopilot::DirectionTo(Vec2i head, uint32_t cell) const {
+    Vec2i c = CellOf(cell);
+    return { c.x - head.x, c.y - head.y };
+}
+
+Vec2i Autopilot::NextDirection(const SnakeSim& sim) {
+    const SnakeBody& body = sim.Body();
+    Vec2i headCell = body.Front();
+    uint32_t head = Index(headCell);
+    uint32_t tail = Index(body.Back());
+    // 紧挨蛇头的一节不能走（那是掉头），长度为 2 时它同时也是蛇尾
+    uint32_t neck = body.Size() > 1 ? Index(body[1]) : UINT32_MAX;
+    Vec2i food = sim.Food();
+
+    // 食物没动时沿用上次的路径：路径上的格子在计算时是空的，
+    // 之后只有蛇尾在让格，只有蛇头沿着路径占格，所以它仍然安全
+    if (pathPos < pathLength && food == pathFood && (pathPos == 0 ? true : path[pathPos - 1] == head)) {
+        reused++;
+        return DirectionTo(headCell, path[pathPos++]);
+    }
+    pathLength = pathPos = 0;
+
+    size_t interior = (size_t)(width - 2) * (height - 2);
+    bool longSnake = hasCycle && body.Size() > interior * cycleThreshold;
+
+    if (food.x >= 0) {
+        searches++;
+        uint32_t target = Index(food);
+        if (Search(sim, head, target, neck)) {
+            // 回溯出完整路径
+            size_t n = 0;
+            for (uint32_t c = target; c != head; c = parent[c]) path[n++] = c;
+            for (size_t i = 0; i < n / 2; ++i) {
+                uint32_t t = path[i]; path[i] = path[n - 1 - i]; path[n - 1 - i] = t;
+            }
+            // 安全检查：假想走到食物并变长之后，从新蛇头仍能到达新蛇尾
+            uint32_t first = path[0];
+            uint32_t virtualTail = MarkVirtualBody(body, n);
+            bool safe = body.Size() < 2 || Search(sim, target, virtualTail, UINT32_MAX, true);
+            if (safe) {
+                pathLength = n;
+                pathPos = 1;
+                pathFood = food;
+                return DirectionTo(headCell, first);
+            }
+        }
+    }
+
+    // 长蛇找不到安全的路时改沿哈密顿回路走
+    if (longSnake) {
+        uint32_t next = cycleNext[head];
+        // 蛇身不一定排在回路上，走一步之后蛇尾仍可达才沿回路走
+        if (next != 0 && next != neck && Passable(sim, next, tail)) {
+            searches++;
+            if (Search(sim, next, tail, head)) return DirectionTo(headCell, next);
+        }
+    }
+
+    // 追蛇尾：取去往蛇尾路径的第一步
+    if (body.Size() > 2) {
+        searches++;
+        if (Search(sim, head, tail, neck)) {
+            uint32_t c = tail;
+            while (parent[c] != head) c = parent[c];
+            return DirectionTo(headCell, c);
+        }
+    }
+
+    // 实在没路就随便找一个能走的邻格
+    for (Vec2i d : kDirs) {
+        uint32_t n = Index({ headCell.x + d.x, headCell.y + d.y });
+        if (n != neck && Passable(sim, n, tail)) return d;
+    }
+    return sim.Direction();
+}
@@ -0,0 +1,59 @@
+// Autopilot.h
+#pragma once
+#include "SnakeSim.h"
+#include <vector>
+#include <cstdint>
+
+// 自动驾驶：给演示、待机画面和压力测试产生按键
+// 1. BFS 找到去食物的最短路，假想沿路走到食物并变长之后蛇尾仍然可达才采用
+// 2. 否则蛇很长时沿预先算好的哈密顿回路走一步
+// 3. 再否则追着自己的蛇尾走，保证不把自己困死
+// 所有数组在构造时按棋盘大小分配好，访问标记用代数戳，查询时不清零也不分配内存；
+// 食物没动时沿用上一次的路径
+class Autopilot {
+public:
+    Autopilot(int width, int height);
+
+    // 下一个 tick 应走的方向
+    Vec2i NextDirection(const SnakeSim& sim);
+    // 丢弃缓存的路径，下次必定重新搜索
+    void Invalidate() { pathLength = 0; }
+
+    unsigned long long Searches() const { return searches; }
+    unsigned long long Reused() const { return reused; }
+
+    // 蛇长超过内部格数的这个比例后才使用哈密顿回路
+    float cycleThreshold = 0.25f;
+
+private:
+    uint32_t Index(Vec2i c) const { return (uint32_t)c.y * (uint32_t)width + (uint32_t)c.x; }
+    Vec2i CellOf(uint32_t i) const { return { (int)(i % (uint32_t)width), (int)(i / (uint32_t)width) }; }
+    bool IsWall(uint32_t i) const {
+        Vec2i c = CellOf(i);
+        return c.x == 0 || c.y == 0 || c.x == width - 1 || c.y == height - 1;
+    }
+    bool Passable(const SnakeSim& sim, uint32_t cell, uint32_t tail) const;
+    // 从 from 出发 BFS 到 to，blocked 额外视为障碍；找到时 parent 链可回溯
+    // virtualBody 为真时障碍取自 MarkVirtualBody 标出的假想蛇身，而不是当前的棋盘
+    bool Search(const SnakeSim& sim, uint32_t from, uint32_t to, uint32_t blocked, bool virtualBody = false);
+    // 标出沿 path[0, n) 走到食物并长一节之后的蛇身，返回假想的蛇尾
+    uint32_t MarkVirtualBody(const SnakeBody& body, size_t n);
+    void NextStamp();
+    void BuildCycle();
+    Vec2i DirectionTo(Vec2i head, uint32_t cell) const;
+
+    int width, height;
+    std::vector<uint32_t> stamp;        // 等于 currentStamp 表示本次搜索已访问
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> path;         // 从蛇头之后的第一格到食物
+    std::vector<uint32_t> cycleNext;    // 哈密顿回路上的下一格，0 表示没有回路
+    std::vector<uint32_t> bodyStamp;    // 等于 currentBodyStamp 表示假想蛇身占用
+    uint32_t currentStamp = 0, currentBodyStamp = 0;
+    bool hasCycle = false;
+
+    size_t pathLength = 0, pathPos = 0;
+    Vec2i pathFood = { -1, -1 };
+
+    unsigned long long searches = 0, reused = 0;
+};
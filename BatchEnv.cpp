@@ -0,0 +1,155 @@
+#include "BatchEnv.h"
+#include "SnakeRules.h"
+#include <algorithm>
+
+static const Vec2i kDirs[4] = { { 0, 1 }, { 0, -1 }, { -1, 0 }, { 1, 0 } };
+static const int8_t kRight = 3;
+
+BatchEnv::BatchEnv(size_t envCount, int gridWidth, int gridHeight, uint64_t seed, ThreadPool* threadPool)
+    : count(envCount), width(gridWidth), height(gridHeight), pool(threadPool) {
+    width = std::min(std::max(width, 3), (int)(kMaxCells / 3));
+    height = std::min(std::max(height, 3), (int)(kMaxCells / width));
+    cells = (size_t)width * height;
+    interior = (size_t)(width - 2) * (height - 2);
+    ringSize = interior;
+
+    bodyCells.assign(count * ringSize, 0);
+    bodyHead.assign(count, 0);
+    bodyLength.assign(count, 0);
+    freeCells.assign(count * interior, 0);
+    freeSlot.assign(count * cells, 0);
+    freeCount.assign(count, 0);
+    direction.assign(count, kRight);
+    food.assign(count, 0);
+    hasFood.assign(count, 0);
+    rngs.assign(count, Rng());
+    seeds.assign(count, 0);
+    obs.assign(count * cells, EMPTY);
+    rewards.assign(count, 0.0f);
+    dones.assign(count, 0);
+
+    Rng master(seed);
+    for (size_t e = 0; e < count; ++e) {
+        // 空格集合的初始顺序与 OccupancyGrid 相同：逐行、逐列
+        uint8_t* o = &obs[e * cells];
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                uint16_t cell = (uint16_t)(y * width + x);
+                if (x == 0 || y == 0 || x == width - 1 || y == height - 1) {
+                    o[cell] = WALL;
+                }
+                else {
+                    freeSlot[e * cells + cell] = (uint16_t)freeCount[e];
+                    freeCells[e * interior + freeCount[e]++] = cell;
+                }
+            }
+        }
+        ResetEnv(e, master.Next());
+    }
+}
+
+void BatchEnv::Occupy(size_t e, uint16_t cell) {
+    uint16_t* slots = &freeSlot[e * cells];
+    uint16_t* list = &freeCells[e * interior];
+    uint16_t slot = slots[cell];
+    uint16_t last = list[--freeCount[e]];
+    list[slot] = last;
+    slots[last] = slot;
+}
+
+void BatchEnv::Release(size_t e, uint16_t cell) {
+    obs[e * cells + cell] = EMPTY;
+    freeSlot[e * cells + cell] = (uint16_t)freeCount[e];
+    freeCells[e * interior + freeCount[e]++] = cell;
+}
+
+void BatchEnv::SpawnFood(size_t e) {
+    if (freeCount[e] == 0) {
+        hasFood[e] = 0;
+        return;
+    }
+    food[e] = freeCells[e * interior + rngs[e].Below(freeCount[e])];
+    hasFood[e] = 1;
+    obs[e * cells + food[e]] = FOOD;
+}
+
+void BatchEnv::ResetEnv(size_t e, uint64_t seed) {
+    seeds[e] = seed;
+    rngs[e].Seed(seed);
+
+    // 与 SnakeSim::Reset 相同：按从头到尾的顺序释放蛇身
+    const uint16_t* ring = &bodyCells[e * ringSize];
+    for (uint32_t i = 0; i < bodyLength[e]; ++i)
+        Release(e, ring[(bodyHead[e] + i) % ringSize]);
+    uint8_t* o = &obs[e * cells];
+    if (hasFood[e] && o[food[e]] == FOOD) o[food[e]] = EMPTY;
+
+    uint16_t start = (uint16_t)((height / 2) * width + width / 2);
+    bodyHead[e] = 0;
+    bodyLength[e] = 1;
+    bodyCells[e * ringSize] = start;
+    o[start] = HEAD;
+    Occupy(e, start);
+    direction[e] = kRight;
+    SpawnFood(e);
+}
+
+void BatchEnv::StepEnv(size_t e, int8_t action) {
+    rewards[e] = 0.0f;
+    dones[e] = 0;
+
+    if (action >= 0 && action < 4 && !SnakeRules::IsReverse(kDirs[direction[e]], kDirs[action]))
+        direction[e] = action;
+    Vec2i dir = kDirs[direction[e]];
+
+    uint16_t* ring = &bodyCells[e * ringSize];
+    uint8_t* o = &obs[e * cells];
+    uint32_t head = bodyHead[e], length = bodyLength[e];
+    uint16_t headCell = ring[head];
+    Vec2i newHead = { headCell % width + dir.x, headCell / width + dir.y };
+
+    bool dead = SnakeRules::HitsWall(newHead, width, height);
+    if (!dead) {
+        uint16_t newCell = (uint16_t)(newHead.y * width + newHead.x);
+        bool growing = hasFood[e] && newCell == food[e];
+        uint16_t tailCell = ring[(head + length - 1) % ringSize];
+        bool occupied = o[newCell] == BODY || o[newCell] == HEAD;
+        dead = SnakeRules::HitsBody(occupied, newCell == tailCell, growing);
+
+        if (!dead) {
+            // 旧蛇头先变成蛇身，长度为 1 时它同时也是马上要让开的尾格
+            o[headCell] = BODY;
+            if (!growing) {
+                Release(e, tailCell);
+                length--;
+            }
+            head = head == 0 ? (uint32_t)ringSize - 1 : head - 1;
+            ring[head] = newCell;
+            length++;
+            o[newCell] = HEAD;
+            Occupy(e, newCell);
+            bodyHead[e] = head;
+            bodyLength[e] = length;
+            if (growing) {
+                rewards[e] = 1.0f;
+                SpawnFood(e);
+            }
+        }
+    }
+
+    if (dead) {
+        rewards[e] = -1.0f;
+        dones[e] = 1;
+        ResetEnv(e, rngs[e].Next());
+    }
+}
+
+void BatchEnv::StepBatch(const int8_t* actions) {
+    if (!pool) {
+        for (size_t e = 0; e < count; ++e) StepEnv(e, actions[e]);
+        return;
+    }
+    pool->ParallelFor(count, 256, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; ++e) StepEnv(e, actions[e]);
+    });
+}
@@ -0,0 +1,70 @@
+// BatchEnv.h
+#pragma once
+#include "SnakeBody.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <cstdint>
+
+// N 局游戏按结构数组（SoA）存放，一次 StepBatch 推进全部，用于机器人训练和大批量校验
+// 规则来自 SnakeRules.h，与 SnakeSim 逐格一致：同一个种子、同样的动作序列得到同样的局面
+// 观察、奖励、结束标记都是连续的数组，直接返回指针，不做复制
+class BatchEnv {
+public:
+    // 观察数组中每格的取值
+    enum Cell : uint8_t { EMPTY = 0, BODY = 1, HEAD = 2, FOOD = 3, WALL = 4 };
+    // 动作：-1 保持方向，0~3 为上下左右（与录像的方向码一致）
+    static const int8_t kKeep = -1;
+
+    // 格子下标是 16 位的，棋盘最多 kMaxCells 格
+    static const size_t kMaxCells = 65536;
+
+    // 宽高至少为 3；格数超过 kMaxCells 时先缩小高度，宽度本身太大时也缩小，实际尺寸见 Width()/Height()
+    // pool 为空时单线程运行
+    BatchEnv(size_t count, int width, int height, uint64_t seed, ThreadPool* pool = nullptr);
+
+    // actions 长度为 Count()；结束的局在同一步内自动以新种子重开
+    void StepBatch(const int8_t* actions);
+
+    size_t Count() const { return count; }
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // 第 e 局的棋盘位于 Observations() + e * Width() * Height()，按行存放
+    const uint8_t* Observations() const { return obs.data(); }
+    // 本步奖励：吃到食物 +1，死亡 -1
+    const float* Rewards() const { return rewards.data(); }
+    // 本步是否结束（已经自动重开）
+    const uint8_t* Dones() const { return dones.data(); }
+    const uint32_t* Lengths() const { return bodyLength.data(); }
+    const uint64_t* Seeds() const { return seeds.data(); }
+
+private:
+    void ResetEnv(size_t e, uint64_t seed);
+    void StepEnv(size_t e, int8_t action);
+    void Occupy(size_t e, uint16_t cell);
+    void Release(size_t e, uint16_t cell);
+    void SpawnFood(size_t e);
+
+    size_t count;
+    int width, height;
+    size_t cells, interior, ringSize;
+    ThreadPool* pool;
+
+    // 每局一段的蛇身环形缓冲（格子下标）
+    std::vector<uint16_t> bodyCells;
+    std::vector<uint32_t> bodyHead, bodyLength;
+    // 每局一段的空格集合（与 OccupancyGrid 相同的交换删除顺序）
+    std::vector<uint16_t> freeCells, freeSlot;
+    std::vector<uint32_t> freeCount;
+
+    std::vector<int8_t> direction;
+    std::vector<uint16_t> food;
+    std::vector<uint8_t> hasFood;
+    std::vector<Rng> rngs;
+    std::vector<uint64_t> seeds;
+
+    std::vector<uint8_t> obs;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+};
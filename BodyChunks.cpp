@@ -0,0 +1,58 @@
+#include "BodyChunks.h"
+#include <cstring>
+
+void BodyChunks::Clear() {
+    for (auto& kv : lookup) {
+        Chunk& chunk = chunks[kv.second];
+        std::memset(chunk.bits, 0, sizeof(chunk.bits));
+        chunk.entries.clear();
+        chunk.first = 0;
+        freeChunks.push_back(kv.second);
+    }
+    lookup.clear();
+}
+
+void BodyChunks::Insert(Vec2i cell, uint64_t serial) {
+    uint64_t key = Key(cell.x >> kShift, cell.y >> kShift);
+    auto it = lookup.find(key);
+    uint32_t index;
+    if (it != lookup.end()) {
+        index = it->second;
+    }
+    else {
+        if (!freeChunks.empty()) {
+            index = freeChunks.back();
+            freeChunks.pop_back();
+        }
+        else {
+            index = (uint32_t)chunks.size();
+            chunks.emplace_back();
+            std::memset(chunks.back().bits, 0, sizeof(chunks.back().bits));
+        }
+        lookup.emplace(key, index);
+    }
+    Chunk& chunk = chunks[index];
+    chunk.bits[cell.y & (kSize - 1)] |= 1ULL << (cell.x & (kSize - 1));
+    chunk.entries.push_back({ cell, serial });
+}
+
+void BodyChunks::RemoveOldest(Vec2i cell) {
+    auto it = lookup.find(Key(cell.x >> kShift, cell.y >> kShift));
+    if (it == lookup.end()) return;
+    Chunk& chunk = chunks[it->second];
+    chunk.bits[cell.y & (kSize - 1)] &= ~(1ULL << (cell.x & (kSize - 1)));
+    chunk.first++;
+
+    if (chunk.first == chunk.entries.size()) {
+        // 蛇身离开了这一块
+        chunk.entries.clear();
+        chunk.first = 0;
+        freeChunks.push_back(it->second);
+        lookup.erase(it);
+    }
+    else if (chunk.first >= kSize && chunk.first * 2 >= chunk.entries.size()) {
+        // 队首空出一半以上时整体前移，摊还 O(1)
+        chunk.entries.erase(chunk.entries.begin(), chunk.entries.begin() + chunk.first);
+        chunk.first = 0;
+    }
+}
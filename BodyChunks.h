@@ -0,0 +1,67 @@
+// BodyChunks.h
+#pragma once
+#include "SnakeBody.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// 蛇身的分块空间索引：棋盘按 64x64 切块，只有蛇身经过的块才存在
+// 每块一张 64x64 位图做碰撞检测，再加一个按进入先后排列的格子队列做渲染裁剪
+// 蛇尾总是全身最早进入的一节，所以它一定在所在块队列的队首，增删都是 O(1)
+// 内存只和蛇身覆盖的块数有关，与棋盘大小无关
+class BodyChunks {
+public:
+    static const int kShift = 6;
+    static const int kSize = 1 << kShift;
+
+    struct Entry {
+        Vec2i cell;
+        uint64_t serial;    // SnakeBody::Serial，用 IndexOfSerial 换回第几节
+    };
+
+    void Clear();
+    bool Occupied(Vec2i cell) const {
+        const Chunk* chunk = Find(cell.x >> kShift, cell.y >> kShift);
+        return chunk && (chunk->bits[cell.y & (kSize - 1)] >> (cell.x & (kSize - 1))) & 1;
+    }
+    void Insert(Vec2i cell, uint64_t serial);
+    // 移除 cell 所在块中最早进入的一节，调用方保证那就是蛇尾 cell
+    void RemoveOldest(Vec2i cell);
+
+    // 对 [minX, maxX] x [minY, maxY] 内的每一节调用 fn(const Entry&)
+    // 只访问与矩形相交的块，开销取决于矩形大小而不是蛇长
+    template <typename Fn>
+    void ForEachInRect(int minX, int minY, int maxX, int maxY, Fn fn) const {
+        if (minX < 0) minX = 0;
+        if (minY < 0) minY = 0;
+        for (int cy = minY >> kShift; cy <= maxY >> kShift; ++cy) {
+            for (int cx = minX >> kShift; cx <= maxX >> kShift; ++cx) {
+                const Chunk* chunk = Find(cx, cy);
+                if (!chunk) continue;
+                for (size_t i = chunk->first; i < chunk->entries.size(); ++i) {
+                    const Entry& e = chunk->entries[i];
+                    if (e.cell.x >= minX && e.cell.x <= maxX && e.cell.y >= minY && e.cell.y <= maxY) fn(e);
+                }
+            }
+        }
+    }
+
+    size_t ChunkCount() const { return lookup.size(); }
+
+private:
+    struct Chunk {
+        uint64_t bits[kSize];
+        std::vector<Entry> entries;     // [first, size) 为块内现存的节，按序号递增
+        size_t first = 0;
+    };
+
+    static uint64_t Key(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+    const Chunk* Find(int cx, int cy) const {
+        auto it = lookup.find(Key(cx, cy));
+        return it == lookup.end() ? nullptr : &chunks[it->second];
+    }
+
+    std::unordered_map<uint64_t, uint32_t> lookup;     // 块坐标 -> chunks 下标
+    std::vector<Chunk> chunks;
+    std::vector<uint32_t> freeChunks;                   // 已清空可复用的块，保留队列容量
+};
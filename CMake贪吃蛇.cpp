@@ -1,76 +1,115 @@
 ﻿#define STB_IMAGE_IMPLEMENTATION
 #include "./external/stb/stb_image.h"
 #include "MapBorder.h"
+#include "SpriteBatch.h"
+#include "GlRenderer.h"
+#include "GlExt.h"
+#include "GlApi.h"
+#include "SnakeSim.h"
+#include "Replay.h"
+#include "Autopilot.h"
+#include "TileLayer.h"
+#include "SimThread.h"
+#include "Profiler.h"
+#include "GpuProfiler.h"
+#include "ShaderManager.h"
+#include "TextureAtlas.h"
+#include "ThreadPool.h"
+#include "Vfs.h"
+#include "FrameCapture.h"
+#include "FrameScheduler.h"
+#include "ParticleSystem.h"
+#include "ParticleLayer.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
-#include <fstream>
-#include <sstream>
-#include <deque>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
+#include <cstdio>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 
-struct Vec2i {
-    int x, y;
-    bool operator==(const Vec2i& other) const { return x == other.x && y == other.y; }
-};
-
 float toRadians(float degree) {
     return degree * 3.14159265f / 180.0f;
 }
 
-void resetGame(); 
-
 enum GameState { MENU, GAME, SETTINGS, EXIT };
 GameState gameState = MENU;
 
-const int gridWidth = 20;
-const int gridHeight = 20;
-const float cellSize = 2.0f / gridWidth;
-float moveInterval = 0.1f;
-float lastLogicTime = 0.0f;
-
-// 蛇
-std::deque<Vec2i> snake = { {10, 7} };
-Vec2i direction = { 1, 0 };
-std::deque<Vec2i> dirQueue;
-Vec2i food = { 5, 5 };
-std::deque<Vec2i> oldSnake;
-bool keyState[4] = { false, false, false, false };
+// 棋盘大小可由 --arena N 指定，超过一屏时相机跟随蛇头滚动
+int gridWidth = 20;
+int gridHeight = 20;
+// 一屏显示的格数，决定精灵大小
+const int viewCells = 20;
+const float cellSize = 2.0f / viewCells;
+bool largeArena = false;
+// 相机中心，单位为格；大地图上坐标可达 10 万，用 double 避免 float 精度抖动
+double cameraX = viewCells / 2.0, cameraY = viewCells / 2.0;
+
+// 蛇：规则与状态都在 SnakeSim 中，由逻辑线程推进；这里只负责输入和绘制
+SnakeSim sim(gridWidth, gridHeight);
+Rng seedSource;
+// 每局的录像，结束时写到 last_replay.snkr
+ReplayWriter replay;
+// 自动驾驶：游戏中按 A 切换，用于演示和压力测试
+// 寻路数组按整张棋盘分配，超大棋盘上不启用
+Autopilot autopilot(gridWidth, gridHeight);
+// 逻辑线程：一局开始时启动，按键事件经它的输入队列送达，画面取它发布的快照
+SimThread simThread(sim, replay, viewCells);
+// 帧调度：菜单和设置页静止时睡在窗口事件上，游戏中按帧率上限和 tick 时刻出帧
+FrameScheduler frameScheduler;
+// 粒子特效：吃到食物和死亡时炸开；坐标以格为单位，与相机无关
+// --particles N 时一直补满 N 个，用来压测
+ParticleSystem particles(65536);
+// 上一帧看到的 tick 和食物位置，食物换了地方就是被吃掉了
+unsigned long long effectTick = 0;
+Vec2i effectFood = { -1, -1 };
 float headAngle = 0.0f;
 
 // 顶点数据
 float vertices[] = {
-    -1.0f / (gridWidth + 1), -1.0f / (gridHeight + 1),  0.0f, 0.0f,
-     1.0f / (gridWidth + 1), -1.0f / (gridHeight + 1),  1.0f, 0.0f,
-     1.0f / (gridWidth + 1),  1.0f / (gridHeight + 1),  1.0f, 1.0f,
-    -1.0f / (gridWidth + 1), -1.0f / (gridHeight + 1),  0.0f, 0.0f,
-     1.0f / (gridWidth + 1),  1.0f / (gridHeight + 1),  1.0f, 1.0f,
-    -1.0f / (gridWidth + 1),  1.0f / (gridHeight + 1),  0.0f, 1.0f
+    -1.0f / (viewCells + 1), -1.0f / (viewCells + 1),  0.0f, 0.0f,
+     1.0f / (viewCells + 1), -1.0f / (viewCells + 1),  1.0f, 0.0f,
+     1.0f / (viewCells + 1),  1.0f / (viewCells + 1),  1.0f, 1.0f,
+    -1.0f / (viewCells + 1), -1.0f / (viewCells + 1),  0.0f, 0.0f,
+     1.0f / (viewCells + 1),  1.0f / (viewCells + 1),  1.0f, 1.0f,
+    -1.0f / (viewCells + 1),  1.0f / (viewCells + 1),  0.0f, 1.0f
 };
 
-// 顶点着色器
+// 顶点着色器：offset/angle/layer 与 color 为逐实例属性
+// layerRect 是图集每层图片占的 UV 范围，长度与 Atlas::kMaxLayers 一致
 const char* vertexShaderSource = R"(
 #version 330 core
 layout(location = 0) in vec2 aPos;
 layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec4 aInstance;   // xy: offset, z: angle, w: layer
+layout(location = 3) in vec4 aColor;
+
+uniform vec4 layerRect[32];
 
 out vec2 texCoord;
-uniform vec2 offset;
-uniform float angle;
+flat out float layer;
+out vec4 color;
 
 void main() {
-    float cosA = cos(angle);
-    float sinA = sin(angle);
+    float cosA = cos(aInstance.z);
+    float sinA = sin(aInstance.z);
     mat2 rotation = mat2(cosA, -sinA, sinA, cosA);
     vec2 rotatedPos = rotation * aPos;
-    gl_Position = vec4(rotatedPos + offset, 0.0, 1.0);
-    texCoord = aTexCoord;
+    gl_Position = vec4(rotatedPos + aInstance.xy, 0.0, 1.0);
+    vec4 rect = layerRect[int(aInstance.w)];
+    texCoord = mix(rect.xy, rect.zw, aTexCoord);
+    layer = aInstance.w;
+    color = aColor;
 }
 )";
 
@@ -78,75 +117,21 @@ void main() {
 const char* fragmentShaderSource = R"(
 #version 330 core
 in vec2 texCoord;
+flat in float layer;
+in vec4 color;
 out vec4 FragColor;
 
-uniform vec3 color;
-uniform sampler2D ourTexture;
+uniform sampler2DArray ourTexture;
 uniform bool useTexture;
 
 void main() {
     if(useTexture)
-        FragColor = texture(ourTexture, texCoord);
+        FragColor = texture(ourTexture, vec3(texCoord, layer));
     else
-        FragColor = vec4(color, 1.0);
+        FragColor = color;
 }
 )";
 
-// 纹理加载
-GLuint loadTexture(const char* path) {
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else {
-        std::cerr << "纹理加载失败: " << path << std::endl;
-    }
-    stbi_image_free(data);
-    return texture;
-}
-
-// 输入处理
-void processInput(GLFWwindow* window, Vec2i currentDir) {
-    // 键盘与方向映射表
-    struct KeyDir { int key; Vec2i dir; Vec2i opposite; };
-    KeyDir keys[4] = {
-        { GLFW_KEY_UP,    { 0,  1}, { 0, -1} },
-        { GLFW_KEY_DOWN,  { 0, -1}, { 0,  1} },
-        { GLFW_KEY_LEFT,  {-1,  0}, { 1,  0} },
-        { GLFW_KEY_RIGHT, { 1,  0}, {-1,  0} }
-    };
-
-    if (gameState == GAME) {
-        for (int i = 0; i < 4; i++) {
-            if (glfwGetKey(window, keys[i].key) == GLFW_PRESS) {
-                // “刚按下”时才触发
-                if (!keyState[i]) {
-                    // 防止反方向掉头
-                    if (!(currentDir.x == keys[i].opposite.x && currentDir.y == keys[i].opposite.y)) {
-                        dirQueue.push_back(keys[i].dir);
-                    }
-                    keyState[i] = true;
-                }
-            }
-            else {
-                // 松开时重置该按键状态
-                keyState[i] = false;
-            }
-        }
-    }
-}
-
 // 更新头部角度
 void updateHeadAngle(Vec2i dir) {
     if (dir.x == 1 && dir.y == 0) headAngle = 90.0f;
@@ -158,136 +143,140 @@ void updateHeadAngle(Vec2i dir) {
 // 菜单
 int menuIndex = 0;
 const int menuCount = 3;
-void processMenu(GLFWwindow* window) {
-    static bool menuPressed = false;
-    if (!menuPressed) {
-        //向上切换
-        if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-            menuIndex = (menuIndex - 1 + menuCount) % menuCount;
-            menuPressed = true;
+void processMenu(int key) {
+    //向上切换
+    if (key == GLFW_KEY_UP) menuIndex = (menuIndex - 1 + menuCount) % menuCount;
+    //向下切换
+    if (key == GLFW_KEY_DOWN) menuIndex = (menuIndex + 1) % menuCount;
+    //选择菜单项
+    if (key == GLFW_KEY_ENTER) {
+        if (menuIndex == 0) {
+            simThread.Start(seedSource.Next());
+            gameState = GAME;
+            effectTick = 0;
+            effectFood = { -1, -1 };
         }
-		//向下切换
-        if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-            menuIndex = (menuIndex + 1) % menuCount;
-            menuPressed = true;
-        }
-		//选择菜单项
-        if (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS) {
-            if (menuIndex == 0) { resetGame();gameState = GAME; lastLogicTime = glfwGetTime();}
-            else if (menuIndex == 1) gameState = SETTINGS;
-            else if (menuIndex == 2) gameState = EXIT;
-            menuPressed = true;
-        }
-    }
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_RELEASE &&
-        glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_RELEASE &&
-        glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_RELEASE) {
-        menuPressed = false;
+        else if (menuIndex == 1) gameState = SETTINGS;
+        else if (menuIndex == 2) gameState = EXIT;
     }
 }
 
-void resetGame() {
-    snake.clear();
-    snake.push_back({ gridWidth / 2, gridHeight / 2 });
-    food = { rand() % (gridWidth - 2) + 1, rand() % (gridHeight - 2) + 1 };
-    moveInterval = 0.1f;
-}
-
-
-GLuint LoadShader(const char* vertexPath, const char* fragmentPath)
-{
-    // 1. 读取文件内容
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-
-        vShaderFile.close();
-        fShaderFile.close();
-
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+// 输入处理：按键回调在 glfwPollEvents 中逐个触发，两帧之间的按下和松开都不会丢
+// 游戏中的按键带上时间戳交给逻辑线程，由它决定在哪个 tick 生效
+void keyCallback(GLFWwindow*, int key, int, int action, int) {
+    PROFILE_ZONE("Input");
+    if (action != GLFW_PRESS) return;
+#ifdef SNAKE_PROFILE
+    // F12：把目前为止的记录导出为 Chrome trace
+    if (key == GLFW_KEY_F12) {
+        if (Profiler::WriteChromeTrace("snake_trace.json")) std::cout << "已导出 snake_trace.json\n";
+        return;
     }
-    catch (std::ifstream::failure& e) {
-        std::cerr << "ERROR: Shader file not successfully read: "
-            << e.what() << std::endl;
-        return 0;
+#endif
+    if (gameState == MENU) {
+        processMenu(key);
     }
-
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    // 2. 编译着色器
-    GLuint vertex, fragment;
-    GLint success;
-    char infoLog[512];
-
-    // 顶点着色器
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 512, nullptr, infoLog);
-        std::cerr << "ERROR: Vertex shader compilation failed\n" << infoLog << std::endl;
+    else if (gameState == SETTINGS) {
+        if (key == GLFW_KEY_ESCAPE) gameState = MENU;
     }
-
-    // 片段着色器
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 512, nullptr, infoLog);
-        std::cerr << "ERROR: Fragment shader compilation failed\n" << infoLog << std::endl;
-    }
-
-    // 3. 链接着色器程序
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
-
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
+    else if (gameState == GAME) {
+        // 键盘与方向映射表
+        struct KeyDir { int key; Vec2i dir; };
+        static const KeyDir keys[4] = {
+            { GLFW_KEY_UP,    { 0,  1} },
+            { GLFW_KEY_DOWN,  { 0, -1} },
+            { GLFW_KEY_LEFT,  {-1,  0} },
+            { GLFW_KEY_RIGHT, { 1,  0} }
+        };
+        InputEvent e;
+        e.time = SimThread::Now();
+        for (const KeyDir& k : keys) {
+            if (key == k.key) {
+                e.dir = k.dir;
+                simThread.PushInput(e);
+            }
+        }
+        if (key == GLFW_KEY_A) {
+            e.type = InputEvent::TOGGLE_AUTOPILOT;
+            simThread.PushInput(e);
+        }
     }
+}
 
-    // 4. 删除中间着色器对象
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
 
-    return program;
+// 相机：棋盘放得下时固定在中心，否则跟随蛇头并停在墙边
+void updateCamera(double headX, double headY) {
+    cameraX = SimThread::CameraCenter(headX, gridWidth, viewCells);
+    cameraY = SimThread::CameraCenter(headY, gridHeight, viewCells);
 }
 
-
-int main() {
-    srand((unsigned)time(0));
+int main(int argc, char** argv) {
+    auto launchTime = std::chrono::steady_clock::now();
+    seedSource.Seed((uint64_t)time(0));
+    // --arena N：N x N 的大地图
+    // --startup-bench：画完第一帧就退出并打印启动耗时；--no-shader-cache：不读写着色器缓存，用于对比
+    // --assets FILE：资源包，默认是构建目录里的 assets.pak；--asset-dir DIR：开发用覆盖目录，里面的文件优先于资源包
+    // --capture FILE：录屏到 FILE.y4m 或 PNG 序列（如 frames/%05d.png）；--capture-fps N：写进 Y4M 的帧率
+    // --fps N：游戏中的帧率上限，0 为不限，默认取显示器刷新率；--busy-loop：旧的主循环，每轮都画、不等事件
+    // --idle-bench N：菜单里停 N 秒，再开一局自动驾驶跑 N 秒，分别报告进程的 CPU 占用
+    // --particles N：始终保持 N 个粒子，检查粒子更新和绘制能不能在帧预算内完成
+    bool startupBench = false, shaderCache = true, busyLoop = false;
+    double maxFps = -1.0, idleBench = 0.0;
+    size_t particleStress = 0;
+    const char* assetsPath = "assets.pak";
+    std::string assetDir, capturePath;
+    int captureFps = 60;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--arena") == 0 && i + 1 < argc) {
+            int n = std::atoi(argv[++i]);
+            if (n < 8) n = 8;
+            if (n > SnakeSim::kMaxArena) n = SnakeSim::kMaxArena;
+            gridWidth = gridHeight = n;
+        }
+        else if (std::strcmp(argv[i], "--startup-bench") == 0) startupBench = true;
+        else if (std::strcmp(argv[i], "--no-shader-cache") == 0) shaderCache = false;
+        else if (std::strcmp(argv[i], "--assets") == 0 && i + 1 < argc) assetsPath = argv[++i];
+        else if (std::strcmp(argv[i], "--asset-dir") == 0 && i + 1 < argc) assetDir = argv[++i];
+        else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) capturePath = argv[++i];
+        else if (std::strcmp(argv[i], "--capture-fps") == 0 && i + 1 < argc) captureFps = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) maxFps = std::max(std::atof(argv[++i]), 0.0);
+        else if (std::strcmp(argv[i], "--busy-loop") == 0) busyLoop = true;
+        else if (std::strcmp(argv[i], "--idle-bench") == 0 && i + 1 < argc) idleBench = std::max(std::atof(argv[++i]), 0.1);
+        else if (std::strcmp(argv[i], "--particles") == 0 && i + 1 < argc) particleStress = (size_t)std::max(std::atoll(argv[++i]), 0LL);
+    }
+    // 资源：一次 open + 一次 mmap，之后着色器和纹理都直接读映射内存
+    Vfs assets;
+    assets.SetOverlay(assetDir);
+    if (!assets.Mount(assetsPath) && !assets.HasOverlay()) {
+        std::cerr << "找不到资源包 " << assetsPath << "，请先构建 pack_assets 或用 --asset-dir 指定资源目录" << std::endl;
+        return -1;
+    }
+    largeArena = gridWidth > viewCells || gridHeight > viewCells;
+    if (particleStress > particles.Capacity()) particles = ParticleSystem(particleStress);
+    sim = SnakeSim(gridWidth, gridHeight, 1, largeArena);
+    if ((size_t)gridWidth * gridHeight <= SnakeSim::kMaxDenseCells) {
+        autopilot = Autopilot(gridWidth, gridHeight);
+        simThread.SetAutopilot(&autopilot);
+    }
+    updateCamera(0.0, 0.0);
     if (!glfwInit()) return -1;
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // 录屏时帧大小固定
+    if (!capturePath.empty()) glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
 
 
     GLFWwindow* window = glfwCreateWindow(800, 800, "Snake with Menu", nullptr, nullptr);
     if (!window) return -1;
     glfwMakeContextCurrent(window);
+    glfwSetKeyCallback(window, keyCallback);
+    // 窗口被遮挡后露出、改变大小时系统要求重画
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow*) { frameScheduler.MarkDirty(); });
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+    LoadGlExtensions((GLADloadproc)glfwGetProcAddress);
+    LoadGlApi();
 
     std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
     std::cout << "GLSL version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
@@ -295,141 +284,273 @@ int main() {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    GLuint borderShader = LoadShader("C:/dev/snake/CMake贪吃蛇/shaders/border.vert", "C:/dev/snake/CMake贪吃蛇/shaders/border.frag");
-    MapBorder border(-0.9f, 0.9f, 0.9f, -0.9f);
+    // 着色器：先提交编译（或从缓存读二进制），加载纹理的同时驱动在后台编译
+    ShaderManager shaders(shaderCache ? "shader_cache" : "");
+    ShaderManager::Handle spriteShader = shaders.AddSource("sprite", vertexShaderSource, fragmentShaderSource);
+    // 覆盖目录里有着色器文件时从文件加载，可以热重载；否则用资源包里的源码
+    ShaderManager::Handle borderShader;
+    std::string borderVert = assets.OverlayPath("shaders/border.vert"), borderFrag = assets.OverlayPath("shaders/border.frag");
+    if (!borderVert.empty() && !borderFrag.empty())
+        borderShader = shaders.AddFiles("border", borderVert, borderFrag);
+    else
+        borderShader = shaders.AddSource("border", assets.Read("shaders/border.vert").Str(), assets.Read("shaders/border.frag").Str());
 
-    GLuint VBO, VAO;
-    glGenVertexArrays(1, &VAO);
+    GLuint VBO;
     glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // 大地图的墙：分块瓦片，进入视野时上传一次；着色器跟上面的一起提交
+    TileLayer walls(VBO, shaders);
+    if (largeArena) walls.AddBorder(gridWidth, gridHeight);
+    ParticleLayer particleLayer(VBO, particles.Capacity(), shaders);
+    shaders.Submit();
 
-    GLuint texHead = loadTexture("C:/dev/snake/CMake贪吃蛇/textures/snake_head.png");
-    GLuint texBody = loadTexture("C:/dev/snake/CMake贪吃蛇/textures/snake_body1.png");
-    GLuint texFood = loadTexture("C:/dev/snake/CMake贪吃蛇/textures/food.png");
-
-    int offsetLoc = glGetUniformLocation(shaderProgram, "offset");
-    int angleLoc = glGetUniformLocation(shaderProgram, "angle");
-    int colorLoc = glGetUniformLocation(shaderProgram, "color");
-    int useTexLoc = glGetUniformLocation(shaderProgram, "useTexture");
+    MapBorder border(-0.9f, 0.9f, 0.9f, -0.9f);
 
+    // 精灵纹理：优先用资源包里 atlas_baker 烘焙好的图集；没有图集或者在用覆盖目录时，在线程池上解码 PNG
+    TextureAtlas atlas;
+    Span bakedFile = assets.HasOverlay() ? Span() : assets.Read("textures.atlas");
+    bool bakedAtlas = bakedFile && atlas.LoadBaked(bakedFile.data, bakedFile.size);
+    if (!bakedAtlas) {
+        ThreadPool loader;
+        atlas.LoadImages(assets, { "textures/snake_head.png", "textures/snake_body1.png", "textures/food.png" }, 32, loader);
+    }
+    GLuint texAtlas = atlas.Texture();
+    float layerHead = (float)std::max(atlas.Layer("snake_head.png"), 0);
+    float layerBody = (float)std::max(atlas.Layer("snake_body1.png"), 0);
+    float layerFood = (float)std::max(atlas.Layer("food.png"), 0);
+
+    shaders.Finish();
+    if (!shaders.Program(spriteShader)) return -1;
+    // 每层的 UV 范围只在启动时上传一次
+    std::vector<float> layerRects;
+    for (int i = 0; i < atlas.LayerCount(); ++i) {
+        const AtlasEntry& e = atlas.Entry(i);
+        layerRects.insert(layerRects.end(), { e.u0, e.v0, e.u1, e.v1 });
+    }
+    glUseProgram(shaders.Program(spriteShader));
+    glUniform4fv(shaders.Uniform(spriteShader, "layerRect"), atlas.LayerCount(), layerRects.data());
+    SpriteBatch sprites(shaders.Program(spriteShader), VBO, 1024, GL_TEXTURE_2D_ARRAY);
+    GlRenderer renderer(sprites, texAtlas, border, shaders, borderShader);
+    Rng stressRng(seedSource.Next());
+    double lastParticleUpdate = SimThread::Now();
+    double nextReloadCheck = 0.0;
+
+
+    // 录屏：PBO 环异步读回，写盘在 FrameWriter 的线程上，跟不上时丢帧而不卡住渲染
+    FrameWriter captureWriter;
+    std::unique_ptr<FrameCapture> capture;
+    if (!capturePath.empty()) {
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        if (!captureWriter.Open(capturePath, fbWidth, fbHeight, captureFps, true)) {
+            std::cerr << "无法录屏到 " << capturePath << "（需要 .y4m 文件名或带 %d 的 PNG 文件名）" << std::endl;
+            return -1;
+        }
+        capture.reset(new FrameCapture(captureWriter));
+    }
+    // 帧率上限：录屏时与写进文件的帧率一致，否则默认跟显示器刷新率
+    if (maxFps < 0.0) {
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        maxFps = capture ? captureFps : mode && mode->refreshRate > 0 ? mode->refreshRate : 60;
+    }
+    frameScheduler.SetMaxFps(maxFps);
+    frameScheduler.SetBusyLoop(busyLoop);
+
+    PROFILE_THREAD("main");
+    GpuProfiler gpuProfiler;
+    renderer.SetGpuProfiler(&gpuProfiler);
+    int benchPhase = 0;
+    double phaseStart = SimThread::Now(), phaseCpu = FrameScheduler::ProcessCpuSeconds();
+    unsigned phaseFrames = 0, phaseWakeups = 0;
     while (!glfwWindowShouldClose(window)) {
-
-        if (snake.size() % 4==0) {
-			moveInterval = 0.1f-(snake.size()/4)*0.01; // 加快速度
+        {
+            PROFILE_ZONE("Events");
+            // 离下一帧还早就睡在窗口事件上，按键和重绘请求随时能叫醒；
+            // 醒来的时刻提前一个自旋窗口，剩下的一小段精确地等
+            double now = SimThread::Now();
+            double wait = std::min(frameScheduler.TimeUntilFrame(now), nextReloadCheck - now);
+            if (idleBench > 0.0) wait = std::min(wait, phaseStart + idleBench - now);
+            if (wait > frameScheduler.SpinWindow()) {
+                glfwWaitEventsTimeout(wait - frameScheduler.SpinWindow());
+            }
+            else {
+                if (wait > 0.0) frameScheduler.SleepUntil(now + wait);
+                glfwPollEvents();
+            }
+            phaseWakeups++;
+        }
+        // 开发时改了着色器文件不用重启，每半秒检查一次修改时间
+        if (SimThread::Now() >= nextReloadCheck) {
+            // 换了程序，缓存的程序和 uniform 都作废
+            if (shaders.PollReload() > 0) {
+                renderer.InvalidateState();
+                frameScheduler.MarkDirty();
+            }
+            nextReloadCheck = SimThread::Now() + 0.5;
+        }
+        if (idleBench > 0.0 && SimThread::Now() >= phaseStart + idleBench) {
+            double wall = SimThread::Now() - phaseStart, cpu = FrameScheduler::ProcessCpuSeconds() - phaseCpu;
+            std::printf("idle bench %s (%s): %.1f s, %u frames (%.1f fps), %u wakeups, CPU %.2f s (%.1f%%)\n",
+                benchPhase == 0 ? "menu" : "game", busyLoop ? "busy loop" : "scheduled",
+                wall, phaseFrames, phaseFrames / wall, phaseWakeups, cpu, cpu / wall * 100.0);
+            if (benchPhase == 0) {
+                // 和在菜单里按回车开始、再按 A 打开自动驾驶一样
+                menuIndex = 0;
+                processMenu(GLFW_KEY_ENTER);
+                keyCallback(window, GLFW_KEY_A, 0, GLFW_PRESS, 0);
+                benchPhase = 1;
+            }
+            else {
+                glfwSetWindowShouldClose(window, true);
+            }
+            phaseStart = SimThread::Now();
+            phaseCpu = FrameScheduler::ProcessCpuSeconds();
+            phaseFrames = phaseWakeups = 0;
         }
-        float currentTime = glfwGetTime();
-        glClearColor(0.2f, 0.3f, 0.25f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(shaderProgram);
-        glBindVertexArray(VAO);
+        // 菜单和设置页只在状态或选中项变了时重画；游戏中蛇在插值移动，录屏要连续的帧
+        // 还有粒子在飞时也要连续出帧，死亡的爆炸会延续到回到菜单之后
+        frameScheduler.SetScene(((uint64_t)gameState << 32) | (uint32_t)menuIndex, gameState == GAME || capture || particles.Size() > 0 || particleStress > 0);
+        double frameStart = SimThread::Now();
+        if (frameScheduler.TimeUntilFrame(frameStart) > 0.0) continue;
+
+        PROFILE_ZONE("Frame");
+        renderer.BeginFrame(0.2f, 0.3f, 0.25f);
 
         if (gameState == MENU) {
-            processMenu(window);
             for (int i = 0; i < menuCount; ++i) {
                 float y = 0.4f - i * 0.3f;
-                glUniform2f(offsetLoc, 0.0f, y);
-                glUniform1f(angleLoc, 0.0f);
                 if (i == menuIndex)
-                    glUniform3f(colorLoc, 1.0f, 1.0f, 0.0f);
+                    renderer.AddSprite(false, { 0.0f, y, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f });
                 else
-                    glUniform3f(colorLoc, 0.6f, 0.6f, 0.6f);
-                glUniform1i(useTexLoc, 0);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
+                    renderer.AddSprite(false, { 0.0f, y, 0.0f, 0.0f, 0.6f, 0.6f, 0.6f, 1.0f });
             }
+            renderer.Flush();
         }
         else if (gameState == GAME) {
-
-            processInput(window, direction);
-            if (currentTime - lastLogicTime >= moveInterval) {
-                lastLogicTime = currentTime;
-                oldSnake = snake;
-                if (!dirQueue.empty()) {
-                    Vec2i nextDir = dirQueue.front(); dirQueue.pop_front();
-                    if (!(direction.x == -nextDir.x && direction.y == -nextDir.y))
-                        direction = nextDir;
-                }
-                updateHeadAngle(direction);
-                Vec2i newHead = { snake.front().x + direction.x, snake.front().y + direction.y };
-                if (newHead.x < 1 || newHead.x >= gridWidth-1 || newHead.y < 1 || newHead.y >= gridHeight-1) {
-                    std::cout << "撞墙，游戏结束！\n";
-                    gameState = MENU; // 返回菜单
-                }
-                if (newHead == food) {
-                    snake.push_front(newHead);
-                    food = { rand() % (gridWidth - 2) + 1, rand() % (gridHeight-2) + 1 };
-                }
-                else {
-                    snake.push_front(newHead);
-                    snake.pop_back();
-                }
+            PROFILE_ZONE("Render");
+            const SimSnapshot& snap = simThread.Latest();
+            if (!snap.alive) {
+                // 逻辑线程已经写好录像并退出
+                simThread.Stop();
+                const LatencyHistogram& lat = simThread.Latency();
+                if (lat.Count() > 0)
+                    std::printf("输入延迟: %llu 次, 平均 %.2f ms, p50 %.1f ms, p99 %.1f ms, 最大 %.2f ms\n",
+                        lat.Count(), lat.MeanMs(), lat.PercentileMs(0.5), lat.PercentileMs(0.99), lat.MaxMs());
+                gameState = MENU; // 返回菜单
+                particles.Emit({ snap.head.x + 0.5f, snap.head.y + 0.5f, 160, 9.0f, 1.2f, 0xFF3040F0u });
             }
-            float t = (currentTime - lastLogicTime) / moveInterval;
+            // 插值系数取自快照发布的 tick 时刻，与渲染帧率无关
+            float t = (float)((SimThread::Now() - snap.tickTime) / snap.interval);
+            // 下一个 tick 发布后马上画，不等帧槽；留 0.5 ms 给逻辑线程走完这一步
+            if (snap.alive) frameScheduler.WakeAt(snap.tickTime + snap.interval + 0.0005);
+            if (t < 0.0f) t = 0.0f;
             if (t > 1.0f) t = 1.0f;
+            updateHeadAngle(snap.direction);
+            Vec2i food = snap.food;
+            if (snap.tick != effectTick) {
+                if (snap.tick > effectTick && effectFood.x >= 0 && !(food == effectFood))
+                    particles.Emit({ effectFood.x + 0.5f, effectFood.y + 0.5f, 48, 6.0f, 0.6f, 0xFF40D0FFu });
+                effectTick = snap.tick;
+                effectFood = food;
+            }
 
-            for (size_t i = 0; i < snake.size(); ++i) {
-                Vec2i oldPos = (i < oldSnake.size()) ? oldSnake[i] : snake[i];
-                Vec2i newPos = snake[i];
-                float x = -1.0f + (oldPos.x + (newPos.x - oldPos.x) * t) * cellSize + cellSize / 2.0f;
-                float y = -1.0f + (oldPos.y + (newPos.y - oldPos.y) * t) * cellSize + cellSize / 2.0f;
-                glUniform2f(offsetLoc, x, y);
-                if (i == 0) {
-                    glBindTexture(GL_TEXTURE_2D, texHead);
-                    glUniform1i(useTexLoc, 1);
-                    glUniform1f(angleLoc, toRadians(headAngle));
-                }
-                else {
-                    glBindTexture(GL_TEXTURE_2D, texBody);
-                    glUniform1i(useTexLoc, 1);
-                    glUniform1f(angleLoc, 0.0f);
-                }
-                glDrawArrays(GL_TRIANGLES, 0, 6);
+            Vec2i headOld = snap.headPrevious, headNew = snap.head;
+            updateCamera(headOld.x + (headNew.x - headOld.x) * (double)t, headOld.y + (headNew.y - headOld.y) * (double)t);
+            // 视野范围多留一格：插值中的一节可能刚从视野外移进来
+            int minX = (int)std::floor(cameraX - viewCells / 2.0) - 1;
+            int minY = (int)std::floor(cameraY - viewCells / 2.0) - 1;
+            int maxX = (int)std::ceil(cameraX + viewCells / 2.0) + 1;
+            int maxY = (int)std::ceil(cameraY + viewCells / 2.0) + 1;
+
+            // 快照里只有视野附近的节，逻辑线程已按分块索引裁剪过
+            for (const SnapshotSegment& seg : snap.segments) {
+                Vec2i oldPos = seg.previous;
+                Vec2i newPos = seg.current;
+                float x = (float)((oldPos.x + (newPos.x - oldPos.x) * (double)t + 0.5 - cameraX) * cellSize);
+                float y = (float)((oldPos.y + (newPos.y - oldPos.y) * (double)t + 0.5 - cameraY) * cellSize);
+                if (seg.head)
+                    renderer.AddSprite(true, { x, y, toRadians(headAngle), layerHead, 1.0f, 1.0f, 1.0f, 1.0f });
+                else
+                    renderer.AddSprite(true, { x, y, 0.0f, layerBody, 1.0f, 1.0f, 1.0f, 1.0f });
+            }
+            if (food.x >= minX && food.x <= maxX && food.y >= minY && food.y <= maxY) {
+                float fx = (float)((food.x + 0.5 - cameraX) * cellSize);
+                float fy = (float)((food.y + 0.5 - cameraY) * cellSize);
+                renderer.AddSprite(true, { fx, fy, 0.0f, layerFood, 1.0f, 1.0f, 1.0f, 1.0f });
             }
-            float fx = -1.0f + food.x * cellSize + cellSize / 2.0f;
-            float fy = -1.0f + food.y * cellSize + cellSize / 2.0f;
-            glUniform2f(offsetLoc, fx, fy);
-            glBindTexture(GL_TEXTURE_2D, texFood);
-            glUniform1i(useTexLoc, 1);
-            glUniform1f(angleLoc, 0.0f);
-            glUseProgram(shaderProgram);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            glUseProgram(borderShader);
-            border.Draw(borderShader);
+            renderer.Flush();
+            if (largeArena) walls.Draw(renderer.Queue(), cameraX, cameraY, cellSize, minX, minY, maxX, maxY);
+            else renderer.DrawBorder();
         }
         else if (gameState == SETTINGS) {
-            glUniform2f(offsetLoc, 0.0f, 0.0f);
-            glUniform1f(angleLoc, 0.0f);
-            glUniform3f(colorLoc, 0.2f, 0.7f, 1.0f);
-            glUniform1i(useTexLoc, 0);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-            if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) gameState = MENU;
+            renderer.AddSprite(false, { 0.0f, 0.0f, 0.0f, 0.0f, 0.2f, 0.7f, 1.0f, 1.0f });
+            renderer.Flush();
         }
         else if (gameState == EXIT) {
             glfwSetWindowShouldClose(window, true);
         }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        {
+            // 粒子按真实经过的时间推进，一次画完；卡顿时最多补 0.1 秒
+            PROFILE_ZONE("Particles");
+            float dt = (float)std::min(frameStart - lastParticleUpdate, 0.1);
+            lastParticleUpdate = frameStart;
+            while (particles.Size() < particleStress) {
+                int burst = (int)std::min<size_t>(particleStress - particles.Size(), 4096);
+                float bx = (float)(cameraX - viewCells / 2.0 + stressRng.Below(viewCells * 100) * 0.01);
+                float by = (float)(cameraY - viewCells / 2.0 + stressRng.Below(viewCells * 100) * 0.01);
+                particles.Emit({ bx, by, burst, 4.0f, 2.0f, 0xC0FFC060u });
+            }
+            particles.Update(dt);
+            particleLayer.Draw(renderer.Queue(), particles, cameraX, cameraY, cellSize);
+            PROFILE_COUNTER("particles", particles.Size());
+        }
+
+        // 本帧的命令在这里排序并一次提交，每一遍各有一个 GPU 区间
+        renderer.EndFrame();
+#ifdef SNAKE_PROFILE
+        const RenderStats& renderStats = renderer.Stats();
+        PROFILE_COUNTER("drawCalls", renderStats.drawCalls);
+        PROFILE_COUNTER("stateChanges", renderStats.StateChanges());
+        PROFILE_COUNTER("uniformUploads", renderStats.uniformUploads);
+        PROFILE_COUNTER("textureBinds", renderStats.textureBinds);
+        PROFILE_COUNTER("redundantSkipped", renderStats.skipped);
+#endif
+        PROFILE_GPU_FRAME(gpuProfiler);
+        if (capture) {
+            PROFILE_ZONE("Capture");
+            capture->Capture();
+        }
+        {
+            PROFILE_ZONE("Swap");
+            glfwSwapBuffers(window);
+        }
+        if (startupBench) {
+            // 第一帧交换完成即为可见的第一帧
+            glFinish();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - launchTime).count();
+            const ShaderManager::Stats& st = shaders.GetStats();
+            const Vfs::Stats& io = assets.GetStats();
+            std::printf("time to first frame: %.1f ms (shader build %.1f ms, cache hits %u, misses %u, parallel compile %s; textures %.1f ms, %s)\n",
+                ms, st.buildMs, st.cacheHits, st.cacheMisses, glExt.parallelShaderCompile ? "on" : "off",
+                atlas.LoadMs(), bakedAtlas ? "baked atlas" : "decoded");
+            std::printf("asset I/O: %u file opens, %u archive reads, %u overlay reads, %u checksum failures\n",
+                io.fileOpens, io.archiveReads, io.overlayReads, io.checksumFailures);
+            break;
+        }
+        frameScheduler.FrameDrawn(frameStart);
+        phaseFrames++;
+    }
+    simThread.Stop();
+    if (capture) {
+        capture->Finish();
+        captureWriter.Close();
+        const FrameCapture::Stats& cs = capture->GetStats();
+        FrameWriter::Stats ws = captureWriter.GetStats();
+        std::printf("录屏: %u 帧, 写出 %u 帧 (%.1f MB), 丢帧 %u (GPU 未完成 %u, 写盘跟不上 %u), 读回最多延后 %u 帧\n",
+            cs.frames, ws.written, ws.bytes / 1048576.0, cs.gpuBusy + cs.writerBusy, cs.gpuBusy, cs.writerBusy, cs.maxLatency);
+        capture.reset();
     }
     glfwTerminate();
     return 0;
@@ -0,0 +1,73 @@
+#include "FrameCapture.h"
+#include <algorithm>
+#include <cstring>
+
+FrameCapture::FrameCapture(FrameWriter& w, int ring)
+    : writer(w), ringSize(std::min(std::max(ring, 1), kMaxRing)) {
+    GLsizeiptr size = (GLsizeiptr)writer.Width() * writer.Height() * 4;
+    for (int i = 0; i < ringSize; ++i) {
+        glGenBuffers(1, &slots[i].pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+FrameCapture::~FrameCapture() {
+    for (int i = 0; i < ringSize; ++i) {
+        if (slots[i].fence) glDeleteSync(slots[i].fence);
+        glDeleteBuffers(1, &slots[i].pbo);
+    }
+}
+
+void FrameCapture::Capture() {
+    stats.frames++;
+    Collect(false);
+    if (pending == ringSize) {
+        // 最旧的一帧 GPU 还没做完，再读就得等，这一帧不录
+        stats.gpuBusy++;
+        return;
+    }
+    Slot& slot = slots[(oldest + pending) % ringSize];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    // 读的是默认的 GL_BACK；目标是 PBO，最后一个参数是偏移，调用只是把拷贝排进命令流
+    glReadPixels(0, 0, writer.Width(), writer.Height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = stats.frames;
+    pending++;
+}
+
+void FrameCapture::Finish() {
+    Collect(true);
+}
+
+void FrameCapture::Collect(bool wait) {
+    while (pending > 0) {
+        Slot& slot = slots[oldest];
+        // 不等待时只查询状态；第一次查询要 flush，否则 fence 可能永远不会被提交
+        GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000ull : 0);
+        if (status == GL_TIMEOUT_EXPIRED) return;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        oldest = (oldest + 1) % ringSize;
+        pending--;
+        if (status == GL_WAIT_FAILED) continue;
+
+        size_t size = (size_t)writer.Width() * writer.Height() * 4;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_READ_BIT);
+        uint8_t* frame = mapped ? writer.Acquire() : nullptr;
+        if (frame) std::memcpy(frame, mapped, size);
+        if (mapped) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!frame) {
+            stats.writerBusy++;
+            continue;
+        }
+        writer.Submit(frame);
+        stats.delivered++;
+        stats.maxLatency = std::max(stats.maxLatency, stats.frames - slot.frame);
+    }
+}
@@ -0,0 +1,48 @@
+// FrameCapture.h
+#pragma once
+#include <glad/glad.h>
+#include "FrameWriter.h"
+
+// 录屏的 GL 一侧：每帧把后缓冲 glReadPixels 进一个 PBO 并插一个 fence，立即返回
+// PBO 排成一圈，几帧之后 fence 已经完成时再映射、拷进 FrameWriter 的缓冲交给工作线程
+// 整个过程不等 GPU 也不等磁盘：环里最旧的一帧 GPU 还没做完，或者 FrameWriter 没有空闲缓冲，都是丢掉一帧
+class FrameCapture {
+public:
+    // 帧的宽高取自 writer，须与帧缓冲一致；ring 为 PBO 个数，即读回最多落后的帧数
+    FrameCapture(FrameWriter& writer, int ring = 3);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // 画完一帧、SwapBuffers 之前调用
+    void Capture();
+    // 退出前调用：等环里剩下的帧读回并交给 writer
+    void Finish();
+
+    struct Stats {
+        unsigned frames = 0;        // Capture 的调用次数
+        unsigned delivered = 0;     // 交给 writer 的帧
+        unsigned gpuBusy = 0;       // PBO 还在等 GPU 而丢掉的帧
+        unsigned writerBusy = 0;    // writer 没有空闲缓冲而丢掉的帧
+        unsigned maxLatency = 0;    // 从读回到交出最多隔了几帧
+    };
+    const Stats& GetStats() const { return stats; }
+
+    static constexpr int kMaxRing = 8;
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        unsigned frame = 0;
+    };
+
+    // 按顺序收取已经完成的槽；wait 为真时等 GPU
+    void Collect(bool wait);
+
+    FrameWriter& writer;
+    Slot slots[kMaxRing];
+    int ringSize;
+    int oldest = 0, pending = 0;    // 待收取的槽从 oldest 开始连续 pending 个
+    Stats stats;
+};
@@ -0,0 +1,80 @@
+#include "FrameScheduler.h"
+#include "SimThread.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+static const double kNever = 1e300;
+
+void FrameScheduler::SetScene(uint64_t key, bool anim) {
+    sceneKey = key;
+    animating = anim;
+}
+
+void FrameScheduler::WakeAt(double time) {
+    wakeTime = std::min(wakeTime, time);
+}
+
+double FrameScheduler::TimeUntilFrame(double now) const {
+    if (busyLoop) return 0.0;
+    double next = kNever;
+    // 帧率上限只约束有动画的画面；静止画面变了马上画，输入不会被拖慢
+    if (dirty || sceneKey != drawnKey) next = now;
+    else if (animating) next = lastFrame + frameInterval;
+    // tick 的时刻不受帧率上限约束，新的一步不用等到下一个帧槽
+    next = std::min(next, wakeTime);
+    return next - now;
+}
+
+void FrameScheduler::FrameDrawn(double now) {
+    dirty = false;
+    drawnKey = sceneKey;
+    lastFrame = now;
+    // 本帧内登记的下一个 tick 还没到，留着
+    if (wakeTime <= now) wakeTime = kNever;
+    stats.frames++;
+}
+
+// 和 SimThread::WaitUntil 一样先睡后转，自旋窗口跟着实测的多睡时间走：
+// Windows 默认计时器精度约 15.6 ms，Linux 通常不到 0.1 ms
+void FrameScheduler::SleepUntil(double deadline) {
+    stats.sleeps++;
+    for (;;) {
+        double now = SimThread::Now();
+        double remaining = deadline - now;
+        if (remaining <= 0.0) return;
+        if (remaining > spinWindow) {
+            double request = remaining - spinWindow;
+            std::this_thread::sleep_for(std::chrono::duration<double>(request));
+            double over = SimThread::Now() - now - request;
+            stats.maxOversleep = std::max(stats.maxOversleep, over);
+            // 多睡了就立刻放宽窗口，否则慢慢收回，窗口在 0.5 ms 到 20 ms 之间
+            spinWindow = std::min(std::max(std::max(over * 1.25, spinWindow * 0.98), 0.0005), 0.02);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+double FrameScheduler::ProcessCpuSeconds() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+    auto seconds = [](const FILETIME& t) {
+        return (((uint64_t)t.dwHighDateTime << 32) | t.dwLowDateTime) * 1e-7;
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#endif
+}
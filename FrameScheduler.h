@@ -0,0 +1,54 @@
+// FrameScheduler.h
+#pragma once
+#include <cstdint>
+
+// 帧调度：决定主循环什么时候画下一帧、两帧之间能睡多久
+// 静止的画面（菜单、设置）只在内容变了时重画，其余时间睡在窗口事件上；
+// 有动画时按帧率上限出帧，并在逻辑 tick 的时刻准时醒来，新的一步马上画出来
+// 时间都用 SimThread::Now()，单位秒
+class FrameScheduler {
+public:
+    struct Stats {
+        unsigned frames = 0;
+        unsigned sleeps = 0;        // SleepUntil 的次数
+        double maxOversleep = 0.0;  // 系统睡眠比要求多睡的最长时间
+    };
+
+    // 0 表示不限
+    void SetMaxFps(double fps) { frameInterval = fps > 0.0 ? 1.0 / fps : 0.0; }
+    // 旧的主循环：每一轮都画，不等事件，用来对比
+    void SetBusyLoop(bool on) { busyLoop = on; }
+
+    // 画面内容的摘要（游戏状态、菜单选中项等），与上次画的不同就要重画
+    // animating 为真时画面每帧都在变，按帧率上限连续出帧
+    void SetScene(uint64_t key, bool animating);
+    // 摘要之外的原因需要重画：窗口重绘、着色器重载
+    void MarkDirty() { dirty = true; }
+    // 到这个时刻必须画一帧（下一个逻辑 tick），多次调用取最早的
+    void WakeAt(double time);
+
+    // 离下一帧还有多久；<= 0 表示现在就画，没有要画的返回一个很大的数
+    double TimeUntilFrame(double now) const;
+    void FrameDrawn(double now);
+
+    // 睡到 deadline：先用系统睡眠，最后 SpinWindow() 内让出时间片自旋
+    void SleepUntil(double deadline);
+    // 系统睡眠可能多睡的时间，按实测的超时自动调整；等事件时要提前这么久醒来
+    double SpinWindow() const { return spinWindow; }
+
+    const Stats& GetStats() const { return stats; }
+
+    // 本进程用掉的 CPU 时间（所有线程的用户态加内核态），秒
+    static double ProcessCpuSeconds();
+
+private:
+    double frameInterval = 0.0;
+    bool busyLoop = false;
+    bool dirty = true;
+    bool animating = false;
+    uint64_t sceneKey = 0, drawnKey = ~0ull;
+    double lastFrame = -1e9;
+    double wakeTime = 1e300;
+    double spinWindow = 0.001;
+    Stats stats;
+};
@@ -0,0 +1,316 @@
+#include "FrameWriter.h"
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+
+bool FrameWriter::Open(const std::string& outPath, int w, int h, int framesPerSecond, bool rowsBottomUp, int slotCount) {
+    Close();
+    if (w <= 0 || h <= 0 || framesPerSecond <= 0) return false;
+    path = outPath;
+    width = w;
+    height = h;
+    fps = framesPerSecond;
+    bottomUp = rowsBottomUp;
+    frameIndex = 0;
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0) format = Y4M;
+    else if (path.find('%') != std::string::npos) format = PNG;
+    else return false;
+
+    if (format == Y4M) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        // C420jpeg：色度取 2x2 块中心，YUV 为全范围
+        std::fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    }
+
+    slotCount = std::min(std::max(slotCount, 1), kMaxSlots);
+    slots.assign(slotCount, std::vector<uint8_t>((size_t)width * height * 4));
+    int index;
+    while (freeSlots.Pop(index)) {}
+    while (readySlots.Pop(index)) {}
+    for (int i = 0; i < slotCount; ++i) freeSlots.Push(i);
+    submitted = written = dropped = 0;
+    bytes = 0;
+    stopping = false;
+    worker = std::thread(&FrameWriter::Run, this);
+    return true;
+}
+
+void FrameWriter::Close() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+uint8_t* FrameWriter::Acquire(bool wait) {
+    int index;
+    if (freeSlots.Pop(index)) return slots[index].data();
+    if (!wait) {
+        dropped++;
+        return nullptr;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    released.wait(lock, [&] { return freeSlots.Pop(index); });
+    return slots[index].data();
+}
+
+void FrameWriter::Submit(uint8_t* frame) {
+    for (int i = 0; i < (int)slots.size(); ++i) {
+        if (slots[i].data() != frame) continue;
+        readySlots.Push(i);
+        submitted++;
+        // 先拿一下锁，工作线程检查完队列、还没开始等的时候不会漏掉这次通知
+        { std::lock_guard<std::mutex> lock(mutex); }
+        wake.notify_one();
+        return;
+    }
+}
+
+FrameWriter::Stats FrameWriter::GetStats() const {
+    Stats s;
+    s.submitted = submitted;
+    s.written = written;
+    s.dropped = dropped;
+    s.bytes = bytes;
+    return s;
+}
+
+const uint8_t* FrameWriter::Row(const uint8_t* rgba, int row) const {
+    return rgba + (size_t)(bottomUp ? height - 1 - row : row) * width * 4;
+}
+
+void FrameWriter::Run() {
+    for (;;) {
+        int index;
+        if (!readySlots.Pop(index)) {
+            // 停止时先把已经提交的帧写完
+            std::unique_lock<std::mutex> lock(mutex);
+            bool ready = false;
+            wake.wait(lock, [&] { return (ready = readySlots.Pop(index)) || stopping; });
+            if (!ready) return;
+        }
+        if (format == Y4M ? WriteY4m(slots[index].data()) : WritePng(slots[index].data())) written++;
+        frameIndex++;
+        freeSlots.Push(index);
+        { std::lock_guard<std::mutex> lock(mutex); }
+        released.notify_one();
+    }
+}
+
+// RGB 转全范围 BT.601 YUV，系数乘 256 取整；加上偏移后右移，避免负数移位
+static inline uint8_t LumaOf(int r, int g, int b) {
+    return (uint8_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+static inline uint8_t ChromaOf(int a, int b, int c) {
+    return (uint8_t)std::min((a + b + c + 32896) >> 8, 255);
+}
+
+bool FrameWriter::WriteY4m(const uint8_t* rgba) {
+    int cw = (width + 1) / 2, ch = (height + 1) / 2;
+    size_t lumaSize = (size_t)width * height, chromaSize = (size_t)cw * ch;
+    planes.resize(lumaSize + chromaSize * 2);
+    uint8_t* yPlane = planes.data();
+    uint8_t* uPlane = yPlane + lumaSize;
+    uint8_t* vPlane = uPlane + chromaSize;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* src = Row(rgba, y);
+        uint8_t* dst = yPlane + (size_t)y * width;
+        for (int x = 0; x < width; ++x) dst[x] = LumaOf(src[x * 4], src[x * 4 + 1], src[x * 4 + 2]);
+    }
+    // 色度：2x2 块的 RGB 平均值，奇数边长时最后一列/行只有一半
+    for (int cy = 0; cy < ch; ++cy) {
+        const uint8_t* row0 = Row(rgba, cy * 2);
+        const uint8_t* row1 = Row(rgba, std::min(cy * 2 + 1, height - 1));
+        for (int cx = 0; cx < cw; ++cx) {
+            int x0 = cx * 2, x1 = std::min(cx * 2 + 1, width - 1);
+            int r = row0[x0 * 4] + row0[x1 * 4] + row1[x0 * 4] + row1[x1 * 4];
+            int g = row0[x0 * 4 + 1] + row0[x1 * 4 + 1] + row1[x0 * 4 + 1] + row1[x1 * 4 + 1];
+            int b = row0[x0 * 4 + 2] + row0[x1 * 4 + 2] + row1[x0 * 4 + 2] + row1[x1 * 4 + 2];
+            r = (r + 2) >> 2;
+            g = (g + 2) >> 2;
+            b = (b + 2) >> 2;
+            uPlane[(size_t)cy * cw + cx] = ChromaOf(-43 * r, -85 * g, 128 * b);
+            vPlane[(size_t)cy * cw + cx] = ChromaOf(128 * r, -107 * g, -21 * b);
+        }
+    }
+    bool ok = std::fwrite("FRAME\n", 1, 6, file) == 6 &&
+        std::fwrite(planes.data(), 1, planes.size(), file) == planes.size();
+    bytes += planes.size() + 6;
+    return ok;
+}
+
+// ---------- PNG ----------
+// 只有一个固定 Huffman 的 deflate 块，匹配只找左边一个像素和上一行同位置两种距离：
+// 游戏画面大片纯色，这两种重复就占了绝大部分，压缩比接近 zlib 而且快得多
+
+namespace {
+
+struct BitWriter {
+    std::vector<uint8_t>& out;
+    uint64_t buffer = 0;
+    int count = 0;
+
+    explicit BitWriter(std::vector<uint8_t>& o) : out(o) {}
+
+    void Put(uint32_t bits, int n) {
+        buffer |= (uint64_t)bits << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back((uint8_t)buffer);
+            buffer >>= 8;
+            count -= 8;
+        }
+    }
+    // Huffman 码按高位在前写出
+    void PutCode(uint32_t code, int n) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < n; ++i) reversed |= ((code >> i) & 1) << (n - 1 - i);
+        Put(reversed, n);
+    }
+    void Flush() {
+        if (count > 0) out.push_back((uint8_t)buffer);
+        buffer = 0;
+        count = 0;
+    }
+};
+
+const uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const uint8_t kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+void PutLiteral(BitWriter& bits, int v) {
+    if (v < 144) bits.PutCode(0x30 + v, 8);
+    else if (v < 256) bits.PutCode(0x190 + v - 144, 9);
+    else if (v < 280) bits.PutCode(v - 256, 7);
+    else bits.PutCode(0xC0 + v - 280, 8);
+}
+
+void PutMatch(BitWriter& bits, int length, int distance) {
+    int l = 28;
+    while (kLengthBase[l] > length) --l;
+    PutLiteral(bits, 257 + l);
+    if (kLengthExtra[l]) bits.Put(length - kLengthBase[l], kLengthExtra[l]);
+    int d = 29;
+    while (kDistBase[d] > distance) --d;
+    bits.PutCode(d, 5);
+    if (kDistExtra[d]) bits.Put(distance - kDistBase[d], kDistExtra[d]);
+}
+
+// zlib 流：数据 + 固定 Huffman 块 + Adler-32
+void Deflate(const uint8_t* data, size_t size, size_t stride, std::vector<uint8_t>& out) {
+    out.push_back(0x78);
+    out.push_back(0x01);
+    BitWriter bits(out);
+    bits.Put(1, 1);     // 最后一块
+    bits.Put(1, 2);     // 固定 Huffman
+    const size_t distances[2] = { 3, stride };
+    size_t i = 0;
+    while (i < size) {
+        size_t bestLength = 0, bestDistance = 0;
+        for (size_t d : distances) {
+            if (d > i || d > 32768) continue;
+            size_t n = 0, limit = std::min<size_t>(258, size - i);
+            while (n < limit && data[i + n] == data[i + n - d]) ++n;
+            if (n > bestLength) {
+                bestLength = n;
+                bestDistance = d;
+            }
+        }
+        if (bestLength >= 3) {
+            PutMatch(bits, (int)bestLength, (int)bestDistance);
+            i += bestLength;
+        }
+        else {
+            PutLiteral(bits, data[i++]);
+        }
+    }
+    PutLiteral(bits, 256);
+    bits.Flush();
+    uint32_t a = 1, b = 0;
+    for (size_t k = 0; k < size; ) {
+        // 5552 字节内不会溢出
+        size_t end = std::min(size, k + 5552);
+        for (; k < end; ++k) {
+            a += data[k];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    for (int s = 24; s >= 0; s -= 8) out.push_back((uint8_t)(adler >> s));
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int s = 24; s >= 0; s -= 8) out.push_back((uint8_t)(v >> s));
+}
+
+// 长度 | 类型 | 数据 | CRC(类型 + 数据)；数据已经在 out 的末尾 size 字节
+void CloseChunk(std::vector<uint8_t>& out, size_t start) {
+    uint32_t size = (uint32_t)(out.size() - start - 8);
+    for (int s = 0; s < 4; ++s) out[start + s] = (uint8_t)(size >> (24 - s * 8));
+    PutU32(out, AssetPack::Crc32(out.data() + start + 4, size + 4));
+}
+
+size_t OpenChunk(std::vector<uint8_t>& out, const char* type) {
+    size_t start = out.size();
+    PutU32(out, 0);
+    out.insert(out.end(), type, type + 4);
+    return start;
+}
+
+} // namespace
+
+bool FrameWriter::WritePng(const uint8_t* rgba) {
+    // 每行：过滤类型 0 + RGB，透明通道不要
+    size_t stride = (size_t)width * 3 + 1;
+    planes.resize(stride * height);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* src = Row(rgba, y);
+        uint8_t* dst = planes.data() + stride * y;
+        *dst++ = 0;
+        for (int x = 0; x < width; ++x) {
+            dst[x * 3] = src[x * 4];
+            dst[x * 3 + 1] = src[x * 4 + 1];
+            dst[x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+
+    encoded.clear();
+    static const uint8_t kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    encoded.insert(encoded.end(), kSignature, kSignature + 8);
+    size_t chunk = OpenChunk(encoded, "IHDR");
+    PutU32(encoded, (uint32_t)width);
+    PutU32(encoded, (uint32_t)height);
+    encoded.insert(encoded.end(), { 8, 2, 0, 0, 0 });     // 8 位 RGB，不隔行
+    CloseChunk(encoded, chunk);
+    chunk = OpenChunk(encoded, "IDAT");
+    Deflate(planes.data(), planes.size(), stride, encoded);
+    CloseChunk(encoded, chunk);
+    chunk = OpenChunk(encoded, "IEND");
+    CloseChunk(encoded, chunk);
+
+    char name[1024];
+    std::snprintf(name, sizeof(name), path.c_str(), frameIndex);
+    // 先写临时文件再改名，看图的程序不会读到半张
+    std::string temp = std::string(name) + ".tmp";
+    FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(encoded.data(), 1, encoded.size(), f) == encoded.size();
+    ok = std::fclose(f) == 0 && ok;
+    // Windows 上 rename 不覆盖已有文件
+    std::remove(name);
+    ok = ok && std::rename(temp.c_str(), name) == 0;
+    if (ok) bytes += encoded.size();
+    return ok;
+}
@@ -0,0 +1,81 @@
+// FrameWriter.h
+#pragma once
+#include "SpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 录屏输出：渲染线程把 RGBA8 帧交给工作线程，由它转换格式并写盘
+//   path 以 .y4m 结尾：一个 YUV4MPEG2 文件（4:2:0，全范围 BT.601），ffmpeg/mpv 可以直接读
+//   path 含 printf 格式（如 frames/%05d.png）：每帧一张 PNG
+// 帧缓冲数量固定，全部在等待写盘时 Acquire 返回 nullptr，调用方丢掉这一帧而不是等磁盘
+class FrameWriter {
+public:
+    enum Format { Y4M, PNG };
+
+    struct Stats {
+        unsigned submitted = 0;     // 交给工作线程的帧
+        unsigned written = 0;       // 已写盘的帧
+        unsigned dropped = 0;       // 没有空闲缓冲而丢掉的帧
+        unsigned long long bytes = 0;
+    };
+
+    FrameWriter() = default;
+    ~FrameWriter() { Close(); }
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // bottomUp 为真时首行在下（glReadPixels 的行序）；slots 为帧缓冲数量，最多 kMaxSlots
+    bool Open(const std::string& path, int width, int height, int fps, bool bottomUp, int slots = 4);
+    // 写完已提交的帧后结束工作线程
+    void Close();
+    bool IsOpen() const { return worker.joinable(); }
+
+    // 取一块 Width()*Height()*4 字节的空闲缓冲；wait 为假且没有空闲时记一次丢帧并返回 nullptr
+    uint8_t* Acquire(bool wait = false);
+    void Submit(uint8_t* frame);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    Format GetFormat() const { return format; }
+    // 工作线程也在更新，只在 Close 之后读才是最终值
+    Stats GetStats() const;
+
+    static constexpr int kMaxSlots = 16;
+
+private:
+    void Run();
+    bool WriteY4m(const uint8_t* rgba);
+    bool WritePng(const uint8_t* rgba);
+    // 第 row 行（首行在上）
+    const uint8_t* Row(const uint8_t* rgba, int row) const;
+
+    Format format = Y4M;
+    std::string path;
+    int width = 0, height = 0, fps = 60;
+    bool bottomUp = false;
+    FILE* file = nullptr;
+    unsigned frameIndex = 0;
+
+    std::vector<std::vector<uint8_t>> slots;
+    // 帧缓冲编号在两个队列之间流转：free 由工作线程放回，ready 由渲染线程提交
+    SpscQueue<int, kMaxSlots> freeSlots, readySlots;
+    std::mutex mutex;
+    std::condition_variable wake;       // 有帧可写或者要结束
+    std::condition_variable released;   // 有缓冲被放回，Acquire(true) 在等
+    std::atomic<bool> stopping{ false };
+    std::thread worker;
+
+    std::atomic<unsigned> submitted{ 0 }, written{ 0 }, dropped{ 0 };
+    std::atomic<unsigned long long> bytes{ 0 };
+
+    // 工作线程的转换缓冲
+    std::vector<uint8_t> planes;
+    std::vector<uint8_t> encoded;
+};
@@ -0,0 +1,21 @@
+#include "GlApi.h"
+
+GlApi glApi;
+
+void LoadGlApi() {
+    glApi.UseProgram = glad_glUseProgram;
+    glApi.BindVertexArray = glad_glBindVertexArray;
+    glApi.BindBuffer = glad_glBindBuffer;
+    glApi.BindTexture = glad_glBindTexture;
+    glApi.Enable = glad_glEnable;
+    glApi.Disable = glad_glDisable;
+    glApi.LineWidth = glad_glLineWidth;
+    glApi.Uniform1i = glad_glUniform1i;
+    glApi.Uniform1f = glad_glUniform1f;
+    glApi.Uniform2f = glad_glUniform2f;
+    glApi.Uniform3f = glad_glUniform3f;
+    glApi.Uniform4f = glad_glUniform4f;
+    glApi.VertexAttribPointer = glad_glVertexAttribPointer;
+    glApi.DrawArrays = glad_glDrawArrays;
+    glApi.DrawArraysInstanced = glad_glDrawArraysInstanced;
+}
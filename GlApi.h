@@ -0,0 +1,28 @@
+// GlApi.h
+#pragma once
+#include <glad/glad.h>
+
+// 渲染命令提交时用到的 GL 入口，集中成一张函数表
+// 平时指向 glad 加载的驱动函数；基准程序可以换成 GlApiMock.h 里只计数的版本，不需要 GL 上下文
+struct GlApi {
+    PFNGLUSEPROGRAMPROC UseProgram = nullptr;
+    PFNGLBINDVERTEXARRAYPROC BindVertexArray = nullptr;
+    PFNGLBINDBUFFERPROC BindBuffer = nullptr;
+    PFNGLBINDTEXTUREPROC BindTexture = nullptr;
+    PFNGLENABLEPROC Enable = nullptr;
+    PFNGLDISABLEPROC Disable = nullptr;
+    PFNGLLINEWIDTHPROC LineWidth = nullptr;
+    PFNGLUNIFORM1IPROC Uniform1i = nullptr;
+    PFNGLUNIFORM1FPROC Uniform1f = nullptr;
+    PFNGLUNIFORM2FPROC Uniform2f = nullptr;
+    PFNGLUNIFORM3FPROC Uniform3f = nullptr;
+    PFNGLUNIFORM4FPROC Uniform4f = nullptr;
+    PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer = nullptr;
+    PFNGLDRAWARRAYSPROC DrawArrays = nullptr;
+    PFNGLDRAWARRAYSINSTANCEDPROC DrawArraysInstanced = nullptr;
+};
+
+extern GlApi glApi;
+
+// 在 gladLoadGLLoader 之后调用，glApi 指向 glad 加载的函数
+void LoadGlApi();
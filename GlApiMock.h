@@ -0,0 +1,65 @@
+// GlApiMock.h
+#pragma once
+#include "GlApi.h"
+
+// 只计数、不调用驱动的 GlApi，用来在没有 GL 上下文的地方核对一帧发出了多少次调用
+// 计数是全局的，同一时间只能有一个线程使用
+struct GlCallCounts {
+    unsigned useProgram = 0;
+    unsigned bindVertexArray = 0;
+    unsigned bindBuffer = 0;
+    unsigned bindTexture = 0;
+    unsigned enable = 0;
+    unsigned disable = 0;
+    unsigned lineWidth = 0;
+    unsigned uniforms = 0;
+    unsigned attribPointers = 0;
+    unsigned draws = 0;
+    unsigned instances = 0;
+
+    unsigned Total() const {
+        return useProgram + bindVertexArray + bindBuffer + bindTexture + enable + disable + lineWidth + uniforms + attribPointers + draws;
+    }
+};
+
+namespace GlMock {
+
+inline GlCallCounts counts;
+
+inline void APIENTRY UseProgram(GLuint) { counts.useProgram++; }
+inline void APIENTRY BindVertexArray(GLuint) { counts.bindVertexArray++; }
+inline void APIENTRY BindBuffer(GLenum, GLuint) { counts.bindBuffer++; }
+inline void APIENTRY BindTexture(GLenum, GLuint) { counts.bindTexture++; }
+inline void APIENTRY Enable(GLenum) { counts.enable++; }
+inline void APIENTRY Disable(GLenum) { counts.disable++; }
+inline void APIENTRY LineWidth(GLfloat) { counts.lineWidth++; }
+inline void APIENTRY Uniform1i(GLint, GLint) { counts.uniforms++; }
+inline void APIENTRY Uniform1f(GLint, GLfloat) { counts.uniforms++; }
+inline void APIENTRY Uniform2f(GLint, GLfloat, GLfloat) { counts.uniforms++; }
+inline void APIENTRY Uniform3f(GLint, GLfloat, GLfloat, GLfloat) { counts.uniforms++; }
+inline void APIENTRY Uniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { counts.uniforms++; }
+inline void APIENTRY VertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) { counts.attribPointers++; }
+inline void APIENTRY DrawArrays(GLenum, GLint, GLsizei) { counts.draws++; counts.instances++; }
+inline void APIENTRY DrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei n) { counts.draws++; counts.instances += (unsigned)n; }
+
+inline GlApi Api() {
+    GlApi api;
+    api.UseProgram = UseProgram;
+    api.BindVertexArray = BindVertexArray;
+    api.BindBuffer = BindBuffer;
+    api.BindTexture = BindTexture;
+    api.Enable = Enable;
+    api.Disable = Disable;
+    api.LineWidth = LineWidth;
+    api.Uniform1i = Uniform1i;
+    api.Uniform1f = Uniform1f;
+    api.Uniform2f = Uniform2f;
+    api.Uniform3f = Uniform3f;
+    api.Uniform4f = Uniform4f;
+    api.VertexAttribPointer = VertexAttribPointer;
+    api.DrawArrays = DrawArrays;
+    api.DrawArraysInstanced = DrawArraysInstanced;
+    return api;
+}
+
+} // namespace GlMock
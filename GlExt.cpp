@@ -0,0 +1,42 @@
+#include "GlExt.h"
+#include <cstring>
+
+GlExtensions glExt;
+
+bool HasGlExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if (ext && std::strcmp(ext, name) == 0) return true;
+    }
+    return false;
+}
+
+void LoadGlExtensions(GLADloadproc load) {
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    int version = major * 10 + minor;
+
+    glExt = GlExtensions();
+    if (version >= 44 || HasGlExtension("GL_ARB_buffer_storage")) {
+        glExt.BufferStorage = (PFNGLBUFFERSTORAGEPROC_EXT)load("glBufferStorage");
+        glExt.bufferStorage = glExt.BufferStorage != nullptr;
+    }
+
+    if (version >= 41 || HasGlExtension("GL_ARB_get_program_binary")) {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        glExt.GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC_EXT)load("glGetProgramBinary");
+        glExt.ProgramBinary = (PFNGLPROGRAMBINARYPROC_EXT)load("glProgramBinary");
+        glExt.ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC_EXT)load("glProgramParameteri");
+        glExt.programBinary = formats > 0 && glExt.GetProgramBinary && glExt.ProgramBinary && glExt.ProgramParameteri;
+    }
+
+    if (HasGlExtension("GL_KHR_parallel_shader_compile"))
+        glExt.MaxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSPROC_EXT)load("glMaxShaderCompilerThreadsKHR");
+    else if (HasGlExtension("GL_ARB_parallel_shader_compile"))
+        glExt.MaxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSPROC_EXT)load("glMaxShaderCompilerThreadsARB");
+    glExt.parallelShaderCompile = glExt.MaxShaderCompilerThreads != nullptr;
+}
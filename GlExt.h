@@ -0,0 +1,55 @@
+// GlExt.h
+#pragma once
+#include <glad/glad.h>
+
+// glad 只生成了 3.3 core，这里手动加载可选扩展的入口
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC_EXT)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC_EXT)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC_EXT)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC_EXT)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSPROC_EXT)(GLuint count);
+
+struct GlExtensions {
+    bool bufferStorage = false;                 // GL_ARB_buffer_storage / GL 4.4
+    PFNGLBUFFERSTORAGEPROC_EXT BufferStorage = nullptr;
+
+    bool programBinary = false;                 // GL_ARB_get_program_binary / GL 4.1，且驱动至少支持一种格式
+    PFNGLGETPROGRAMBINARYPROC_EXT GetProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYPROC_EXT ProgramBinary = nullptr;
+    PFNGLPROGRAMPARAMETERIPROC_EXT ProgramParameteri = nullptr;
+
+    bool parallelShaderCompile = false;         // GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile
+    PFNGLMAXSHADERCOMPILERTHREADSPROC_EXT MaxShaderCompilerThreads = nullptr;
+};
+
+extern GlExtensions glExt;
+
+// 查询当前上下文是否支持某个扩展
+bool HasGlExtension(const char* name);
+
+// 在 gladLoadGLLoader 之后调用，load 与传给 glad 的是同一个函数
+void LoadGlExtensions(GLADloadproc load);
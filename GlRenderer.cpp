@@ -0,0 +1,54 @@
+#include "GlRenderer.h"
+#include "SpriteBatch.h"
+#include "MapBorder.h"
+#include "GpuProfiler.h"
+
+#ifdef SNAKE_PROFILE
+// 遍切换时结束上一遍的区间、开始下一遍的；区间名按指针区分，必须是字面量
+static void TimePass(void* user, RenderPass pass) {
+    static const char* const kNames[PASS_COUNT] = { "Sprites", "Walls", "Particles", "Overlay" };
+    GpuProfiler& profiler = *(GpuProfiler*)user;
+    profiler.End();
+    if (pass < PASS_COUNT) profiler.Begin(kNames[pass]);
+}
+#endif
+
+GlRenderer::GlRenderer(SpriteBatch& spriteBatch, GLuint texture, MapBorder& mapBorder, ShaderManager& shaderManager, ShaderManager::Handle borderHandle)
+    : sprites(spriteBatch), spriteTexture(texture), border(mapBorder), shaders(shaderManager), borderShader(borderHandle) {
+}
+
+void GlRenderer::BeginFrame(float r, float g, float b) {
+    glClearColor(r, g, b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    queue.Clear();
+    sprites.Begin();
+}
+
+void GlRenderer::AddSprite(bool textured, const SpriteInstance& instance) {
+    sprites.Add(textured ? spriteTexture : 0, instance);
+}
+
+void GlRenderer::Flush() {
+    sprites.Flush(queue);
+}
+
+void GlRenderer::DrawBorder() {
+    GLuint program = shaders.Program(borderShader);
+    if (program) border.Enqueue(queue, program);
+}
+
+void GlRenderer::EndFrame() {
+    // 实例缓冲换了新的，旧名字可能被复用，记下的属性指针不再可信
+    if (sprites.Reallocations() != spriteReallocations) {
+        spriteReallocations = sprites.Reallocations();
+        cache.Invalidate();
+    }
+    cache.ResetStats();
+#ifdef SNAKE_PROFILE
+    if (gpuProfiler) queue.Submit(cache, TimePass, gpuProfiler);
+    else queue.Submit(cache);
+#else
+    queue.Submit(cache);
+#endif
+    sprites.Fence();
+}
@@ -0,0 +1,46 @@
+// GlRenderer.h
+#pragma once
+#include "Renderer.h"
+#include "RenderQueue.h"
+#include "GlStateCache.h"
+#include "ShaderManager.h"
+#include <glad/glad.h>
+
+class SpriteBatch;
+class MapBorder;
+class GpuProfiler;
+
+// OpenGL 后端：精灵交给 SpriteBatch，边框交给 MapBorder，二者都只往 RenderQueue 里放命令
+// EndFrame 时排序并经 GlStateCache 提交，与上一帧相同的状态不会重复设置
+// 边框程序每次从 ShaderManager 取，热重载后自动用新程序
+class GlRenderer : public Renderer {
+public:
+    GlRenderer(SpriteBatch& sprites, GLuint spriteTexture, MapBorder& border, ShaderManager& shaders, ShaderManager::Handle borderShader);
+
+    void BeginFrame(float r, float g, float b) override;
+    void AddSprite(bool textured, const SpriteInstance& instance) override;
+    void Flush() override;
+    void DrawBorder() override;
+    void EndFrame() override;
+
+    // 其他绘制（瓦片层）也放进同一个队列
+    RenderQueue& Queue() { return queue; }
+    // 上一次 EndFrame 的提交统计
+    const RenderStats& Stats() const { return cache.Stats(); }
+    // 绕过队列改了 GL 状态之后调用（着色器热重载、纹理上传等）
+    void InvalidateState() { cache.Invalidate(); }
+    // 开了 SNAKE_PROFILE 时，EndFrame 给每一遍单独开一个 GPU 区间
+    void SetGpuProfiler(GpuProfiler* profiler) { gpuProfiler = profiler; }
+
+private:
+    SpriteBatch& sprites;
+    GLuint spriteTexture;
+    MapBorder& border;
+    ShaderManager& shaders;
+    ShaderManager::Handle borderShader;
+
+    RenderQueue queue;
+    GlStateCache cache;
+    GpuProfiler* gpuProfiler = nullptr;
+    unsigned spriteReallocations = 0;
+};
@@ -0,0 +1,118 @@
+#include "GlStateCache.h"
+#include <cstring>
+
+void GlStateCache::Invalidate() {
+    program = vao = arrayBuffer = kUnknown;
+    texture2D = texture2DArray = kUnknown;
+    depthTest = blend = -1;
+    lineWidth = -1.0f;
+    uniforms.clear();
+    attribs.clear();
+}
+
+void GlStateCache::UseProgram(GLuint p) {
+    if (p == program) {
+        stats.skipped++;
+        return;
+    }
+    gl.UseProgram(p);
+    program = p;
+    stats.programBinds++;
+}
+
+void GlStateCache::BindVertexArray(GLuint v) {
+    if (v == vao) {
+        stats.skipped++;
+        return;
+    }
+    gl.BindVertexArray(v);
+    vao = v;
+    stats.vaoBinds++;
+}
+
+void GlStateCache::BindArrayBuffer(GLuint buffer) {
+    if (buffer == arrayBuffer) {
+        stats.skipped++;
+        return;
+    }
+    gl.BindBuffer(GL_ARRAY_BUFFER, buffer);
+    arrayBuffer = buffer;
+    stats.bufferBinds++;
+}
+
+void GlStateCache::BindTexture(GLenum target, GLuint texture) {
+    GLuint* bound = target == GL_TEXTURE_2D_ARRAY ? &texture2DArray : target == GL_TEXTURE_2D ? &texture2D : nullptr;
+    if (bound && *bound == texture) {
+        stats.skipped++;
+        return;
+    }
+    gl.BindTexture(target, texture);
+    if (bound) *bound = texture;
+    stats.textureBinds++;
+}
+
+void GlStateCache::SetEnabled(GLenum cap, bool enabled) {
+    int* state = cap == GL_DEPTH_TEST ? &depthTest : cap == GL_BLEND ? &blend : nullptr;
+    if (state && *state == (int)enabled) {
+        stats.skipped++;
+        return;
+    }
+    if (enabled) gl.Enable(cap);
+    else gl.Disable(cap);
+    if (state) *state = (int)enabled;
+    stats.capChanges++;
+}
+
+void GlStateCache::LineWidth(float width) {
+    if (width == lineWidth) {
+        stats.skipped++;
+        return;
+    }
+    gl.LineWidth(width);
+    lineWidth = width;
+    stats.capChanges++;
+}
+
+void GlStateCache::Uniform(const UniformValue& value) {
+    if (value.location < 0) return;
+    StoredUniform stored;
+    stored.type = value.type;
+    std::memcpy(stored.bits, value.f, sizeof(stored.bits));
+    if (value.type == UNIFORM_INT) stored.bits[1] = stored.bits[2] = stored.bits[3] = 0;
+    uint64_t key = ((uint64_t)program << 32) | (uint32_t)value.location;
+    auto it = uniforms.find(key);
+    if (program != kUnknown && it != uniforms.end() &&
+        it->second.type == stored.type && std::memcmp(it->second.bits, stored.bits, sizeof(stored.bits)) == 0) {
+        stats.skipped++;
+        return;
+    }
+    switch (value.type) {
+    case UNIFORM_INT: gl.Uniform1i(value.location, value.i); break;
+    case UNIFORM_FLOAT: gl.Uniform1f(value.location, value.f[0]); break;
+    case UNIFORM_VEC2: gl.Uniform2f(value.location, value.f[0], value.f[1]); break;
+    case UNIFORM_VEC3: gl.Uniform3f(value.location, value.f[0], value.f[1], value.f[2]); break;
+    case UNIFORM_VEC4: gl.Uniform4f(value.location, value.f[0], value.f[1], value.f[2], value.f[3]); break;
+    }
+    if (program != kUnknown) uniforms[key] = stored;
+    stats.uniformUploads++;
+}
+
+void GlStateCache::AttribPointer(GLuint location, GLint size, GLsizei stride, size_t offset) {
+    uint64_t key = ((uint64_t)vao << 32) | location;
+    auto it = attribs.find(key);
+    if (vao != kUnknown && arrayBuffer != kUnknown && it != attribs.end() &&
+        it->second.buffer == arrayBuffer && it->second.size == size && it->second.stride == stride && it->second.offset == offset) {
+        stats.skipped++;
+        return;
+    }
+    gl.VertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, stride, (const void*)offset);
+    if (vao != kUnknown && arrayBuffer != kUnknown) attribs[key] = { arrayBuffer, size, stride, offset };
+    stats.attribPointers++;
+}
+
+void GlStateCache::Draw(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+    if (instances > 0) gl.DrawArraysInstanced(mode, first, count, instances);
+    else gl.DrawArrays(mode, first, count);
+    stats.drawCalls++;
+    stats.instances += instances > 0 ? (unsigned)instances : 1;
+}
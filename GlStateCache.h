@@ -0,0 +1,94 @@
+// GlStateCache.h
+#pragma once
+#include "GlApi.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+// 提交统计：实际发出的调用次数，以及因为与影子状态相同而省掉的次数
+struct RenderStats {
+    unsigned commands = 0;
+    unsigned drawCalls = 0;
+    unsigned instances = 0;
+    unsigned programBinds = 0;
+    unsigned vaoBinds = 0;
+    unsigned bufferBinds = 0;
+    unsigned textureBinds = 0;
+    unsigned attribPointers = 0;
+    unsigned uniformUploads = 0;
+    unsigned capChanges = 0;        // glEnable/glDisable/glLineWidth
+    unsigned skipped = 0;
+
+    unsigned StateChanges() const {
+        return programBinds + vaoBinds + bufferBinds + textureBinds + attribPointers + uniformUploads + capChanges;
+    }
+};
+
+enum UniformType : uint8_t { UNIFORM_INT, UNIFORM_FLOAT, UNIFORM_VEC2, UNIFORM_VEC3, UNIFORM_VEC4 };
+
+struct UniformValue {
+    GLint location = -1;
+    UniformType type = UNIFORM_FLOAT;
+    union {
+        GLint i;
+        GLfloat f[4];
+    };
+    UniformValue() : f{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+};
+
+// GL 状态的影子副本：记下最后一次设置的程序、VAO、缓冲、纹理、开关和各程序的 uniform，
+// 与要设置的值相同就不再调用驱动
+// 纹理只用第 0 号纹理单元；顶点属性只支持 float，按 VAO 和 location 分别记录
+// 绕过它直接改了这些状态的代码（纹理上传、着色器热重载等）之后要调用 Invalidate
+class GlStateCache {
+public:
+    // 只记下函数表的引用（glApi 在 LoadGlApi 之后才填好），临时对象不能传进来
+    explicit GlStateCache(const GlApi& api = glApi) : gl(api) { Invalidate(); }
+    GlStateCache(GlApi&&) = delete;
+
+    // 忘掉全部影子状态，下一次设置一定会调用驱动
+    void Invalidate();
+    // 只忘掉 GL_ARRAY_BUFFER 的绑定；上传实例数据的代码会直接绑缓冲
+    void InvalidateArrayBuffer() { arrayBuffer = kUnknown; }
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindArrayBuffer(GLuint buffer);
+    void BindTexture(GLenum target, GLuint texture);
+    // 只跟踪 GL_DEPTH_TEST 和 GL_BLEND
+    void SetEnabled(GLenum cap, bool enabled);
+    void LineWidth(float width);
+    // 设置当前程序的 uniform
+    void Uniform(const UniformValue& value);
+    // 当前 VAO 的 location 属性指向当前 GL_ARRAY_BUFFER 的 offset 处，size 个 float
+    void AttribPointer(GLuint location, GLint size, GLsizei stride, size_t offset);
+    // instances 为 0 时用 glDrawArrays
+    void Draw(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+
+    const RenderStats& Stats() const { return stats; }
+    void CountCommands(unsigned n) { stats.commands += n; }
+    void ResetStats() { stats = RenderStats(); }
+
+private:
+    static const GLuint kUnknown = 0xFFFFFFFFu;
+
+    struct Attrib {
+        GLuint buffer;
+        GLint size;
+        GLsizei stride;
+        size_t offset;
+    };
+    struct StoredUniform {
+        UniformType type;
+        uint32_t bits[4];
+    };
+
+    const GlApi& gl;
+    GLuint program, vao, arrayBuffer;
+    GLuint texture2D, texture2DArray;
+    int depthTest, blend;           // -1 未知
+    float lineWidth;
+    std::unordered_map<uint64_t, StoredUniform> uniforms;     // (程序 << 32) | location
+    std::unordered_map<uint64_t, Attrib> attribs;             // (VAO << 32) | location
+    RenderStats stats;
+};
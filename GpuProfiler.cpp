@@ -0,0 +1,51 @@
+#include "GpuProfiler.h"
+
+GpuProfiler::GpuProfiler() {
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (int i = 0; i < zoneCount; ++i) glDeleteQueries(2, zones[i].queries);
+}
+
+void GpuProfiler::Begin(const char* name) {
+    if (active >= 0) return;
+    int index = 0;
+    while (index < zoneCount && zones[index].name != name) index++;
+    if (index == zoneCount) {
+        if (zoneCount == kMaxZones) return;
+        zones[index].name = name;
+        glGenQueries(2, zones[index].queries);
+        zoneCount++;
+    }
+    Zone& zone = zones[index];
+    unsigned slot = frame & 1;
+    // 上一轮的结果没来得及读，这个查询对象直接复用
+    if (zone.pending[slot]) dropped++;
+    zone.cpuStart[slot] = Profiler::NowNs();
+    glBeginQuery(GL_TIME_ELAPSED, zone.queries[slot]);
+    zone.pending[slot] = true;
+    active = index;
+}
+
+void GpuProfiler::End() {
+    if (active < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    active = -1;
+}
+
+void GpuProfiler::EndFrame() {
+    frame++;
+    // 这一帧要复用的正是上一帧的那组查询，先把能读的结果读出来
+    unsigned slot = frame & 1;
+    for (int i = 0; i < zoneCount; ++i) {
+        Zone& zone = zones[i];
+        if (!zone.pending[slot]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(zone.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(zone.queries[slot], GL_QUERY_RESULT, &elapsed);
+        Profiler::RecordGpuZone(zone.name, zone.cpuStart[slot], (uint64_t)elapsed);
+        zone.pending[slot] = false;
+    }
+}
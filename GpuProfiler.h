@@ -0,0 +1,60 @@
+// GpuProfiler.h
+#pragma once
+#include <glad/glad.h>
+#include "Profiler.h"
+#include <cstdint>
+
+// GPU 区间：每个区间两个 GL_TIME_ELAPSED 查询对象，奇偶帧轮流使用
+// 第 N 帧结束时读第 N-1 帧的结果，结果还没出来就丢弃这一次，绝不阻塞等待
+// 同一时刻只能有一个区间处于计时中（GL_TIME_ELAPSED 不能嵌套）
+class GpuProfiler {
+public:
+    static const int kMaxZones = 8;
+
+    GpuProfiler();
+    ~GpuProfiler();
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // name 必须是字符串字面量，按指针区分区间
+    void Begin(const char* name);
+    void End();
+    // 每帧 SwapBuffers 之前调用一次
+    void EndFrame();
+
+    unsigned long long Dropped() const { return dropped; }
+
+private:
+    struct Zone {
+        const char* name = nullptr;
+        GLuint queries[2] = { 0, 0 };
+        uint64_t cpuStart[2] = { 0, 0 };    // 导出时把 GPU 区间放在发起时的 CPU 时刻
+        bool pending[2] = { false, false };
+    };
+
+    Zone zones[kMaxZones];
+    int zoneCount = 0;
+    int active = -1;
+    unsigned frame = 0;
+    unsigned long long dropped = 0;
+};
+
+// 作用域内的 GPU 计时
+class GpuZoneScope {
+public:
+    GpuZoneScope(GpuProfiler& p, const char* name) : profiler(p) { profiler.Begin(name); }
+    ~GpuZoneScope() { profiler.End(); }
+    GpuZoneScope(const GpuZoneScope&) = delete;
+    GpuZoneScope& operator=(const GpuZoneScope&) = delete;
+
+private:
+    GpuProfiler& profiler;
+};
+
+#ifdef SNAKE_PROFILE
+#define PROFILE_GPU_ZONE(profiler, name) GpuZoneScope PROFILE_CONCAT(profileGpuZone, __LINE__)(profiler, name)
+#define PROFILE_GPU_FRAME(profiler) (profiler).EndFrame()
+#else
+#define PROFILE_GPU_ZONE(profiler, name) ((void)0)
+#define PROFILE_GPU_FRAME(profiler) ((void)0)
+#endif
@@ -0,0 +1,47 @@
+// LatencyHistogram.h
+#pragma once
+#include <cstring>
+
+// 固定桶宽的延迟直方图，记录时不分配内存
+// 单线程写入；读取要等写入线程停下（或接受读到半更新的计数）
+class LatencyHistogram {
+public:
+    static const int kBuckets = 400;
+    static constexpr double kBucketMs = 0.5;    // 0 ~ 200 ms，超出的计入最后一个桶
+
+    void Clear() {
+        std::memset(buckets, 0, sizeof(buckets));
+        count = 0;
+        sumMs = maxMs = 0.0;
+    }
+
+    void Record(double seconds) {
+        double ms = seconds * 1000.0;
+        if (ms < 0.0) ms = 0.0;
+        int b = (int)(ms / kBucketMs);
+        if (b >= kBuckets) b = kBuckets - 1;
+        buckets[b]++;
+        count++;
+        sumMs += ms;
+        if (ms > maxMs) maxMs = ms;
+    }
+
+    unsigned long long Count() const { return count; }
+    double MeanMs() const { return count ? sumMs / count : 0.0; }
+    double MaxMs() const { return maxMs; }
+    // p 取 0~1，返回所在桶的上沿
+    double PercentileMs(double p) const {
+        if (count == 0) return 0.0;
+        unsigned long long target = (unsigned long long)(p * (count - 1)) + 1, seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += buckets[b];
+            if (seen >= target) return (b + 1) * kBucketMs;
+        }
+        return maxMs;
+    }
+
+private:
+    unsigned long long buckets[kBuckets] = {};
+    unsigned long long count = 0;
+    double sumMs = 0.0, maxMs = 0.0;
+};
@@ -29,22 +29,19 @@ MapBorder::~MapBorder() {
     glDeleteBuffers(1, &VBO);
 }
 
-void MapBorder::Draw(GLuint shaderProgram) {
-    // ϲ㣺Ȳԣã
-    GLboolean depthEnabled = (glIsEnabled(GL_DEPTH_TEST) == GL_TRUE);
-    if (depthEnabled) glDisable(GL_DEPTH_TEST);
-
-    glUseProgram(shaderProgram);
-    // ѡ shader ɫ uniformҪ
-    GLint colorLoc = glGetUniformLocation(shaderProgram, "color");
-    if (colorLoc != -1) {
-        glUniform3f(colorLoc, 1.0f, 1.0f, 1.0f); // ɫ
+void MapBorder::Enqueue(RenderQueue& queue, GLuint shaderProgram) {
+    if (shaderProgram != cachedProgram) {
+        // λֻڻ˳ʱѯһ
+        colorLoc = glGetUniformLocation(shaderProgram, "color");
+        cachedProgram = shaderProgram;
     }
-
-    glBindVertexArray(VAO);
-    glLineWidth(3.0f); // Щƽ̨ܺ߿
-    glDrawArrays(GL_LINE_LOOP, 0, 4);
-    glBindVertexArray(0);
-
-    if (depthEnabled) glEnable(GL_DEPTH_TEST);
+    // ϲ㣺صȲԣ״̬Ƿĵ
+    RenderCommand& c = queue.Add(PASS_OVERLAY);
+    c.program = shaderProgram;
+    c.vao = VAO;
+    c.mode = GL_LINE_LOOP;
+    c.count = 4;
+    c.depthTest = false;
+    c.lineWidth = 3.0f; // Щƽ̨ܺ߿
+    c.SetVec3(colorLoc, 1.0f, 1.0f, 1.0f); // ɫ
 }
@@ -2,13 +2,18 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm.hpp>
+#include "RenderQueue.h"
 
 class MapBorder {
 public:
     MapBorder(float left, float right, float top, float bottom);
     ~MapBorder();
-    void Draw(GLuint shaderProgram);
+    // 往队列里放一条画线框的命令，在 PASS_OVERLAY 里最后画
+    void Enqueue(RenderQueue& queue, GLuint shaderProgram);
 
 private:
     GLuint VAO, VBO;
+    // color 的位置按程序缓存，热重载换了程序才重新查询
+    GLuint cachedProgram = 0;
+    GLint colorLoc = -1;
 };
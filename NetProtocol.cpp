@@ -0,0 +1,183 @@
+#include "NetProtocol.h"
+#include <vector>
+
+namespace Net {
+
+void BitWriter::Write(uint32_t value, int bits) {
+    if (bitPos + bits > cap * 8) {
+        overflow = true;
+        return;
+    }
+    for (int i = 0; i < bits; ++i, ++bitPos) {
+        uint8_t& b = data[bitPos >> 3];
+        if ((bitPos & 7) == 0) b = 0;
+        b |= (uint8_t)(((value >> i) & 1) << (bitPos & 7));
+    }
+}
+
+uint32_t BitReader::Read(int bits) {
+    if (bitPos + bits > size * 8) {
+        overflow = true;
+        return 0;
+    }
+    uint32_t v = 0;
+    for (int i = 0; i < bits; ++i, ++bitPos)
+        v |= (uint32_t)((data[bitPos >> 3] >> (bitPos & 7)) & 1) << i;
+    return v;
+}
+
+int CellBits(int size) {
+    int bits = 1;
+    while ((1 << bits) < size) bits++;
+    return bits;
+}
+
+static const int kSlotBits = 5;
+static const int kCountBits = 6;
+static const int kLengthBits = 12;
+
+static void WriteCell(BitWriter& w, Vec2i c, int bx, int by) {
+    w.Write((uint32_t)c.x, bx);
+    w.Write((uint32_t)c.y, by);
+}
+
+static Vec2i ReadCell(BitReader& r, int bx, int by) {
+    Vec2i c;
+    c.x = (int)r.Read(bx);
+    c.y = (int)r.Read(by);
+    return c;
+}
+
+// 每条 tick 开始时活着的蛇：1 位死亡，没死再跟 2 位方向和 1 位长没长；
+// 然后是出生的蛇（槽位、格子、方向）和新放的食物
+size_t WriteEvents(const ArenaSim::TickEvents& e, int width, int height, uint8_t* out, size_t capacity) {
+    int bx = CellBits(width), by = CellBits(height);
+    BitWriter w(out, capacity);
+    for (int s = 0; s < ArenaSim::kMaxSnakes; ++s) {
+        if (!(e.aliveBefore >> s & 1)) continue;
+        uint8_t r = e.result[s];
+        w.Write((r & ArenaSim::kDied) ? 1 : 0, 1);
+        if (!(r & ArenaSim::kDied)) w.Write(r & 7, 3);
+    }
+    w.Write((uint32_t)e.spawns.size(), kCountBits);
+    for (const ArenaSim::Spawn& s : e.spawns) {
+        w.Write(s.slot, kSlotBits);
+        w.Write(s.dir, 2);
+        WriteCell(w, s.cell, bx, by);
+    }
+    w.Write((uint32_t)e.food.size(), kCountBits);
+    for (Vec2i c : e.food) WriteCell(w, c, bx, by);
+    return w.Overflow() ? 0 : w.Bytes();
+}
+
+bool ReadEvents(const uint8_t* in, size_t size, uint32_t aliveBefore, int width, int height, ArenaSim::TickEvents& e) {
+    int bx = CellBits(width), by = CellBits(height);
+    BitReader r(in, size);
+    e.Clear();
+    e.aliveBefore = aliveBefore;
+    for (int s = 0; s < ArenaSim::kMaxSnakes; ++s) {
+        if (!(aliveBefore >> s & 1)) continue;
+        e.result[s] = r.Read(1) ? ArenaSim::kDied : (uint8_t)r.Read(3);
+    }
+    uint32_t spawns = r.Read(kCountBits);
+    for (uint32_t i = 0; i < spawns && !r.Overflow(); ++i) {
+        ArenaSim::Spawn s;
+        s.slot = (uint8_t)r.Read(kSlotBits);
+        s.dir = (uint8_t)r.Read(2);
+        s.cell = ReadCell(r, bx, by);
+        e.spawns.push_back(s);
+    }
+    uint32_t food = r.Read(kCountBits);
+    for (uint32_t i = 0; i < food && !r.Overflow(); ++i) e.food.push_back(ReadCell(r, bx, by));
+    return !r.Overflow();
+}
+
+// 32 位存在位图；每条蛇：2 位当前方向 | 12 位长度-1 | 蛇头 | 从头往尾每节 2 位方向码；最后是食物
+// 64x64 的房间最坏约 1.2 KB，放得进一个包
+size_t WriteFull(const ArenaSim& arena, uint8_t* out, size_t capacity) {
+    int bx = CellBits(arena.Width()), by = CellBits(arena.Height());
+    BitWriter w(out, capacity);
+    w.Write(arena.AliveMask(), ArenaSim::kMaxSnakes);
+    for (int s = 0; s < ArenaSim::kMaxSnakes; ++s) {
+        const ArenaSim::Snake& snake = arena.GetSnake(s);
+        if (!snake.alive) continue;
+        w.Write((uint32_t)ArenaSim::DirCode(snake.direction), 2);
+        w.Write((uint32_t)snake.body.Size() - 1, kLengthBits);
+        WriteCell(w, snake.body[0], bx, by);
+        for (size_t i = 1; i < snake.body.Size(); ++i) {
+            Vec2i a = snake.body[i - 1], b = snake.body[i];
+            w.Write((uint32_t)ArenaSim::DirCode({ b.x - a.x, b.y - a.y }), 2);
+        }
+    }
+    w.Write((uint32_t)arena.Food().size(), kCountBits);
+    for (Vec2i c : arena.Food()) WriteCell(w, c, bx, by);
+    return w.Overflow() ? 0 : w.Bytes();
+}
+
+static bool ReadFull(const uint8_t* in, size_t size, ArenaSim& arena) {
+    int bx = CellBits(arena.Width()), by = CellBits(arena.Height());
+    BitReader r(in, size);
+    uint32_t alive = r.Read(ArenaSim::kMaxSnakes);
+    std::vector<Vec2i> cells;
+    for (int s = 0; s < ArenaSim::kMaxSnakes; ++s) {
+        if (!(alive >> s & 1)) continue;
+        Vec2i dir = ArenaSim::kDirs[r.Read(2)];
+        size_t length = r.Read(kLengthBits) + 1;
+        cells.resize(length);
+        cells[0] = ReadCell(r, bx, by);
+        for (size_t i = 1; i < length; ++i) {
+            Vec2i d = ArenaSim::kDirs[r.Read(2)];
+            cells[i] = { cells[i - 1].x + d.x, cells[i - 1].y + d.y };
+        }
+        if (r.Overflow() || !arena.PlaceSnake(s, cells.data(), length, dir)) return false;
+    }
+    uint32_t food = r.Read(kCountBits);
+    for (uint32_t i = 0; i < food; ++i) {
+        Vec2i c = ReadCell(r, bx, by);
+        if (r.Overflow() || !arena.PlaceFood(c)) return false;
+    }
+    return !r.Overflow();
+}
+
+ApplyResult ApplySnapshot(const uint8_t* packet, size_t size, ArenaSim& arena, bool& valid) {
+    if (size < kSnapshotHeader) return CORRUPT;
+    uint8_t type = packet[0];
+    uint32_t tick = GetU32(packet + 1);
+    uint32_t hash = GetU32(packet + 7);
+    if (valid && tick <= arena.Tick()) return STALE;
+
+    if (type == MSG_FULL) {
+        arena.ResetTo(tick);
+        valid = ReadFull(packet + kSnapshotHeader, size - kSnapshotHeader, arena) && arena.StateHash() == hash;
+        return valid ? APPLIED : CORRUPT;
+    }
+    if (type != MSG_DELTA || size < kDeltaHeader) return CORRUPT;
+    uint32_t baseline = GetU32(packet + kSnapshotHeader);
+    if (!valid || baseline > arena.Tick()) return GAP;
+
+    // 基准之后的每一段都在包里，手里已经有的 tick 跳过
+    const uint8_t* p = packet + kDeltaHeader;
+    const uint8_t* end = packet + size;
+    ArenaSim::TickEvents e;
+    for (uint32_t t = baseline + 1; t <= tick; ++t) {
+        if (p >= end || p + 1 + *p > end) {
+            valid = false;
+            return CORRUPT;
+        }
+        size_t length = *p++;
+        if (t > arena.Tick()) {
+            if (!ReadEvents(p, length, arena.AliveMask(), arena.Width(), arena.Height(), e) || !arena.Apply(e)) {
+                valid = false;
+                return CORRUPT;
+            }
+        }
+        p += length;
+    }
+    if (arena.StateHash() != hash) {
+        valid = false;
+        return CORRUPT;
+    }
+    return APPLIED;
+}
+
+}
@@ -0,0 +1,86 @@
+// NetProtocol.h
+#pragma once
+#include "ArenaSim.h"
+#include <cstddef>
+#include <cstdint>
+
+// 联机协议，UDP，整数都是小端
+// 客户端 -> 服务器
+//   JOIN     u8 类型 | u32 nonce                   nonce 由客户端随机选，重发的 JOIN 得到同样的回复
+//   INPUT    u8 类型 | u32 客户端号 | u32 已应用到的 tick | u16 最新输入序号 | u8 个数 n | n 个方向码
+//            方向码依次是序号 seq-n+1 .. seq 的输入；每个包都带上最近几次，丢一个包不丢按键
+//            已应用到的 tick 为 0 表示手里没有可用的局面，要完整快照
+//   LEAVE    u8 类型 | u32 客户端号
+// 服务器 -> 客户端，每个 tick 一个快照
+//   WELCOME  u8 类型 | u32 nonce | u32 客户端号 | u16 房间 | u8 槽位 | u8 宽 | u8 高
+//   REJECT   u8 类型 | u32 nonce                   房间都满了
+//   FULL     u8 类型 | u32 tick | u16 已处理的输入序号 | u32 局面摘要 | 位流：整个局面
+//   DELTA    u8 类型 | u32 tick | u16 已处理的输入序号 | u32 局面摘要 | u32 基准 tick |
+//            基准之后每个 tick 一段：u8 字节数 | 位流
+// 增量里每条蛇每个 tick 只有 4 位：死了没有、新头的方向、长没长；
+// 新头是旧头加方向，不长的蛇去掉尾格，两边都能推出来，所以头尾的格子都不用发
+// 客户端用已处理的输入序号丢掉服务器已经收到的输入，再在最新快照上重放剩下的做预测
+namespace Net {
+
+    enum MessageType : uint8_t {
+        MSG_JOIN = 1, MSG_INPUT, MSG_LEAVE,
+        MSG_WELCOME = 16, MSG_REJECT, MSG_FULL, MSG_DELTA,
+    };
+
+    const size_t kMaxPacket = 1400;
+    const int kMaxInputs = 4;
+    // 服务器保留最近这么多个 tick 的增量，客户端落后更多时发完整快照
+    const int kHistory = 32;
+    const size_t kSnapshotHeader = 11;
+    const size_t kDeltaHeader = kSnapshotHeader + 4;
+    const uint8_t kNoInput = 0xFF;
+
+    inline void PutU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+    inline void PutU32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (i * 8)); }
+    inline uint16_t GetU16(const uint8_t* p) { return (uint16_t)(p[0] | p[1] << 8); }
+    inline uint32_t GetU32(const uint8_t* p) { return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24; }
+
+    // 位流，低位在前；写满或读过头时置 Overflow，不越界
+    class BitWriter {
+    public:
+        BitWriter(uint8_t* out, size_t capacity) : data(out), cap(capacity) {}
+        void Write(uint32_t value, int bits);
+        size_t Bytes() const { return (bitPos + 7) / 8; }
+        bool Overflow() const { return overflow; }
+    private:
+        uint8_t* data;
+        size_t cap, bitPos = 0;
+        bool overflow = false;
+    };
+
+    class BitReader {
+    public:
+        BitReader(const uint8_t* in, size_t size) : data(in), size(size) {}
+        uint32_t Read(int bits);
+        bool Overflow() const { return overflow; }
+    private:
+        const uint8_t* data;
+        size_t size, bitPos = 0;
+        bool overflow = false;
+    };
+
+    // 坐标每维占的位数
+    int CellBits(int size);
+
+    // 一个 tick 的增量；返回字节数，放不下返回 0
+    size_t WriteEvents(const ArenaSim::TickEvents& e, int width, int height, uint8_t* out, size_t capacity);
+    // aliveBefore 取客户端副本当前的 AliveMask()
+    bool ReadEvents(const uint8_t* in, size_t size, uint32_t aliveBefore, int width, int height, ArenaSim::TickEvents& e);
+    // 整个局面：每条蛇是头的坐标加上逐节的方向码
+    size_t WriteFull(const ArenaSim& arena, uint8_t* out, size_t capacity);
+
+    enum ApplyResult {
+        APPLIED,
+        STALE,          // 比手里的局面旧，或者乱序到达
+        GAP,            // 基准比手里的局面新（中间丢了包），等服务器从已确认的 tick 重发
+        CORRUPT,        // 包坏了或者应用后摘要对不上，局面作废，等完整快照
+    };
+    // 客户端收到 FULL/DELTA 后调用；valid 表示 arena 是否是某个 tick 的正确局面，开始时为 false
+    ApplyResult ApplySnapshot(const uint8_t* packet, size_t size, ArenaSim& arena, bool& valid);
+
+}
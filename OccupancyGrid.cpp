@@ -0,0 +1,46 @@
+#include "OccupancyGrid.h"
+
+OccupancyGrid::OccupancyGrid(int gridWidth, int gridHeight)
+    : width(gridWidth), height(gridHeight) {
+    size_t cells = (size_t)width * height;
+    bits.assign((cells + 63) / 64, 0);
+    freeSlot.assign(cells, 0);
+    freeCells.reserve((size_t)(width - 2) * (height - 2));
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint32_t i = Index({ x, y });
+            if (x == 0 || y == 0 || x == width - 1 || y == height - 1) {
+                bits[i >> 6] |= 1ULL << (i & 63);
+            }
+            else {
+                freeSlot[i] = (uint32_t)freeCells.size();
+                freeCells.push_back(i);
+            }
+        }
+    }
+}
+
+void OccupancyGrid::Occupy(Vec2i cell) {
+    uint32_t i = Index(cell);
+    uint64_t mask = 1ULL << (i & 63);
+    if (bits[i >> 6] & mask) return;
+    bits[i >> 6] |= mask;
+
+    // 用最后一个空格填补被占用的位置
+    uint32_t slot = freeSlot[i];
+    uint32_t last = freeCells.back();
+    freeCells[slot] = last;
+    freeSlot[last] = slot;
+    freeCells.pop_back();
+}
+
+void OccupancyGrid::Release(Vec2i cell) {
+    uint32_t i = Index(cell);
+    uint64_t mask = 1ULL << (i & 63);
+    if (!(bits[i >> 6] & mask)) return;
+    bits[i >> 6] &= ~mask;
+
+    freeSlot[i] = (uint32_t)freeCells.size();
+    freeCells.push_back(i);
+}
@@ -0,0 +1,39 @@
+// OccupancyGrid.h
+#pragma once
+#include "SnakeBody.h"
+#include <vector>
+#include <cstdint>
+
+// 棋盘占用位图 + 可索引的空格集合
+// 位图给出 O(1) 的碰撞检测；空格集合是“交换删除”的数组加上每格在数组中的位置，
+// 增删都是 O(1)，并且可以按下标均匀地抽取一个空格放食物
+// 外圈一格是墙，始终视为占用，不进入空格集合
+class OccupancyGrid {
+public:
+    OccupancyGrid(int width, int height);
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    bool Occupied(Vec2i cell) const {
+        uint32_t i = Index(cell);
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+    void Occupy(Vec2i cell);
+    void Release(Vec2i cell);
+
+    size_t FreeCount() const { return freeCells.size(); }
+    // 第 k 个空格，k < FreeCount()
+    Vec2i FreeCell(size_t k) const {
+        uint32_t i = freeCells[k];
+        return { (int)(i % (uint32_t)width), (int)(i / (uint32_t)width) };
+    }
+
+private:
+    uint32_t Index(Vec2i cell) const { return (uint32_t)cell.y * (uint32_t)width + (uint32_t)cell.x; }
+
+    int width, height;
+    std::vector<uint64_t> bits;
+    std::vector<uint32_t> freeCells;
+    std::vector<uint32_t> freeSlot;     // 格子在 freeCells 中的位置，仅空格有效
+};
@@ -0,0 +1,102 @@
+#include "ParticleLayer.h"
+#include "ParticleSystem.h"
+#include <algorithm>
+
+// 粒子的位置以格为单位，减去相机中心再乘每格尺寸；随 life 缩小并淡出，片元里裁成圆点
+static const char* particleVertexSource = R"(
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in float aX;
+layout(location = 3) in float aY;
+layout(location = 4) in float aLife;
+layout(location = 5) in vec4 aColor;
+
+uniform vec2 camera;        // 相机中心，单位为格
+uniform float cellScale;    // 每格的 NDC 尺寸
+
+out vec2 corner;
+out vec4 color;
+
+void main() {
+    float life = clamp(aLife, 0.0, 1.0);
+    gl_Position = vec4((vec2(aX, aY) - camera) * cellScale + aPos * (0.15 + 0.25 * life), 0.0, 1.0);
+    corner = aTexCoord * 2.0 - 1.0;
+    color = vec4(aColor.rgb, aColor.a * life);
+}
+)";
+
+static const char* particleFragmentSource = R"(
+#version 330 core
+in vec2 corner;
+in vec4 color;
+out vec4 FragColor;
+
+void main() {
+    float fade = clamp(1.0 - dot(corner, corner), 0.0, 1.0);
+    FragColor = vec4(color.rgb, color.a * fade);
+}
+)";
+
+ParticleLayer::ParticleLayer(GLuint quadVBO, size_t maxParticles, ShaderManager& shaderManager)
+    : shaders(shaderManager), capacity(maxParticles) {
+    shader = shaders.AddSource("particle", particleVertexSource, particleFragmentSource);
+
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 实例属性：四段各自紧密排列，段的起点固定，之后不再改属性指针
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(float), nullptr, GL_STREAM_DRAW);
+    for (GLuint k = 0; k < 3; ++k) {
+        glVertexAttribPointer(2 + k, 1, GL_FLOAT, GL_FALSE, 0, (void*)(k * capacity * sizeof(float)));
+        glEnableVertexAttribArray(2 + k);
+        glVertexAttribDivisor(2 + k, 1);
+    }
+    glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)(3 * capacity * sizeof(float)));
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+    glBindVertexArray(0);
+}
+
+ParticleLayer::~ParticleLayer() {
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void ParticleLayer::Draw(RenderQueue& queue, const ParticleSystem& particles, double cameraX, double cameraY, float cellSize) {
+    uploadedBytes = 0;
+    size_t n = std::min(particles.Size(), capacity);
+    GLuint program = shaders.Program(shader);
+    if (n == 0 || !program) return;
+    if (program != cachedProgram) {
+        // 位置只在换了程序时查询一次
+        cameraLoc = shaders.Uniform(shader, "camera");
+        scaleLoc = shaders.Uniform(shader, "cellScale");
+        cachedProgram = program;
+    }
+
+    // 孤立旧存储，避免等待上一帧的绘制；RenderQueue::Submit 会作废缓存里的 GL_ARRAY_BUFFER 绑定
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(float), nullptr, GL_STREAM_DRAW);
+    size_t bytes = n * sizeof(float);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, particles.X());
+    glBufferSubData(GL_ARRAY_BUFFER, capacity * sizeof(float), bytes, particles.Y());
+    glBufferSubData(GL_ARRAY_BUFFER, 2 * capacity * sizeof(float), bytes, particles.Life());
+    glBufferSubData(GL_ARRAY_BUFFER, 3 * capacity * sizeof(float), bytes, particles.Color());
+    uploadedBytes = 4 * bytes;
+
+    RenderCommand& c = queue.Add(PASS_PARTICLES);
+    c.program = program;
+    c.vao = VAO;
+    c.count = 6;
+    c.instances = (GLsizei)n;
+    c.SetVec2(cameraLoc, (float)cameraX, (float)cameraY);
+    c.SetFloat(scaleLoc, cellSize);
+}
@@ -0,0 +1,33 @@
+// ParticleLayer.h
+#pragma once
+#include <glad/glad.h>
+#include "RenderQueue.h"
+#include "ShaderManager.h"
+
+class ParticleSystem;
+
+// 粒子的绘制：所有粒子一次实例化绘制，四边形顶点与 SpriteBatch 共用
+// 实例缓冲与 ParticleSystem 一样按属性分段：[x 数组][y 数组][life 数组][color 数组]，
+// 每段的起点由容量决定，属性指针在创建时设好，每帧只需把四个数组各拷一次，不用再拼成结构体
+// 容量须不小于 ParticleSystem 的容量
+class ParticleLayer {
+public:
+    // quadVBO 为 6 个顶点的四边形（aPos.xy, aTexCoord.xy）
+    // 着色器登记到 shaders 里，须在 shaders.Submit() 之前构造；程序在 Finish 之后才能用，之前的 Draw 什么也不画
+    ParticleLayer(GLuint quadVBO, size_t capacity, ShaderManager& shaders);
+    ~ParticleLayer();
+
+    // 相机中心 (cameraX, cameraY) 以格为单位，cellSize 为每格的 NDC 尺寸
+    // 上传本帧的粒子，往队列里放一条命令（PASS_PARTICLES）；没有粒子时什么也不做
+    void Draw(RenderQueue& queue, const ParticleSystem& particles, double cameraX, double cameraY, float cellSize);
+
+    size_t UploadedBytes() const { return uploadedBytes; }
+
+private:
+    ShaderManager& shaders;
+    ShaderManager::Handle shader;
+    GLuint cachedProgram = 0, VAO, instanceVBO;
+    GLint cameraLoc = -1, scaleLoc = -1;
+    size_t capacity;
+    size_t uploadedBytes = 0;
+};
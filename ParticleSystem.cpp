@@ -0,0 +1,216 @@
+#include "ParticleSystem.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SNAKE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SNAKE_TARGET_AVX2
+#else
+#define SNAKE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+static const size_t kLanes = 8;
+
+// 一步积分的参数，三种实现共用
+struct Step {
+    float dt, damp, gdt;
+};
+
+// 每个粒子：v *= damp，vy -= g * dt，p += v * dt，life -= fade * dt
+static void IntegrateScalar(const Step& s, float* x, float* y, float* vx, float* vy, float* life, const float* fade, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        float nvx = vx[i] * s.damp;
+        float nvy = vy[i] * s.damp - s.gdt;
+        vx[i] = nvx;
+        vy[i] = nvy;
+        x[i] = x[i] + nvx * s.dt;
+        y[i] = y[i] + nvy * s.dt;
+        life[i] = life[i] - fade[i] * s.dt;
+    }
+}
+
+static size_t NextDeadScalar(const float* life, size_t i, size_t n) {
+    while (i < n && life[i] > 0.0f) ++i;
+    return i;
+}
+
+#ifdef SNAKE_X86
+
+// 最低的置位，v 不为 0
+static inline int LowestBit(unsigned v) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctz(v);
+#endif
+}
+
+// 数组长度是 8 的倍数，最后不满的一组照样整组处理
+static void IntegrateSse2(const Step& s, float* x, float* y, float* vx, float* vy, float* life, const float* fade, size_t n) {
+    const __m128 dt = _mm_set1_ps(s.dt), damp = _mm_set1_ps(s.damp), gdt = _mm_set1_ps(s.gdt);
+    for (size_t i = 0; i < n; i += 4) {
+        __m128 nvx = _mm_mul_ps(_mm_loadu_ps(vx + i), damp);
+        __m128 nvy = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), damp), gdt);
+        _mm_storeu_ps(vx + i, nvx);
+        _mm_storeu_ps(vy + i, nvy);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(nvx, dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(nvy, dt)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), _mm_mul_ps(_mm_loadu_ps(fade + i), dt)));
+    }
+}
+
+// 一次比较 4 个，全活着的整组跳过
+static size_t NextDeadSse2(const float* life, size_t i, size_t n) {
+    const __m128 zero = _mm_setzero_ps();
+    while (i + 4 <= n) {
+        int dead = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(life + i), zero));
+        if (dead) return i + LowestBit((unsigned)dead);
+        i += 4;
+    }
+    return NextDeadScalar(life, i, n);
+}
+
+SNAKE_TARGET_AVX2 static void IntegrateAvx2(const Step& s, float* x, float* y, float* vx, float* vy, float* life, const float* fade, size_t n) {
+    const __m256 dt = _mm256_set1_ps(s.dt), damp = _mm256_set1_ps(s.damp), gdt = _mm256_set1_ps(s.gdt);
+    for (size_t i = 0; i < n; i += 8) {
+        __m256 nvx = _mm256_mul_ps(_mm256_loadu_ps(vx + i), damp);
+        __m256 nvy = _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(vy + i), damp), gdt);
+        _mm256_storeu_ps(vx + i, nvx);
+        _mm256_storeu_ps(vy + i, nvy);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(nvx, dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(nvy, dt)));
+        _mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), _mm256_mul_ps(_mm256_loadu_ps(fade + i), dt)));
+    }
+    _mm256_zeroupper();
+}
+
+SNAKE_TARGET_AVX2 static size_t NextDeadAvx2(const float* life, size_t i, size_t n) {
+    const __m256 zero = _mm256_setzero_ps();
+    size_t found = n;
+    while (i + 8 <= n) {
+        int dead = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(life + i), zero, _CMP_LE_OQ));
+        if (dead) {
+            found = i + LowestBit((unsigned)dead);
+            break;
+        }
+        i += 8;
+    }
+    _mm256_zeroupper();
+    return found < n ? found : NextDeadScalar(life, i, n);
+}
+
+#endif
+
+ParticleSystem::Isa ParticleSystem::BestIsa() {
+#ifdef SNAKE_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        bool osSaves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        if (osSaves && (info[1] & (1 << 5)) != 0) return AVX2;
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return AVX2;
+#endif
+    return SSE2;
+#else
+    return SCALAR;
+#endif
+}
+
+ParticleSystem::ParticleSystem(size_t maxParticles)
+    : capacity(maxParticles), rng(0x5eed), isa(BestIsa()) {
+    size_t padded = (capacity + kLanes - 1) / kLanes * kLanes;
+    for (std::vector<float>* a : { &x, &y, &vx, &vy, &life, &fade }) a->assign(padded, 0.0f);
+    color.assign(padded, 0);
+}
+
+void ParticleSystem::SetIsa(Isa requested) {
+    isa = requested < BestIsa() ? requested : BestIsa();
+}
+
+void ParticleSystem::Emit(const Burst& b) {
+    const float kTwoPi = 6.28318531f;
+    // [0, 1) 的均匀分布，取高 24 位
+    auto uniform = [this] { return (float)(rng.Next() >> 40) * (1.0f / 16777216.0f); };
+    for (int k = 0; k < b.count; ++k) {
+        if (count == capacity) {
+            dropped += (unsigned long long)(b.count - k);
+            return;
+        }
+        float angle = uniform() * kTwoPi;
+        float speed = b.speed * (0.3f + 0.7f * uniform());
+        float seconds = b.life * (0.5f + 0.5f * uniform());
+        size_t i = count++;
+        x[i] = b.x;
+        y[i] = b.y;
+        vx[i] = std::cos(angle) * speed;
+        vy[i] = std::sin(angle) * speed;
+        life[i] = 1.0f;
+        fade[i] = 1.0f / seconds;
+        color[i] = b.color;
+    }
+}
+
+void ParticleSystem::Integrate(float dt) {
+    Step s;
+    s.dt = dt;
+    s.damp = std::max(1.0f - drag * dt, 0.0f);
+    s.gdt = gravity * dt;
+    size_t n = (count + kLanes - 1) / kLanes * kLanes;
+    switch (isa) {
+#ifdef SNAKE_X86
+    case AVX2: IntegrateAvx2(s, x.data(), y.data(), vx.data(), vy.data(), life.data(), fade.data(), n); break;
+    case SSE2: IntegrateSse2(s, x.data(), y.data(), vx.data(), vy.data(), life.data(), fade.data(), n); break;
+#endif
+    default: IntegrateScalar(s, x.data(), y.data(), vx.data(), vy.data(), life.data(), fade.data(), count); break;
+    }
+}
+
+void ParticleSystem::Remove(size_t i, size_t last) {
+    x[i] = x[last];
+    y[i] = y[last];
+    vx[i] = vx[last];
+    vy[i] = vy[last];
+    life[i] = life[last];
+    fade[i] = fade[last];
+    color[i] = color[last];
+}
+
+// 找到死掉的粒子就用末尾活着的粒子填上；末尾死掉的直接截掉
+void ParticleSystem::Compact() {
+    size_t n = count, i = 0;
+    for (;;) {
+        switch (isa) {
+#ifdef SNAKE_X86
+        case AVX2: i = NextDeadAvx2(life.data(), i, n); break;
+        case SSE2: i = NextDeadSse2(life.data(), i, n); break;
+#endif
+        default: i = NextDeadScalar(life.data(), i, n); break;
+        }
+        if (i >= n) break;
+        while (n > i + 1 && !(life[n - 1] > 0.0f)) --n;
+        --n;
+        if (n != i) Remove(i, n);
+        ++i;
+    }
+    count = n;
+    // 最后一组里多出来的几格也会被积分，速度清零，免得一直衰减成非规格化数拖慢 SIMD
+    size_t padded = (count + kLanes - 1) / kLanes * kLanes;
+    for (size_t k = count; k < padded; ++k) vx[k] = vy[k] = fade[k] = 0.0f;
+}
+
+void ParticleSystem::Update(float dt) {
+    Integrate(dt);
+    Compact();
+}
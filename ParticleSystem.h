@@ -0,0 +1,68 @@
+// ParticleSystem.h
+#pragma once
+#include "Rng.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 粒子特效（吃到食物、撞墙）：结构数组存放，每个属性一个连续的 float 数组
+// 更新一次处理 8 个（AVX2）、4 个（SSE2）或 1 个粒子，三者的浮点运算顺序一致，结果逐位相同
+// 位置和速度以格为单位；life 从 1 线性减到 0，渲染时同时用作透明度和缩放
+// 死掉的粒子用末尾的粒子填上（swap-remove），数组始终紧凑，粒子的顺序会变
+// 容量在构造时一次分配，之后不再分配内存；装不下的粒子直接丢掉
+class ParticleSystem {
+public:
+    enum Isa { SCALAR, SSE2, AVX2 };
+
+    // 从一点向四周炸开的一团粒子
+    struct Burst {
+        float x, y;
+        int count;
+        float speed;        // 初速度上限，格/秒
+        float life;         // 寿命上限，秒
+        uint32_t color;     // RGBA8，R 在最低字节
+    };
+
+    explicit ParticleSystem(size_t capacity);
+
+    void Emit(const Burst& burst);
+    // 积分位置与速度、减少寿命，然后移除死掉的粒子
+    void Update(float dt);
+    void Clear() { count = 0; }
+
+    // 重力向 -y，阻力按 v *= 1 - drag * dt
+    void SetGravity(float g) { gravity = g; }
+    void SetDrag(float d) { drag = d; }
+    void Seed(uint64_t seed) { rng.Seed(seed); }
+
+    size_t Size() const { return count; }
+    size_t Capacity() const { return capacity; }
+    unsigned long long Dropped() const { return dropped; }
+
+    // 前 Size() 个有效，可以直接上传成顶点属性
+    const float* X() const { return x.data(); }
+    const float* Y() const { return y.data(); }
+    const float* Life() const { return life.data(); }
+    const uint32_t* Color() const { return color.data(); }
+
+    // 本机支持的最快实现；SetIsa 不能超过它
+    static Isa BestIsa();
+    void SetIsa(Isa isa);
+    Isa GetIsa() const { return isa; }
+
+    // 只做积分、不移除，基准测试用来单独计时
+    void Integrate(float dt);
+    void Compact();
+
+private:
+    void Remove(size_t i, size_t last);
+
+    size_t capacity, count = 0;
+    // 数组长度向上取整到 8 的倍数，SIMD 处理最后不满的一组时不会越界
+    std::vector<float> x, y, vx, vy, life, fade;
+    std::vector<uint32_t> color;
+    float gravity = 6.0f, drag = 1.5f;
+    Rng rng;
+    Isa isa;
+    unsigned long long dropped = 0;
+};
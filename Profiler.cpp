@@ -0,0 +1,143 @@
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Profiler {
+
+namespace {
+
+const size_t kRingSize = 1 << 16;
+
+// 单写者环形缓冲：只有所属线程写 events 和 written，导出线程只读
+struct ThreadRing {
+    Event events[kRingSize];
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<bool> inUse{ true };
+    const char* name = "thread";
+    unsigned id = 0;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadRing>> registry;
+
+// 线程退出时把缓冲还回去，记录保留到被下一个线程覆盖，逻辑线程每局重建也不会越占越多
+struct RingHandle {
+    ThreadRing* ring = nullptr;
+    ~RingHandle() {
+        if (ring) ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+ThreadRing* AcquireRing() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& ring : registry) {
+        if (!ring->inUse.load(std::memory_order_acquire)) {
+            ring->inUse.store(true, std::memory_order_relaxed);
+            ring->name = "thread";
+            return ring.get();
+        }
+    }
+    registry.emplace_back(new ThreadRing());
+    registry.back()->id = (unsigned)registry.size();
+    return registry.back().get();
+}
+
+// 第一次记录时才注册，之后只是一次 thread_local 读取
+ThreadRing& LocalRing() {
+    thread_local RingHandle handle;
+    if (!handle.ring) handle.ring = AcquireRing();
+    return *handle.ring;
+}
+
+void Push(const Event& e) {
+    ThreadRing& ring = LocalRing();
+    uint64_t n = ring.written.load(std::memory_order_relaxed);
+    ring.events[n & (kRingSize - 1)] = e;
+    ring.written.store(n + 1, std::memory_order_release);
+}
+
+void WriteEscaped(FILE* f, const char* s) {
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') std::fputc('\\', f);
+        std::fputc(*s, f);
+    }
+}
+
+}
+
+uint64_t NowNs() {
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point origin = Clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin).count();
+}
+
+void RecordZone(const char* name, uint64_t start, uint64_t end) {
+    Push({ name, start, end - start, 0.0, ZONE });
+}
+
+void RecordCounter(const char* name, double value) {
+    Push({ name, NowNs(), 0, value, COUNTER });
+}
+
+void RecordGpuZone(const char* name, uint64_t start, uint64_t duration) {
+    Push({ name, start, duration, 0.0, GPU_ZONE });
+}
+
+void SetThreadName(const char* name) {
+    LocalRing().name = name;
+}
+
+bool WriteChromeTrace(const char* path) {
+    FILE* f = std::fopen(path, "w");
+    if (!f) return false;
+    std::fputs("{\"traceEvents\":[\n", f);
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) std::fputs(",\n", f);
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& ring : registry) {
+        // GPU 区间单独放在一条轨道上
+        const unsigned gpuTid = 1000 + ring->id;
+        separator();
+        std::fprintf(f, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", ring->id);
+        WriteEscaped(f, ring->name);
+        std::fputs("\"}}", f);
+
+        // 写入端可能正在覆盖最旧的一段，留出余量只导出较新的记录
+        uint64_t end = ring->written.load(std::memory_order_acquire);
+        uint64_t keep = kRingSize - kRingSize / 8;
+        uint64_t begin = end > keep ? end - keep : 0;
+        bool gpuTrack = false;
+        for (uint64_t i = begin; i < end; ++i) {
+            const Event& e = ring->events[i & (kRingSize - 1)];
+            separator();
+            std::fputs("{\"name\":\"", f);
+            WriteEscaped(f, e.name);
+            if (e.type == COUNTER) {
+                std::fprintf(f, "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%g}}",
+                    e.start / 1000.0, ring->id, e.value);
+            }
+            else {
+                unsigned tid = e.type == GPU_ZONE ? gpuTid : ring->id;
+                gpuTrack = gpuTrack || e.type == GPU_ZONE;
+                std::fprintf(f, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                    e.start / 1000.0, e.duration / 1000.0, tid);
+            }
+        }
+        if (gpuTrack) {
+            separator();
+            std::fprintf(f, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}", gpuTid);
+        }
+    }
+    std::fputs("\n]}\n", f);
+    return std::fclose(f) == 0;
+}
+
+}
@@ -0,0 +1,53 @@
+// Profiler.h
+#pragma once
+#include <cstdint>
+
+// 进程内的帧分析器
+// CPU 区间和计数写进每个线程自己的环形缓冲，写入端无锁、不分配内存，写满后覆盖最旧的
+// GPU 区间由 GpuProfiler 在结果可读之后补写进来
+// WriteChromeTrace 把所有线程的记录导出为 Chrome trace JSON，用 chrome://tracing 或 Perfetto 打开
+// 只有定义了 SNAKE_PROFILE（CMake 选项）时下面的宏才展开，否则调用点在编译期消失
+namespace Profiler {
+    enum EventType : uint8_t { ZONE, COUNTER, GPU_ZONE };
+
+    struct Event {
+        const char* name;       // 必须是字符串字面量，只存指针
+        uint64_t start;         // NowNs()
+        uint64_t duration;
+        double value;           // COUNTER 的值
+        EventType type;
+    };
+
+    uint64_t NowNs();
+    void RecordZone(const char* name, uint64_t start, uint64_t end);
+    void RecordCounter(const char* name, double value);
+    void RecordGpuZone(const char* name, uint64_t start, uint64_t duration);
+    // 导出时作为线程名显示
+    void SetThreadName(const char* name);
+    bool WriteChromeTrace(const char* path);
+
+    class ScopedZone {
+    public:
+        explicit ScopedZone(const char* zoneName) : name(zoneName), start(NowNs()) {}
+        ~ScopedZone() { RecordZone(name, start, NowNs()); }
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+    private:
+        const char* name;
+        uint64_t start;
+    };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef SNAKE_PROFILE
+#define PROFILE_ZONE(name) Profiler::ScopedZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_COUNTER(name, value) Profiler::RecordCounter(name, (double)(value))
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
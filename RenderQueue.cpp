@@ -0,0 +1,122 @@
+#include "RenderQueue.h"
+
+static UniformValue& NextUniform(RenderCommand& c, GLint location, UniformType type) {
+    // 超出 kMaxUniforms 时覆盖最后一个，调用方保证不会用到这么多
+    UniformValue& u = c.uniforms[c.uniformCount < RenderCommand::kMaxUniforms ? c.uniformCount++ : RenderCommand::kMaxUniforms - 1];
+    u.location = location;
+    u.type = type;
+    return u;
+}
+
+void RenderCommand::SetInt(GLint location, GLint v) {
+    UniformValue& u = NextUniform(*this, location, UNIFORM_INT);
+    u.f[1] = u.f[2] = u.f[3] = 0.0f;
+    u.i = v;
+}
+
+void RenderCommand::SetFloat(GLint location, float x) {
+    UniformValue& u = NextUniform(*this, location, UNIFORM_FLOAT);
+    u.f[0] = x;
+    u.f[1] = u.f[2] = u.f[3] = 0.0f;
+}
+
+void RenderCommand::SetVec2(GLint location, float x, float y) {
+    UniformValue& u = NextUniform(*this, location, UNIFORM_VEC2);
+    u.f[0] = x;
+    u.f[1] = y;
+    u.f[2] = u.f[3] = 0.0f;
+}
+
+void RenderCommand::SetVec3(GLint location, float x, float y, float z) {
+    UniformValue& u = NextUniform(*this, location, UNIFORM_VEC3);
+    u.f[0] = x;
+    u.f[1] = y;
+    u.f[2] = z;
+    u.f[3] = 0.0f;
+}
+
+void RenderCommand::SetVec4(GLint location, float x, float y, float z, float w) {
+    UniformValue& u = NextUniform(*this, location, UNIFORM_VEC4);
+    u.f[0] = x;
+    u.f[1] = y;
+    u.f[2] = z;
+    u.f[3] = w;
+}
+
+RenderCommand& RenderQueue::Add(RenderPass pass) {
+    if (commands.size() >= kMaxCommands) {
+        dropped++;
+        overflow = RenderCommand();
+        return overflow;
+    }
+    commands.emplace_back();
+    commands.back().pass = pass;
+    return commands.back();
+}
+
+uint64_t RenderQueue::SortKey(const RenderCommand& c, uint32_t sequence) {
+    return ((uint64_t)(c.pass & 0xF) << 60) |
+        ((uint64_t)(c.program & 0xFFF) << 48) |
+        ((uint64_t)(c.texture & 0xFFFF) << 32) |
+        ((uint64_t)(c.vao & 0xFFF) << 20) |
+        (sequence & 0xFFFFF);
+}
+
+// 低位优先的基数排序，每趟 8 位；先一遍统计 8 个字节的直方图，所有键在某个字节上都相同时跳过那一趟
+// 一帧的命令通常只有几种状态，实际只需要两三趟
+void RenderQueue::RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch) {
+    size_t n = keys.size();
+    if (n < 2) return;
+    static const int kPasses = 8;
+    uint32_t counts[kPasses * 256] = {};   // 8 KB，放在栈上，每帧不分配
+    for (uint64_t k : keys)
+        for (int p = 0; p < kPasses; ++p) counts[p * 256 + ((k >> (p * 8)) & 0xFF)]++;
+    scratch.resize(n);
+    for (int p = 0; p < kPasses; ++p) {
+        uint32_t* c = &counts[p * 256];
+        if (c[(keys[0] >> (p * 8)) & 0xFF] == n) continue;
+        uint32_t sum = 0;
+        for (int b = 0; b < 256; ++b) {
+            uint32_t v = c[b];
+            c[b] = sum;
+            sum += v;
+        }
+        for (uint64_t k : keys) scratch[c[(k >> (p * 8)) & 0xFF]++] = k;
+        keys.swap(scratch);
+    }
+}
+
+void RenderQueue::Submit(GlStateCache& cache, PassCallback onPass, void* user) {
+    keys.resize(commands.size());
+    for (size_t i = 0; i < commands.size(); ++i) keys[i] = SortKey(commands[i], (uint32_t)i);
+    RadixSort(keys, scratch);
+
+    // 实例数据是刚刚直接绑缓冲上传的，缓存里的 GL_ARRAY_BUFFER 已经不可信
+    cache.InvalidateArrayBuffer();
+    cache.CountCommands((unsigned)commands.size());
+    RenderPass current = PASS_COUNT;
+    for (uint64_t key : keys) {
+        const RenderCommand& c = commands[key & 0xFFFFF];
+        if (onPass && c.pass != current) {
+            current = c.pass;
+            onPass(user, current);
+        }
+        cache.UseProgram(c.program);
+        cache.BindVertexArray(c.vao);
+        if (c.texture) cache.BindTexture(c.textureTarget, c.texture);
+        cache.SetEnabled(GL_DEPTH_TEST, c.depthTest);
+        if (c.lineWidth > 0.0f) cache.LineWidth(c.lineWidth);
+        for (int u = 0; u < c.uniformCount; ++u) cache.Uniform(c.uniforms[u]);
+        if (c.instanceBuffer) {
+            cache.BindArrayBuffer(c.instanceBuffer);
+            size_t offset = c.instanceOffset;
+            for (int a = 0; a < 2 && c.instanceAttribs[a]; ++a) {
+                cache.AttribPointer(2 + a, c.instanceAttribs[a], c.instanceStride, offset);
+                offset += c.instanceAttribs[a] * sizeof(float);
+            }
+        }
+        cache.Draw(c.mode, c.first, c.count, c.instances);
+    }
+    if (onPass && current != PASS_COUNT) onPass(user, PASS_COUNT);
+    commands.clear();
+}
@@ -0,0 +1,71 @@
+// RenderQueue.h
+#pragma once
+#include "GlStateCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 画的先后：同一遍内按状态排序，遍与遍之间保持这个顺序
+// 粒子盖在蛇和墙上面、边框下面；层次只由遍决定，与 GL 对象名无关
+enum RenderPass : uint8_t { PASS_SPRITES, PASS_WALLS, PASS_PARTICLES, PASS_OVERLAY, PASS_COUNT };
+
+// 一次绘制需要的全部状态
+struct RenderCommand {
+    static const int kMaxUniforms = 4;
+
+    RenderPass pass = PASS_SPRITES;
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint texture = 0;                 // 0 表示不绑纹理
+    GLenum textureTarget = GL_TEXTURE_2D;
+    GLenum mode = GL_TRIANGLES;
+    GLint first = 0;
+    GLsizei count = 0;
+    GLsizei instances = 0;              // 0 表示非实例化
+    // 逐实例属性：从 location 2 起依次排列，各占 instanceAttribs[k] 个 float
+    GLuint instanceBuffer = 0;          // 0 表示没有
+    size_t instanceOffset = 0;
+    GLsizei instanceStride = 0;
+    uint8_t instanceAttribs[2] = { 0, 0 };
+    bool depthTest = false;
+    float lineWidth = 0.0f;             // 0 表示不改
+    int uniformCount = 0;
+    UniformValue uniforms[kMaxUniforms];
+
+    void SetInt(GLint location, GLint v);
+    void SetFloat(GLint location, float x);
+    void SetVec2(GLint location, float x, float y);
+    void SetVec3(GLint location, float x, float y, float z);
+    void SetVec4(GLint location, float x, float y, float z, float w);
+};
+
+// 渲染命令队列：一帧的绘制先记下来，Submit 时按 64 位排序键基数排序，再经 GlStateCache 提交
+// 排序键从高到低：遍(4) | 程序(12) | 纹理(16) | VAO(12) | 序号(20)
+// 状态相同的命令挨在一起，只有第一条需要切换状态；序号保证状态相同的命令仍按添加顺序画
+// GL 对象名只取低位，撞上了只是少合并一次，不影响正确性
+class RenderQueue {
+public:
+    static const size_t kMaxCommands = 1 << 20;
+
+    // 提交时每进入新的一遍调用一次，全部画完后再以 PASS_COUNT 调用一次；GlRenderer 用它给每一遍单独计时
+    typedef void (*PassCallback)(void* user, RenderPass pass);
+
+    // 返回的引用在下一次 Add 之前有效；超过 kMaxCommands 的命令被丢弃
+    RenderCommand& Add(RenderPass pass);
+    void Submit(GlStateCache& cache, PassCallback onPass = nullptr, void* user = nullptr);
+    void Clear() { commands.clear(); }
+
+    size_t Size() const { return commands.size(); }
+    unsigned Dropped() const { return dropped; }
+
+    static uint64_t SortKey(const RenderCommand& c, uint32_t sequence);
+    // 64 位键的基数排序，scratch 为同样大小的临时空间
+    static void RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch);
+
+private:
+
+    std::vector<RenderCommand> commands;
+    std::vector<uint64_t> keys, scratch;
+    RenderCommand overflow;
+    unsigned dropped = 0;
+};
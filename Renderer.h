@@ -0,0 +1,25 @@
+// Renderer.h
+#pragma once
+#include "Sprite.h"
+
+// 渲染后端接口：GlRenderer 走 OpenGL，SoftRasterizer 在 CPU 上画同样的画面（无显卡的机器、黄金图像比对）
+//   精灵：以 (x, y) 为中心、按 angle 旋转的四边形，纹理取自精灵数组纹理的 layer 层，或者用纯色；alpha 混合
+//   边框：MapBorder 的白色线框，范围在创建后端时给定
+// 每帧的调用顺序：BeginFrame，若干 AddSprite，Flush，DrawBorder，EndFrame
+// 后端可以把绘制攒到 EndFrame 再一起提交（GlRenderer 按材质合批、按状态排序），只保证：
+//   边框画在全部精灵之上；同一材质（同一纹理，或同为纯色）的精灵按 AddSprite 的顺序画
+//   材质不同、互相重叠的半透明精灵谁盖谁不确定，需要固定层次的内容不要靠调用顺序
+class Renderer {
+public:
+    virtual ~Renderer() = default;
+
+    // 用背景色清屏，开始新的一帧
+    virtual void BeginFrame(float r, float g, float b) = 0;
+    // textured 为 false 时使用 instance 的颜色
+    virtual void AddSprite(bool textured, const SpriteInstance& instance) = 0;
+    // 结束本帧精灵的添加，每帧调用一次
+    virtual void Flush() = 0;
+    virtual void DrawBorder() = 0;
+    // 本帧的绘制全部落到帧缓冲上，交换缓冲或读取画面之前调用
+    virtual void EndFrame() = 0;
+};
@@ -0,0 +1,126 @@
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+
+static const char kMagic[4] = { 'S', 'N', 'K', 'R' };
+static const uint8_t kVersion = 1;
+static const unsigned kEndCode = 4;
+
+static const Vec2i kDirs[4] = { { 0, 1 }, { 0, -1 }, { -1, 0 }, { 1, 0 } };
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static int DirCode(Vec2i dir) {
+    for (int i = 0; i < 4; ++i)
+        if (kDirs[i] == dir) return i;
+    return -1;
+}
+
+void ReplayWriter::Begin(const SnakeSim& sim) {
+    bytes.clear();
+    for (char c : kMagic) bytes.push_back((uint8_t)c);
+    bytes.push_back(kVersion);
+    PutVarint(bytes, (uint64_t)sim.Width());
+    PutVarint(bytes, (uint64_t)sim.Height());
+    PutVarint(bytes, sim.Seed());
+    lastTick = sim.Tick();
+}
+
+void ReplayWriter::Record(unsigned long long tick, Vec2i dir) {
+    int code = DirCode(dir);
+    if (code < 0) return;
+    PutVarint(bytes, ((tick - lastTick) << 3) | (uint64_t)code);
+    lastTick = tick;
+}
+
+void ReplayWriter::Finish(const SnakeSim& sim) {
+    PutVarint(bytes, kEndCode);
+    PutVarint(bytes, sim.Tick());
+    PutVarint(bytes, sim.Body().Size());
+    bytes.push_back((uint8_t)sim.Death());
+}
+
+bool ReplayWriter::Save(const char* path) const {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool ReplayPlayer::Open(const uint8_t* data, size_t size) {
+    const uint8_t* p = data;
+    end = data + size;
+    if (size < 5 || std::memcmp(p, kMagic, 4) != 0 || p[4] != kVersion) return false;
+    p += 5;
+
+    uint64_t width, height, seed;
+    if (!GetVarint(p, end, width) || !GetVarint(p, end, height) || !GetVarint(p, end, seed)) return false;
+    if (width < 3 || height < 3 || width > SnakeSim::kMaxArena || height > SnakeSim::kMaxArena) return false;
+
+    // 先找到结束标记读出记录的结果，事件部分在模拟时再逐个解码
+    const uint8_t* events = p;
+    uint64_t v;
+    for (;;) {
+        if (!GetVarint(p, end, v)) return false;
+        if ((v & 7) == kEndCode) break;
+        if ((v & 7) > kEndCode) return false;
+    }
+    uint64_t ticks, length;
+    if (!GetVarint(p, end, ticks) || !GetVarint(p, end, length) || p >= end) return false;
+    recorded.ticks = ticks;
+    recorded.length = length;
+    recorded.death = (DeathCause)*p;
+
+    if (!sim || sim->Width() != (int)width || sim->Height() != (int)height)
+        sim.reset(new SnakeSim((int)width, (int)height, seed));
+    sim->Reset(seed);
+
+    // 第 t 个 tick 之前压入的按键都带着 tick = t
+    cursor = events;
+    GetVarint(cursor, end, event);
+    nextTick = event >> 3;
+    return true;
+}
+
+bool ReplayPlayer::Step() {
+    if (!sim->Alive() || sim->Tick() >= recorded.ticks) return false;
+    while ((event & 7) != kEndCode && nextTick == sim->Tick()) {
+        sim->QueueDirection(kDirs[event & 7]);
+        GetVarint(cursor, end, event);
+        nextTick += event >> 3;
+    }
+    sim->Step();
+    return true;
+}
+
+ReplayResult ReplayPlayer::Verify(const uint8_t* data, size_t size) {
+    ReplayResult result;
+    if (!Open(data, size)) return result;
+    result.valid = true;
+    result.recorded = recorded;
+    while (Step()) {}
+
+    result.simulated.ticks = sim->Tick();
+    result.simulated.length = sim->Body().Size();
+    result.simulated.death = sim->Death();
+    result.matches = result.simulated.ticks == result.recorded.ticks &&
+        result.simulated.length == result.recorded.length &&
+        result.simulated.death == result.recorded.death;
+    return result;
+}
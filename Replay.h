@@ -0,0 +1,63 @@
+// Replay.h
+#pragma once
+#include "SnakeSim.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// 录像格式（.snkr）：
+//   "SNKR" | 版本(1 字节) | varint 宽 | varint 高 | varint 种子
+//   事件：varint((距上个事件的 tick 数 << 3) | 方向码)，方向码 0~3 为上下左右
+//   结束：varint(4) | varint 总 tick 数 | varint 蛇长 | 死因(1 字节)
+// 只记录种子和被压进按键队列的方向，其余全部由重新模拟得到
+
+struct ReplaySummary {
+    unsigned long long ticks = 0;
+    unsigned long long length = 0;
+    DeathCause death = ALIVE;
+};
+
+class ReplayWriter {
+public:
+    // 在 sim.Reset(seed) 之后调用
+    void Begin(const SnakeSim& sim);
+    // QueueDirection 返回 true 时调用，tick 为当时的 sim.Tick()
+    void Record(unsigned long long tick, Vec2i dir);
+    void Finish(const SnakeSim& sim);
+
+    bool Save(const char* path) const;
+    const std::vector<uint8_t>& Bytes() const { return bytes; }
+
+private:
+    std::vector<uint8_t> bytes;
+    unsigned long long lastTick = 0;
+};
+
+struct ReplayResult {
+    bool valid = false;         // 文件格式正确
+    bool matches = false;       // 重新模拟的结果与记录一致
+    ReplaySummary recorded;
+    ReplaySummary simulated;
+};
+
+// 无窗口重放；棋盘尺寸不变时复用同一个 SnakeSim，不再分配内存
+// 逐 tick 重放：Open 之后反复 Step，每步之后 Sim() 就是录像里那个 tick 的状态（渲染录像用）
+class ReplayPlayer {
+public:
+    ReplayResult Verify(const uint8_t* data, size_t size);
+
+    // 文件格式不对时返回 false；data 在重放结束前必须有效
+    bool Open(const uint8_t* data, size_t size);
+    // 前进一个 tick，已到录像结尾或蛇已死亡时返回 false
+    bool Step();
+    const SnakeSim& Sim() const { return *sim; }
+    const ReplaySummary& Recorded() const { return recorded; }
+
+private:
+    std::unique_ptr<SnakeSim> sim;
+    ReplaySummary recorded;
+    const uint8_t* cursor = nullptr;
+    const uint8_t* end = nullptr;
+    uint64_t event = 0;
+    unsigned long long nextTick = 0;
+};
@@ -0,0 +1,26 @@
+// Rng.h
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// 可复现的伪随机数（SplitMix64），同一个种子在任何平台上给出同样的序列
+class Rng {
+public:
+    explicit Rng(uint64_t seed = 0) : state(seed) {}
+
+    void Seed(uint64_t seed) { state = seed; }
+    uint64_t State() const { return state; }
+
+    uint64_t Next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, n) 内的整数，n 远小于 2^53 时偏差可以忽略
+    size_t Below(size_t n) { return (size_t)((Next() >> 11) % n); }
+
+private:
+    uint64_t state;
+};
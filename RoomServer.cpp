@@ -0,0 +1,361 @@
+#include "RoomServer.h"
+#include "SimThread.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+using namespace Net;
+
+// 每个房间一组发送缓冲，线程池里各房间各用各的
+struct RoomServer::Outgoing {
+    std::vector<uint8_t> buffers;
+    std::vector<mmsghdr> msgs;
+    std::vector<iovec> iov;
+
+    void Resize(size_t n) {
+        if (msgs.size() >= n) return;
+        buffers.resize(n * kMaxPacket);
+        msgs.resize(n);
+        iov.resize(n);
+    }
+};
+
+static bool SameAddress(const sockaddr_in& a, const sockaddr_in& b) {
+    return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+static uint64_t JoinKey(uint32_t nonce, const sockaddr_in& from) {
+    return ((uint64_t)nonce << 32) ^ ((uint64_t)from.sin_addr.s_addr << 16) ^ from.sin_port;
+}
+
+RoomServer::RoomServer(const ServerConfig& cfg) : config(cfg) {
+    config.rooms = std::max(config.rooms, 1);
+    config.roomSize = std::min(std::max(config.roomSize, 8), ArenaSim::kMaxSize);
+    config.snakesPerRoom = std::min(std::max(config.snakesPerRoom, 1), ArenaSim::kMaxSnakes);
+    config.foodPerRoom = std::min(std::max(config.foodPerRoom, 1), ArenaSim::kMaxFood);
+    config.tickRate = std::min(std::max(config.tickRate, 1.0), 1000.0);
+    pool.reset(new ThreadPool(config.threads));
+    rooms.resize(config.rooms);
+    for (int r = 0; r < config.rooms; ++r) {
+        Room& room = rooms[r];
+        room.sim.reset(new ArenaSim(config.roomSize, config.roomSize, config.foodPerRoom, (uint64_t)r + 1));
+        room.out.reset(new Outgoing());
+        std::memset(room.historySize, 0, sizeof(room.historySize));
+    }
+}
+
+RoomServer::~RoomServer() {
+    for (int fd : { sock, epollFd, timerFd, stopFd })
+        if (fd >= 0) close(fd);
+}
+
+bool RoomServer::Open() {
+    sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        std::perror("socket");
+        return false;
+    }
+    // 一个 tick 的快照是一阵突发，缓冲给大一些；系统上限更小时按上限
+    int buffer = 4 << 20;
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.bindAddress.c_str(), &addr.sin_addr) != 1) {
+        std::fprintf(stderr, "bad bind address %s\n", config.bindAddress.c_str());
+        return false;
+    }
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        std::perror("bind");
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(sock, (sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || timerFd < 0 || stopFd < 0) {
+        std::perror("epoll/timerfd/eventfd");
+        return false;
+    }
+    long long interval = (long long)std::llround(1e9 / config.tickRate);
+    itimerspec spec = {};
+    spec.it_interval.tv_sec = interval / 1000000000;
+    spec.it_interval.tv_nsec = interval % 1000000000;
+    spec.it_value = spec.it_interval;
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+    for (int fd : { sock, timerFd, stopFd }) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    return true;
+}
+
+void RoomServer::Stop() {
+    uint64_t one = 1;
+    if (write(stopFd, &one, sizeof(one)) < 0) {}
+}
+
+void RoomServer::Run() {
+    epoll_event events[4];
+    for (;;) {
+        int n = epoll_wait(epollFd, events, 4, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::perror("epoll_wait");
+            return;
+        }
+        double now = SimThread::Now();
+        bool tick = false;
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == stopFd) {
+                stats.clients = clients.size();
+                return;
+            }
+            if (fd == sock) HandleReadable(now);
+            if (fd == timerFd) {
+                uint64_t expirations = 0;
+                if (read(timerFd, &expirations, sizeof(expirations)) == sizeof(expirations) && expirations > 0) {
+                    // 落后了不补：补出来的 tick 只会让所有人的蛇瞬移
+                    stats.lateTicks += expirations - 1;
+                    tick = true;
+                }
+            }
+        }
+        // 先把这一轮的输入收完再推进
+        if (tick) Tick(now);
+    }
+}
+
+void RoomServer::HandleReadable(double now) {
+    const int kBatch = 64;
+    static thread_local uint8_t buffers[kBatch][kMaxPacket];
+    sockaddr_in from[kBatch];
+    iovec iov[kBatch];
+    mmsghdr msgs[kBatch];
+    for (;;) {
+        for (int i = 0; i < kBatch; ++i) {
+            iov[i] = { buffers[i], kMaxPacket };
+            msgs[i] = {};
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &from[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+        }
+        int n = recvmmsg(sock, msgs, kBatch, MSG_DONTWAIT, nullptr);
+        if (n <= 0) return;
+        for (int i = 0; i < n; ++i) {
+            stats.packetsIn++;
+            stats.bytesIn += msgs[i].msg_len;
+            HandlePacket(buffers[i], msgs[i].msg_len, from[i], now);
+        }
+        if (n < kBatch) return;
+    }
+}
+
+void RoomServer::SendTo(const uint8_t* data, size_t size, const sockaddr_in& to) {
+    if (sendto(sock, data, size, 0, (const sockaddr*)&to, sizeof(to)) == (ssize_t)size) {
+        stats.packetsOut++;
+        stats.bytesOut += size;
+    }
+}
+
+void RoomServer::HandlePacket(const uint8_t* data, size_t size, const sockaddr_in& from, double now) {
+    if (size < 5) return;
+    uint8_t type = data[0];
+    if (type == MSG_JOIN) {
+        uint32_t nonce = GetU32(data + 1);
+        uint64_t key = JoinKey(nonce, from);
+        auto known = joinKeys.find(key);
+        Client* client = nullptr;
+        if (known != joinKeys.end()) {
+            client = &clients[known->second];
+        }
+        else {
+            // 进人最少的、还有空位的房间
+            int best = -1;
+            for (int r = 0; r < (int)rooms.size(); ++r) {
+                int players = rooms[r].sim->Players();
+                if (players < config.snakesPerRoom && (best < 0 || players < rooms[best].sim->Players())) best = r;
+            }
+            int slot = best >= 0 ? rooms[best].sim->Join() : -1;
+            if (slot < 0) {
+                uint8_t reject[5] = { MSG_REJECT };
+                PutU32(reject + 1, nonce);
+                SendTo(reject, sizeof(reject), from);
+                stats.rejects++;
+                return;
+            }
+            uint32_t id = nextClientId++;
+            client = &clients[id];
+            client->id = id;
+            client->addr = from;
+            client->room = best;
+            client->slot = slot;
+            client->lastHeard = now;
+            client->joinKey = key;
+            rooms[best].members.push_back(client);
+            joinKeys[key] = id;
+            stats.joins++;
+        }
+        uint8_t welcome[14] = { MSG_WELCOME };
+        PutU32(welcome + 1, nonce);
+        PutU32(welcome + 5, client->id);
+        PutU16(welcome + 9, (uint16_t)client->room);
+        welcome[11] = (uint8_t)client->slot;
+        welcome[12] = (uint8_t)config.roomSize;
+        welcome[13] = (uint8_t)config.roomSize;
+        SendTo(welcome, sizeof(welcome), from);
+        return;
+    }
+
+    auto it = clients.find(GetU32(data + 1));
+    if (it == clients.end() || !SameAddress(it->second.addr, from)) return;
+    Client& client = it->second;
+    client.lastHeard = now;
+    if (type == MSG_LEAVE) {
+        RemoveClient(client.id);
+        return;
+    }
+    if (type != MSG_INPUT || size < 12) return;
+    ArenaSim& sim = *rooms[client.room].sim;
+    uint32_t ack = GetU32(data + 5);
+    // 乱序到达的旧包可能让基准倒退，只是下一个快照大一点
+    if (ack <= sim.Tick()) client.ackTick = ack;
+    uint16_t seq = GetU16(data + 9);
+    int count = std::min<int>(data[11], kMaxInputs);
+    if (size < 12 + (size_t)count) return;
+    for (int k = 0; k < count; ++k) {
+        uint16_t s = (uint16_t)(seq - (count - 1 - k));
+        if (client.hasSeq && (int16_t)(s - client.lastSeq) <= 0) continue;
+        uint8_t dir = data[12 + k];
+        if (dir < 4) sim.QueueDirection(client.slot, ArenaSim::kDirs[dir]);
+        client.lastSeq = s;
+        client.hasSeq = true;
+    }
+}
+
+void RoomServer::RemoveClient(uint32_t id) {
+    auto it = clients.find(id);
+    if (it == clients.end()) return;
+    Client& client = it->second;
+    Room& room = rooms[client.room];
+    room.sim->Leave(client.slot);
+    auto m = std::find(room.members.begin(), room.members.end(), &client);
+    if (m != room.members.end()) {
+        *m = room.members.back();
+        room.members.pop_back();
+    }
+    joinKeys.erase(client.joinKey);
+    clients.erase(it);
+}
+
+void RoomServer::Tick(double now) {
+    std::vector<uint32_t> expired;
+    for (const auto& c : clients)
+        if (now - c.second.lastHeard > config.clientTimeout) expired.push_back(c.first);
+    for (uint32_t id : expired) RemoveClient(id);
+    stats.timeouts += expired.size();
+
+    double start = SimThread::Now();
+    pool->ParallelFor(rooms.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) TickRoom(rooms[r]);
+    });
+    stats.tickTime.Record(SimThread::Now() - start);
+    stats.ticks++;
+    for (Room& room : rooms) {
+        stats.fullSnapshots += room.fullSnapshots;
+        stats.deltaSnapshots += room.deltaSnapshots;
+        stats.packetsOut += room.packetsOut;
+        stats.bytesOut += room.bytesOut;
+        room.fullSnapshots = room.deltaSnapshots = room.packetsOut = room.bytesOut = 0;
+    }
+}
+
+// 在线程池上运行，只碰这个房间和它的客户端
+void RoomServer::TickRoom(Room& room) {
+    ArenaSim& sim = *room.sim;
+    sim.Step();
+    unsigned long long tick = sim.Tick();
+    int h = (int)(tick % kHistory);
+    room.historySize[h] = (uint8_t)WriteEvents(sim.Events(), sim.Width(), sim.Height(), room.history[h], 255);
+    if (room.members.empty()) return;
+
+    Outgoing& out = *room.out;
+    out.Resize(room.members.size());
+    uint32_t hash = sim.StateHash();
+    for (size_t i = 0; i < room.members.size(); ++i) {
+        Client& client = *room.members[i];
+        uint8_t* packet = &out.buffers[i * kMaxPacket];
+        PutU32(packet + 1, (uint32_t)tick);
+        PutU16(packet + 5, client.lastSeq);
+        PutU32(packet + 7, hash);
+        size_t size = BuildSnapshot(room, client, packet);
+        out.iov[i] = { packet, size };
+        out.msgs[i] = {};
+        out.msgs[i].msg_hdr.msg_iov = &out.iov[i];
+        out.msgs[i].msg_hdr.msg_iovlen = 1;
+        out.msgs[i].msg_hdr.msg_name = &client.addr;
+        out.msgs[i].msg_hdr.msg_namelen = sizeof(client.addr);
+    }
+    // 发送缓冲满了就丢掉这个 tick 剩下的包，客户端下一个 tick 从已确认的基准补上
+    size_t sent = 0;
+    while (sent < room.members.size()) {
+        int n = sendmmsg(sock, &out.msgs[sent], (unsigned)(room.members.size() - sent), 0);
+        if (n <= 0) break;
+        for (int i = 0; i < n; ++i) room.bytesOut += out.msgs[sent + i].msg_len;
+        room.packetsOut += n;
+        sent += n;
+    }
+}
+
+// 客户端确认过的 tick 还在历史里、拼出来放得进一个包就发增量，否则发完整快照
+size_t RoomServer::BuildSnapshot(Room& room, Client& client, uint8_t* packet) {
+    ArenaSim& sim = *room.sim;
+    unsigned long long tick = sim.Tick();
+    if (client.ackTick != 0 && client.ackTick < tick && tick - client.ackTick <= (unsigned long long)kHistory) {
+        size_t size = kDeltaHeader;
+        bool fits = true;
+        for (unsigned long long t = client.ackTick + 1; t <= tick && fits; ++t) {
+            size_t n = room.historySize[t % kHistory];
+            fits = n > 0 && size + 1 + n <= kMaxPacket;
+            size += 1 + n;
+        }
+        if (fits) {
+            packet[0] = MSG_DELTA;
+            PutU32(packet + kSnapshotHeader, client.ackTick);
+            uint8_t* p = packet + kDeltaHeader;
+            for (unsigned long long t = client.ackTick + 1; t <= tick; ++t) {
+                size_t n = room.historySize[t % kHistory];
+                *p++ = (uint8_t)n;
+                std::memcpy(p, room.history[t % kHistory], n);
+                p += n;
+            }
+            room.deltaSnapshots++;
+            return size;
+        }
+    }
+    // 同一个 tick 里要完整快照的客户端共用一份编码
+    if (room.fullTick != tick) {
+        room.fullSize = WriteFull(sim, room.full, kMaxPacket - kSnapshotHeader);
+        room.fullTick = tick;
+    }
+    packet[0] = MSG_FULL;
+    std::memcpy(packet + kSnapshotHeader, room.full, room.fullSize);
+    room.fullSnapshots++;
+    return kSnapshotHeader + room.fullSize;
+}
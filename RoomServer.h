@@ -0,0 +1,101 @@
+// RoomServer.h
+#pragma once
+#include "ArenaSim.h"
+#include "NetProtocol.h"
+#include "LatencyHistogram.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <netinet/in.h>
+
+// 联机房间服务器（仅 Linux）：一个 UDP 端口，很多个 ArenaSim 房间，服务器说了算
+// 一个线程跑 epoll：收包（recvmmsg 成批）、按 timerfd 的固定节拍推进所有房间
+// 推进时各房间在线程池上并行：Step、编码这个 tick 的增量、给房间里每个客户端拼快照、sendmmsg 发出
+// 收包只在两次推进之间处理，房间和客户端表只有 epoll 线程会改，不需要加锁
+struct ServerConfig {
+    std::string bindAddress = "0.0.0.0";
+    uint16_t port = 7777;           // 0 表示由系统分配
+    int rooms = 64;
+    int roomSize = 48;              // 房间宽高，不超过 ArenaSim::kMaxSize
+    int snakesPerRoom = 16;         // 不超过 ArenaSim::kMaxSnakes
+    int foodPerRoom = 8;
+    double tickRate = 10.0;         // 与单人模式的基础速度一致
+    unsigned threads = 0;           // 线程池大小，0 为全部硬件线程
+    double clientTimeout = 5.0;     // 这么久没收到输入就踢掉
+};
+
+class RoomServer {
+public:
+    struct Stats {
+        unsigned long long ticks = 0;
+        unsigned long long lateTicks = 0;       // 上一次推进超时，跳过的节拍数
+        unsigned long long packetsIn = 0, packetsOut = 0;
+        unsigned long long bytesIn = 0, bytesOut = 0;   // UDP 载荷，不含 28 字节的 IP/UDP 头
+        unsigned long long fullSnapshots = 0, deltaSnapshots = 0;
+        unsigned long long joins = 0, rejects = 0, timeouts = 0;
+        size_t clients = 0;
+        LatencyHistogram tickTime;              // 一次推进所有房间的耗时
+    };
+
+    explicit RoomServer(const ServerConfig& config);
+    ~RoomServer();
+    RoomServer(const RoomServer&) = delete;
+    RoomServer& operator=(const RoomServer&) = delete;
+
+    // 建 socket、epoll、timerfd；失败时打印原因并返回 false
+    bool Open();
+    uint16_t Port() const { return port; }
+    // 阻塞运行，直到别的线程调用 Stop
+    void Run();
+    void Stop();
+
+    // Run 返回之后读取
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct Client {
+        uint32_t id;
+        sockaddr_in addr;
+        int room;
+        int slot;
+        uint32_t ackTick = 0;
+        uint16_t lastSeq = 0;
+        bool hasSeq = false;
+        double lastHeard;
+        uint64_t joinKey;
+    };
+    struct Outgoing;
+    struct Room {
+        std::unique_ptr<ArenaSim> sim;
+        std::vector<Client*> members;
+        // 最近 kHistory 个 tick 的增量，按 tick % kHistory 存放
+        uint8_t history[Net::kHistory][256];
+        uint8_t historySize[Net::kHistory];
+        uint8_t full[Net::kMaxPacket];
+        size_t fullSize = 0;
+        unsigned long long fullTick = ~0ull;
+        std::unique_ptr<Outgoing> out;
+        unsigned long long fullSnapshots = 0, deltaSnapshots = 0, packetsOut = 0, bytesOut = 0;
+    };
+
+    void HandleReadable(double now);
+    void HandlePacket(const uint8_t* data, size_t size, const sockaddr_in& from, double now);
+    void Tick(double now);
+    void TickRoom(Room& room);
+    size_t BuildSnapshot(Room& room, Client& client, uint8_t* out);
+    void RemoveClient(uint32_t id);
+    void SendTo(const uint8_t* data, size_t size, const sockaddr_in& to);
+
+    ServerConfig config;
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<Room> rooms;
+    std::unordered_map<uint32_t, Client> clients;
+    std::unordered_map<uint64_t, uint32_t> joinKeys;    // (nonce, 地址) -> 客户端号，重发的 JOIN 用
+    uint32_t nextClientId = 1;
+    int sock = -1, epollFd = -1, timerFd = -1, stopFd = -1;
+    uint16_t port = 0;
+    Stats stats;
+};
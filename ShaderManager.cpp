@@ -0,0 +1,269 @@
+#include "ShaderManager.h"
+#include "GlExt.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+static const char kCacheMagic[4] = { 'S', 'N', 'K', 'P' };
+
+static uint64_t Fnv1a(uint64_t h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+static bool ReadFile(const std::string& path, std::string& out) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    bool ok = size >= 0 && std::fread(&out[0], 1, out.size(), f) == out.size();
+    std::fclose(f);
+    return ok;
+}
+
+static long long ModifiedTime(const std::string& path) {
+    std::error_code ec;
+    auto t = fs::last_write_time(path, ec);
+    return ec ? 0 : (long long)t.time_since_epoch().count();
+}
+
+static double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+ShaderManager::ShaderManager(const std::string& dir) : cacheDir(dir) {
+    const char* strings[3] = {
+        (const char*)glGetString(GL_VENDOR),
+        (const char*)glGetString(GL_RENDERER),
+        (const char*)glGetString(GL_VERSION)
+    };
+    for (const char* s : strings) {
+        driver += s ? s : "";
+        driver += '|';
+    }
+    if (!glExt.programBinary) cacheDir.clear();
+    if (!cacheDir.empty()) {
+        std::error_code ec;
+        fs::create_directories(cacheDir, ec);
+    }
+    // 让驱动自己决定用多少个编译线程
+    if (glExt.parallelShaderCompile) glExt.MaxShaderCompilerThreads(0xFFFFFFFFu);
+}
+
+ShaderManager::~ShaderManager() {
+    for (Entry& e : programs) {
+        if (e.pending) glDeleteProgram(e.pending);
+        for (GLuint s : e.pendingShaders)
+            if (s) glDeleteShader(s);
+        if (e.program) glDeleteProgram(e.program);
+    }
+}
+
+ShaderManager::Handle ShaderManager::AddSource(const char* name, const std::string& vertexSource, const std::string& fragmentSource) {
+    Entry e;
+    e.name = name;
+    e.vertexSource = vertexSource;
+    e.fragmentSource = fragmentSource;
+    e.loaded = true;
+    programs.push_back(std::move(e));
+    return (Handle)programs.size() - 1;
+}
+
+ShaderManager::Handle ShaderManager::AddFiles(const char* name, const std::string& vertexPath, const std::string& fragmentPath) {
+    Entry e;
+    e.name = name;
+    e.vertexPath = vertexPath;
+    e.fragmentPath = fragmentPath;
+    e.loaded = ReadSources(e);
+    if (!e.loaded)
+        std::cerr << "ERROR: Shader file not successfully read: " << vertexPath << ", " << fragmentPath << std::endl;
+    programs.push_back(std::move(e));
+    return (Handle)programs.size() - 1;
+}
+
+bool ShaderManager::ReadSources(Entry& e) {
+    e.vertexTime = ModifiedTime(e.vertexPath);
+    e.fragmentTime = ModifiedTime(e.fragmentPath);
+    return ReadFile(e.vertexPath, e.vertexSource) && ReadFile(e.fragmentPath, e.fragmentSource);
+}
+
+uint64_t ShaderManager::KeyOf(const Entry& e) const {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = Fnv1a(h, e.vertexSource.data(), e.vertexSource.size() + 1);
+    h = Fnv1a(h, e.fragmentSource.data(), e.fragmentSource.size() + 1);
+    return Fnv1a(h, driver.data(), driver.size());
+}
+
+std::string ShaderManager::CachePath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return cacheDir + "/" + name;
+}
+
+// 缓存文件：magic | 二进制格式(4 字节) | 键(8 字节) | 程序二进制
+bool ShaderManager::LoadBinary(Entry& e) {
+    if (cacheDir.empty()) return false;
+    std::string bytes;
+    const size_t header = sizeof(kCacheMagic) + sizeof(uint32_t) + sizeof(uint64_t);
+    if (!ReadFile(CachePath(e.key), bytes) || bytes.size() <= header) return false;
+    if (std::memcmp(bytes.data(), kCacheMagic, sizeof(kCacheMagic)) != 0) return false;
+    uint32_t format;
+    uint64_t key;
+    std::memcpy(&format, bytes.data() + 4, sizeof(format));
+    std::memcpy(&key, bytes.data() + 8, sizeof(key));
+    if (key != e.key) return false;
+
+    GLuint program = glCreateProgram();
+    glExt.ProgramBinary(program, format, bytes.data() + header, (GLsizei)(bytes.size() - header));
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // 驱动不再接受这份二进制，回退到编译
+        glDeleteProgram(program);
+        return false;
+    }
+    e.program = program;
+    return true;
+}
+
+void ShaderManager::SaveBinary(const Entry& e) const {
+    if (cacheDir.empty()) return;
+    GLint length = 0;
+    glGetProgramiv(e.program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary((size_t)length);
+    GLenum format = 0;
+    glExt.GetProgramBinary(e.program, length, &length, &format, binary.data());
+
+    // 先写临时文件再改名，另一个进程同时启动也不会读到半个文件
+    std::string path = CachePath(e.key), temp = path + ".tmp";
+    FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) return;
+    uint32_t format32 = format;
+    bool ok = std::fwrite(kCacheMagic, 1, sizeof(kCacheMagic), f) == sizeof(kCacheMagic) &&
+        std::fwrite(&format32, sizeof(format32), 1, f) == 1 &&
+        std::fwrite(&e.key, sizeof(e.key), 1, f) == 1 &&
+        std::fwrite(binary.data(), 1, (size_t)length, f) == (size_t)length;
+    ok = std::fclose(f) == 0 && ok;
+    std::error_code ec;
+    if (ok) fs::rename(temp, path, ec);
+    if (!ok || ec) fs::remove(temp, ec);
+}
+
+// 只提交，不查询任何状态，驱动可以在后台编译
+void ShaderManager::SubmitCompile(Entry& e) {
+    const char* vs = e.vertexSource.c_str();
+    const char* fsrc = e.fragmentSource.c_str();
+    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vs, nullptr);
+    glCompileShader(vertex);
+    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fsrc, nullptr);
+    glCompileShader(fragment);
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    if (!cacheDir.empty()) glExt.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+    e.pending = program;
+    e.pendingShaders[0] = vertex;
+    e.pendingShaders[1] = fragment;
+}
+
+bool ShaderManager::FinishCompile(Entry& e) {
+    GLint success = 0;
+    char infoLog[512];
+    const char* stage[2] = { "Vertex", "Fragment" };
+    for (int i = 0; i < 2; ++i) {
+        glGetShaderiv(e.pendingShaders[i], GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(e.pendingShaders[i], 512, nullptr, infoLog);
+            std::cerr << "ERROR: " << stage[i] << " shader compilation failed (" << e.name << ")\n" << infoLog << std::endl;
+        }
+    }
+    glGetProgramiv(e.pending, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(e.pending, 512, nullptr, infoLog);
+        std::cerr << "ERROR: Shader program linking failed (" << e.name << ")\n" << infoLog << std::endl;
+    }
+    for (GLuint& s : e.pendingShaders) {
+        glDetachShader(e.pending, s);
+        glDeleteShader(s);
+        s = 0;
+    }
+    GLuint program = e.pending;
+    e.pending = 0;
+    if (!success) {
+        glDeleteProgram(program);
+        stats.failed++;
+        return false;
+    }
+    // 热重载时旧程序到这里才换掉，失败的话继续用旧的
+    if (e.program) glDeleteProgram(e.program);
+    e.program = program;
+    e.uniforms.clear();
+    SaveBinary(e);
+    return true;
+}
+
+void ShaderManager::Submit() {
+    auto start = std::chrono::steady_clock::now();
+    for (Entry& e : programs) {
+        if (e.program || e.pending || !e.loaded) continue;
+        e.key = KeyOf(e);
+        if (LoadBinary(e)) {
+            stats.cacheHits++;
+        }
+        else {
+            stats.cacheMisses++;
+            SubmitCompile(e);
+        }
+    }
+    stats.buildMs += MsSince(start);
+}
+
+void ShaderManager::Finish() {
+    auto start = std::chrono::steady_clock::now();
+    for (Entry& e : programs)
+        if (e.pending) FinishCompile(e);
+    stats.buildMs += MsSince(start);
+}
+
+GLint ShaderManager::Uniform(Handle h, const char* name) {
+    if (h < 0 || h >= (int)programs.size()) return -1;
+    Entry& e = programs[h];
+    for (const UniformSlot& u : e.uniforms)
+        if (u.name == name) return u.location;
+    GLint location = e.program ? glGetUniformLocation(e.program, name) : -1;
+    e.uniforms.push_back({ name, location });
+    return location;
+}
+
+int ShaderManager::PollReload() {
+    int reloaded = 0;
+    for (Entry& e : programs) {
+        if (e.vertexPath.empty() || e.pending) continue;
+        if (ModifiedTime(e.vertexPath) == e.vertexTime && ModifiedTime(e.fragmentPath) == e.fragmentTime) continue;
+        if (!ReadSources(e)) continue;
+        e.loaded = true;
+        e.key = KeyOf(e);
+        SubmitCompile(e);
+        if (FinishCompile(e)) {
+            stats.reloads++;
+            reloaded++;
+            std::cout << "着色器已重新加载: " << e.name << std::endl;
+        }
+    }
+    return reloaded;
+}
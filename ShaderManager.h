@@ -0,0 +1,80 @@
+// ShaderManager.h
+#pragma once
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 着色器管理
+// 1. 链接好的程序用 glGetProgramBinary 存进磁盘缓存，键是源码和驱动字符串的 FNV-1a 哈希，
+//    命中时直接 glProgramBinary，不再编译；驱动升级或源码改动都会换键
+// 2. Submit 先把所有未命中的程序提交编译链接，中间不查询状态；
+//    支持 KHR_parallel_shader_compile 时驱动在后台线程并行编译，调用方可以同时加载纹理，Finish 时再统一收结果
+// 3. uniform 位置按名字缓存，每帧查询不再走驱动
+// 4. 来自文件的程序记录修改时间，PollReload 发现改动就重新编译，成功才替换旧程序
+// 编译或链接失败的程序为 0，并打印日志
+class ShaderManager {
+public:
+    typedef int Handle;
+
+    struct Stats {
+        unsigned cacheHits = 0;
+        unsigned cacheMisses = 0;
+        unsigned failed = 0;
+        unsigned reloads = 0;
+        double buildMs = 0.0;       // Submit 到 Finish 之间花在 GL 调用上的时间
+    };
+
+    // cacheDir 为空字符串时不使用磁盘缓存
+    explicit ShaderManager(const std::string& cacheDir = "shader_cache");
+    ~ShaderManager();
+    ShaderManager(const ShaderManager&) = delete;
+    ShaderManager& operator=(const ShaderManager&) = delete;
+
+    Handle AddSource(const char* name, const std::string& vertexSource, const std::string& fragmentSource);
+    // 读文件失败时返回的句柄对应程序 0
+    Handle AddFiles(const char* name, const std::string& vertexPath, const std::string& fragmentPath);
+
+    void Submit();
+    void Finish();
+
+    GLuint Program(Handle h) const { return h >= 0 && h < (int)programs.size() ? programs[h].program : 0; }
+    GLint Uniform(Handle h, const char* name);
+
+    // 检查文件是否修改过，返回成功重新加载的程序数
+    int PollReload();
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    struct UniformSlot {
+        std::string name;
+        GLint location;
+    };
+
+    struct Entry {
+        std::string name;
+        std::string vertexSource, fragmentSource;
+        std::string vertexPath, fragmentPath;     // 非空表示来自文件，可热重载
+        long long vertexTime = 0, fragmentTime = 0;
+        uint64_t key = 0;
+        GLuint program = 0;
+        GLuint pending = 0;                       // 已提交、还没收结果的程序
+        GLuint pendingShaders[2] = { 0, 0 };
+        bool loaded = false;                      // 源码读取成功
+        std::vector<UniformSlot> uniforms;
+    };
+
+    uint64_t KeyOf(const Entry& e) const;
+    std::string CachePath(uint64_t key) const;
+    bool LoadBinary(Entry& e);
+    void SaveBinary(const Entry& e) const;
+    void SubmitCompile(Entry& e);
+    bool FinishCompile(Entry& e);
+    bool ReadSources(Entry& e);
+
+    std::vector<Entry> programs;
+    std::string cacheDir;
+    std::string driver;         // GL_VENDOR | GL_RENDERER | GL_VERSION
+    Stats stats;
+};
@@ -0,0 +1,161 @@
+#include "SimThread.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+double SimThread::Now() {
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point origin = Clock::now();
+    return std::chrono::duration<double>(Clock::now() - origin).count();
+}
+
+double SimThread::CameraCenter(double head, int grid, int view) {
+    double half = view / 2.0;
+    if (grid <= view) return grid / 2.0;
+    return std::min(std::max(head + 0.5, half), grid - half);
+}
+
+SimThread::SimThread(SnakeSim& simRef, ReplayWriter& replayRef, int view)
+    : sim(simRef), replay(replayRef), viewCells(view) {
+}
+
+void SimThread::Start(uint64_t seed) {
+    Stop();
+    sim.Reset(seed);
+    replay.Begin(sim);
+    if (autopilot) autopilot->Invalidate();
+    autopilotOn = false;
+    latency.Clear();
+    jitter.Clear();
+    pendingHead = pendingCount = 0;
+    InputEvent stale;
+    while (input.Pop(stale)) {}
+
+    // 线程启动前由调用线程发布第一份，渲染线程马上就有东西可画
+    double startTime = Now();
+    Publish(startTime);
+    stopRequested.store(false, std::memory_order_relaxed);
+    thread = std::thread(&SimThread::Run, this, startTime);
+}
+
+void SimThread::Stop() {
+    if (!thread.joinable()) return;
+    stopRequested.store(true, std::memory_order_release);
+    thread.join();
+}
+
+// 先睡到截止时刻前 1 ms，剩下的让出时间片自旋，tick 的抖动不受系统睡眠粒度影响
+bool SimThread::WaitUntil(double deadline) {
+    const double spinWindow = 0.001;
+    for (;;) {
+        if (stopRequested.load(std::memory_order_acquire)) return false;
+        double remaining = deadline - Now();
+        if (remaining <= 0.0) return true;
+        if (remaining > spinWindow) {
+            // 分段睡，Stop 最多等 5 ms
+            double nap = std::min(remaining - spinWindow, 0.005);
+            std::this_thread::sleep_for(std::chrono::duration<double>(nap));
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SimThread::DrainInput() {
+    PROFILE_ZONE("Input");
+    InputEvent e;
+    while (input.Pop(e)) {
+        if (e.type == InputEvent::TOGGLE_AUTOPILOT) {
+            if (autopilot) autopilotOn = !autopilotOn;
+            continue;
+        }
+        // 反方向掉头和队列已满由 SnakeSim 过滤
+        if (sim.QueueDirection(e.dir)) {
+            replay.Record(sim.Tick(), e.dir);
+            pendingTimes[(pendingHead + pendingCount) % SnakeSim::kMaxQueued] = e.time;
+            pendingCount++;
+        }
+    }
+}
+
+void SimThread::Run(double startTime) {
+    PROFILE_THREAD("sim");
+    double next = startTime + sim.MoveInterval();
+    while (WaitUntil(next)) {
+        PROFILE_ZONE("Tick");
+        jitter.Record(Now() - next);
+        DrainInput();
+        if (autopilotOn && sim.QueuedCount() == 0) {
+            Vec2i d = autopilot->NextDirection(sim);
+            if (!(d == sim.Direction()) && sim.QueueDirection(d)) {
+                replay.Record(sim.Tick(), d);
+                pendingTimes[(pendingHead + pendingCount) % SnakeSim::kMaxQueued] = -1.0;
+                pendingCount++;
+            }
+        }
+
+        int queuedBefore = sim.QueuedCount();
+        StepResult result = sim.Step();
+        double now = Now();
+        // Step 每次最多取走一个按键
+        if (pendingCount > 0 && sim.QueuedCount() < queuedBefore) {
+            double pressed = pendingTimes[pendingHead];
+            pendingHead = (pendingHead + 1) % SnakeSim::kMaxQueued;
+            pendingCount--;
+            if (pressed >= 0.0) latency.Record(now - pressed);
+        }
+
+        // 固定步长：截止时刻逐个累加，不随唤醒时刻漂移；落后太多时丢弃积压
+        double tickTime = next;
+        next += sim.MoveInterval();
+        if (now - next > kMaxCatchUpTicks * sim.MoveInterval()) {
+            tickTime = now;
+            next = now + sim.MoveInterval();
+        }
+
+        if (result == DIED) {
+            if (sim.Death() == HIT_WALL) std::cout << "撞墙，游戏结束！\n";
+            else std::cout << "撞到自己，游戏结束！\n";
+            replay.Finish(sim);
+            replay.Save("last_replay.snkr");
+            Publish(tickTime);
+            break;
+        }
+        Publish(tickTime);
+    }
+}
+
+void SimThread::Publish(double tickTime) {
+    SimSnapshot& s = snapshots.Back();
+    const SnakeBody& body = sim.Body();
+    s.segments.clear();
+    s.headPrevious = body.Previous(0);
+    s.head = body.Front();
+    s.food = sim.Food();
+    s.direction = sim.Direction();
+    s.tickTime = tickTime;
+    s.interval = sim.MoveInterval();
+    s.tick = sim.Tick();
+    s.alive = sim.Alive();
+    s.death = sim.Death();
+
+    auto add = [&](size_t i) {
+        s.segments.push_back({ body.Previous(i), body[i], i == 0 });
+    };
+    if (const BodyChunks* chunks = sim.Chunks()) {
+        // 相机跟随插值后的蛇头，一个 tick 内最多移动一格，视野外再多留两格
+        int margin = viewCells / 2 + 2;
+        int cx = (int)CameraCenter(s.head.x, sim.Width(), viewCells);
+        int cy = (int)CameraCenter(s.head.y, sim.Height(), viewCells);
+        chunks->ForEachInRect(cx - margin, cy - margin, cx + margin, cy + margin, [&](const BodyChunks::Entry& e) {
+            add(body.IndexOfSerial(e.serial));
+        });
+    }
+    else {
+        for (size_t i = 0; i < body.Size(); ++i) add(i);
+    }
+    snapshots.Publish();
+}
@@ -0,0 +1,98 @@
+// SimThread.h
+#pragma once
+#include "SnakeSim.h"
+#include "Replay.h"
+#include "Autopilot.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "LatencyHistogram.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// 带时间戳的输入事件，由窗口线程的按键回调产生
+struct InputEvent {
+    enum Type { DIRECTION, TOGGLE_AUTOPILOT };
+    Type type = DIRECTION;
+    Vec2i dir = { 0, 0 };
+    double time = 0.0;          // SimThread::Now()
+};
+
+// 渲染需要的一节：上一个 tick 和这一个 tick 的位置
+struct SnapshotSegment {
+    Vec2i previous, current;
+    bool head;
+};
+
+// 每个 tick 发布一份，只含视野附近的节，大小与蛇长无关
+struct SimSnapshot {
+    std::vector<SnapshotSegment> segments;
+    Vec2i headPrevious = { 0, 0 }, head = { 0, 0 };
+    Vec2i food = { -1, -1 };
+    Vec2i direction = { 1, 0 };
+    double tickTime = 0.0;      // 这个 tick 生效的时刻
+    double interval = 0.1;      // 到下一个 tick 的间隔
+    unsigned long long tick = 0;
+    bool alive = true;
+    DeathCause death = ALIVE;
+};
+
+// 逻辑线程：按自己的时钟推进 SnakeSim，不受渲染帧率影响
+// 输入经无锁 SPSC 队列进来，每个 tick 前取空；状态经无锁三缓冲交给渲染线程
+// 一局从 Start 开始，死亡或 Stop 时结束；运行期间 sim/replay/autopilot 只归逻辑线程访问
+class SimThread {
+public:
+    SimThread(SnakeSim& sim, ReplayWriter& replay, int viewCells);
+    ~SimThread() { Stop(); }
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    // 传 nullptr 关闭自动驾驶，须在 Start 之前设置
+    void SetAutopilot(Autopilot* pilot) { autopilot = pilot; }
+
+    void Start(uint64_t seed);
+    void Stop();
+    bool Running() const { return thread.joinable(); }
+
+    // 窗口线程调用；队列满时丢弃
+    bool PushInput(const InputEvent& e) { return input.Push(e); }
+    // 渲染线程调用，返回最新发布的一份
+    const SimSnapshot& Latest() {
+        snapshots.Update();
+        return snapshots.Front();
+    }
+
+    // 按下到被某个 tick 取走的延迟，Stop 之后读取
+    const LatencyHistogram& Latency() const { return latency; }
+    // tick 实际执行时刻比预定时刻晚多少
+    const LatencyHistogram& TickJitter() const { return jitter; }
+
+    // 进程内统一的单调时钟，秒
+    static double Now();
+    // 相机中心：棋盘放得下时固定在中心，否则跟随 head 并停在墙边
+    static double CameraCenter(double head, int grid, int view);
+
+    static const int kMaxCatchUpTicks = 5;
+
+private:
+    void Run(double startTime);
+    bool WaitUntil(double deadline);
+    void DrainInput();
+    void Publish(double tickTime);
+
+    SnakeSim& sim;
+    ReplayWriter& replay;
+    Autopilot* autopilot = nullptr;
+    bool autopilotOn = false;
+    int viewCells;
+
+    SpscQueue<InputEvent, 256> input;
+    TripleBuffer<SimSnapshot> snapshots;
+    LatencyHistogram latency, jitter;
+    // 与 sim 的按键队列一一对应的按下时刻，自动驾驶压入的记为负数不计延迟
+    double pendingTimes[SnakeSim::kMaxQueued];
+    int pendingHead = 0, pendingCount = 0;
+
+    std::thread thread;
+    std::atomic<bool> stopRequested{ false };
+};
@@ -0,0 +1,86 @@
+// SnakeBody.h
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct Vec2i {
+    int x, y;
+    bool operator==(const Vec2i& other) const { return x == other.x && y == other.y; }
+};
+
+// 蛇身的环形缓冲：连续存储，头尾各一个下标，移动一步是 O(1)
+// 上一个 tick 的位置不再整条复制，而是由下标平移加上被腾出的尾格得到
+class SnakeBody {
+public:
+    explicit SnakeBody(size_t capacityHint = 16) { Reserve(capacityHint); }
+
+    // 预分配，容量取 2 的幂以便用掩码取模
+    void Reserve(size_t n) {
+        size_t capacity = 16;
+        while (capacity < n) capacity *= 2;
+        if (capacity > cells.size()) Regrow(capacity);
+    }
+
+    void Clear() {
+        head = 0;
+        count = 0;
+        serial = 0;
+        pushed = popped = false;
+    }
+
+    // 每个 tick 开始时调用，之后的 PushFront/PopBack 决定 Previous 的结果
+    void BeginTick() { pushed = popped = false; }
+
+    void PushFront(Vec2i cell) {
+        if (count == cells.size()) Regrow(cells.size() * 2);
+        head = (head - 1) & mask;
+        cells[head] = cell;
+        count++;
+        serial++;
+        pushed = true;
+    }
+
+    void PopBack() {
+        vacated = Back();
+        count--;
+        popped = true;
+    }
+
+    size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+    Vec2i Front() const { return cells[head]; }
+    Vec2i Back() const { return cells[(head + count - 1) & mask]; }
+    // 0 为蛇头
+    Vec2i operator[](size_t i) const { return cells[(head + i) & mask]; }
+
+    // 每节入队时的序号，蛇头最大；空间索引用序号反查第几节
+    uint64_t Serial(size_t i) const { return serial - i; }
+    size_t IndexOfSerial(uint64_t s) const { return (size_t)(serial - s); }
+
+    // 第 i 节在上一个 tick 的位置：本 tick 移动过则是后一节现在的位置，
+    // 最后一节取被腾出的尾格；变长时新增的尾节保持不动
+    Vec2i Previous(size_t i) const {
+        if (!pushed) return (*this)[i];
+        if (i + 1 < count) return (*this)[i + 1];
+        if (popped) return vacated;
+        return (*this)[i];
+    }
+
+private:
+    void Regrow(size_t capacity) {
+        std::vector<Vec2i> grown(capacity);
+        for (size_t i = 0; i < count; ++i) grown[i] = (*this)[i];
+        cells.swap(grown);
+        mask = capacity - 1;
+        head = 0;
+    }
+
+    std::vector<Vec2i> cells;
+    size_t mask = 0;
+    size_t head = 0;
+    size_t count = 0;
+    uint64_t serial = 0;               // 自 Clear 以来 PushFront 的次数
+    bool pushed = false, popped = false;
+    Vec2i vacated = { 0, 0 };
+};
@@ -0,0 +1,34 @@
+// SnakeRules.h
+#pragma once
+#include "SnakeBody.h"
+#include <cstddef>
+
+// SnakeSim 与 BatchEnv 共用的规则，两边必须逐格一致（录像和批量校验都依赖这一点）
+namespace SnakeRules {
+
+    const float kBaseInterval = 0.1f;
+    const float kMinInterval = 0.02f;
+
+    // 新方向与当前方向相反时不能掉头
+    inline bool IsReverse(Vec2i current, Vec2i next) {
+        return current.x == -next.x && current.y == -next.y;
+    }
+
+    // 外圈一格是墙
+    inline bool HitsWall(Vec2i cell, int width, int height) {
+        return cell.x < 1 || cell.x >= width - 1 || cell.y < 1 || cell.y >= height - 1;
+    }
+
+    // 蛇尾在这一步会让开，所以不吃食物时可以走进当前的尾格
+    inline bool HitsBody(bool occupied, bool isTail, bool growing) {
+        return occupied && !(isTail && !growing);
+    }
+
+    // 每长 4 节加速一次；原来的公式到 40 节时会降到 0，这里设了下限
+    inline float MoveInterval(size_t length, float current) {
+        if (length % 4 != 0) return current;
+        float interval = kBaseInterval - (length / 4) * 0.01f;
+        return interval < kMinInterval ? kMinInterval : interval;
+    }
+
+}
@@ -0,0 +1,120 @@
+#include "SnakeSim.h"
+#include "SnakeRules.h"
+
+SnakeSim::SnakeSim(int gridWidth, int gridHeight, uint64_t initialSeed, bool spatialIndex)
+    : width(gridWidth), height(gridHeight), seed(initialSeed) {
+    if ((size_t)width * height <= kMaxDenseCells) grid.reset(new OccupancyGrid(width, height));
+    indexed = spatialIndex || !grid;
+    // 按棋盘内部格数预分配，超大棋盘只预分配一部分，之后按需倍增
+    size_t interior = (size_t)(width - 2) * (height - 2);
+    body.Reserve(interior < kMaxPrealloc ? interior : kMaxPrealloc);
+    Reset(initialSeed);
+}
+
+void SnakeSim::Reset() {
+    Reset(rng.Next());
+}
+
+void SnakeSim::Reset(uint64_t newSeed) {
+    seed = newSeed;
+    rng.Seed(newSeed);
+    // 只释放蛇身占用的格子，重开一局是 O(长度) 而不是 O(棋盘)
+    if (grid)
+        for (size_t i = 0; i < body.Size(); ++i) grid->Release(body[i]);
+    chunks.Clear();
+    body.Clear();
+    Vec2i start = { width / 2, height / 2 };
+    body.PushFront(start);
+    body.BeginTick();
+    if (grid) grid->Occupy(start);
+    if (indexed) chunks.Insert(start, body.Serial(0));
+    direction = { 1, 0 };
+    moveInterval = SnakeRules::kBaseInterval;
+    death = ALIVE;
+    tick = 0;
+    queueHead = queueSize = 0;
+    SpawnFood();
+}
+
+bool SnakeSim::Occupied(Vec2i cell) const {
+    if (grid) return grid->Occupied(cell);
+    if (SnakeRules::HitsWall(cell, width, height)) return true;
+    return chunks.Occupied(cell);
+}
+
+bool SnakeSim::QueueDirection(Vec2i dir) {
+    // 防止反方向掉头
+    if (SnakeRules::IsReverse(direction, dir)) return false;
+    if (queueSize == kMaxQueued) return false;
+    dirQueue[(queueHead + queueSize) % kMaxQueued] = dir;
+    queueSize++;
+    return true;
+}
+
+StepResult SnakeSim::Step(const SimInput& input) {
+    if (death != ALIVE) return DIED;
+    if (input.dir.x != 0 || input.dir.y != 0) QueueDirection(input.dir);
+
+    tick++;
+    body.BeginTick();
+    if (queueSize > 0) {
+        Vec2i nextDir = dirQueue[queueHead];
+        queueHead = (queueHead + 1) % kMaxQueued;
+        queueSize--;
+        if (!SnakeRules::IsReverse(direction, nextDir))
+            direction = nextDir;
+    }
+
+    Vec2i newHead = { body.Front().x + direction.x, body.Front().y + direction.y };
+    if (SnakeRules::HitsWall(newHead, width, height)) {
+        death = HIT_WALL;
+        return DIED;
+    }
+
+    bool growing = newHead == food;
+    Vec2i tail = body.Back();
+    if (SnakeRules::HitsBody(Occupied(newHead), newHead == tail, growing)) {
+        death = HIT_SELF;
+        return DIED;
+    }
+
+    StepResult result = MOVED;
+    if (!growing) {
+        if (grid) grid->Release(tail);
+        if (indexed) chunks.RemoveOldest(tail);
+        body.PushFront(newHead);
+        body.PopBack();
+    }
+    else {
+        body.PushFront(newHead);
+    }
+    if (grid) grid->Occupy(newHead);
+    if (indexed) chunks.Insert(newHead, body.Serial(0));
+    if (growing) {
+        SpawnFood();
+        result = ATE;
+    }
+    moveInterval = SnakeRules::MoveInterval(body.Size(), moveInterval);
+    return result;
+}
+
+// 在空格集合中均匀抽取，棋盘再满也是 O(1)；没有空格时食物放到棋盘外
+// 大地图上蛇身只占极小一部分，拒绝采样几乎总是一次命中
+void SnakeSim::SpawnFood() {
+    if (!grid) {
+        for (int i = 0; i < kMaxFoodTries; ++i) {
+            Vec2i cell = { 1 + (int)rng.Below((size_t)width - 2), 1 + (int)rng.Below((size_t)height - 2) };
+            if (!chunks.Occupied(cell)) {
+                food = cell;
+                return;
+            }
+        }
+        food = { -1, -1 };
+        return;
+    }
+    if (grid->FreeCount() == 0) {
+        food = { -1, -1 };
+        return;
+    }
+    food = grid->FreeCell(rng.Below(grid->FreeCount()));
+}
@@ -0,0 +1,79 @@
+// SnakeSim.h
+#pragma once
+#include "SnakeBody.h"
+#include "OccupancyGrid.h"
+#include "BodyChunks.h"
+#include "Rng.h"
+#include <memory>
+
+// 不依赖 GLFW/GL 的游戏规则：移动、撞墙、撞自己、吃食物变长、加速
+// 时间由调用方驱动，每次 Step 前进一个逻辑 tick
+// 随机数只来自内部的 Rng，同样的种子和同样的按键序列一定得到同样的一局
+// 超过 kMaxDenseCells 的大地图（最大 100k x 100k）不再建整张占用位图，
+// 碰撞改查分块的蛇身索引，食物改为拒绝采样；棋盘越空拒绝采样越快
+
+enum StepResult { MOVED, ATE, DIED };
+enum DeathCause { ALIVE, HIT_WALL, HIT_SELF };
+
+// 一个 tick 的输入，dir 为 {0, 0} 表示本 tick 没有新的按键
+struct SimInput {
+    Vec2i dir = { 0, 0 };
+};
+
+class SnakeSim {
+public:
+    // spatialIndex 为真时普通棋盘也维护分块蛇身索引，供滚动视野的渲染裁剪使用
+    SnakeSim(int gridWidth = 20, int gridHeight = 20, uint64_t seed = 1, bool spatialIndex = false);
+
+    // 用指定种子开始新的一局
+    void Reset(uint64_t seed);
+    // 种子取自上一局的随机数序列
+    void Reset();
+    // 对应原来的 dirQueue.push_back，反方向或队列已满时丢弃并返回 false
+    bool QueueDirection(Vec2i dir);
+    StepResult Step(const SimInput& input = SimInput());
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    // 蛇身，Previous(i) 给出上一个 tick 的位置供渲染插值
+    const SnakeBody& Body() const { return body; }
+    // 墙和蛇身都算占用
+    bool Occupied(Vec2i cell) const;
+    // 分块蛇身索引，没有维护时为 nullptr
+    const BodyChunks* Chunks() const { return indexed ? &chunks : nullptr; }
+    Vec2i Food() const { return food; }
+    Vec2i Direction() const { return direction; }
+    float MoveInterval() const { return moveInterval; }
+    bool Alive() const { return death == ALIVE; }
+    DeathCause Death() const { return death; }
+    unsigned long long Tick() const { return tick; }
+    uint64_t Seed() const { return seed; }
+    // 还没被 Step 取走的按键数
+    int QueuedCount() const { return queueSize; }
+
+    static const int kMaxQueued = 8;
+    static const size_t kMaxPrealloc = 1 << 20;
+    static const size_t kMaxDenseCells = (size_t)4096 * 4096;
+    static const int kMaxFoodTries = 1024;
+    static const int kMaxArena = 100000;
+
+private:
+    void SpawnFood();
+
+    int width, height;
+    SnakeBody body;
+    std::unique_ptr<OccupancyGrid> grid;    // 只有普通尺寸的棋盘才有
+    BodyChunks chunks;
+    bool indexed;
+    Rng rng;
+    uint64_t seed;
+    Vec2i direction;
+    Vec2i food;
+    float moveInterval;
+    DeathCause death;
+    unsigned long long tick;
+
+    // 固定容量的按键队列，避免每个 tick 分配内存
+    Vec2i dirQueue[kMaxQueued];
+    int queueHead, queueSize;
+};
@@ -0,0 +1,358 @@
+#include "SoftRasterizer.h"
+#include "AtlasFormat.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SNAKE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SNAKE_TARGET_AVX2
+#else
+#define SNAKE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// 一行扫描的参数：第 x 列像素中心的纹理坐标为 u = u0 + x * ux，v = v0 + x * vx，
+// 落在 [0, 1) x [0, 1) 内的像素属于精灵；纹素为 (int)clamp(u * tw + tb, 0, maxT)
+struct SpanJob {
+    float u0, ux, v0, vx;
+    float tw, tb, th, tv, maxT;
+    const uint32_t* texels;     // 该层的纹素，nullptr 表示纯色
+    int texSize;
+    uint32_t color;
+};
+
+static uint32_t PackColor(float r, float g, float b, float a) {
+    auto channel = [](float c) {
+        c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+        return (uint32_t)(c * 255.0f + 0.5f);
+    };
+    return channel(r) | channel(g) << 8 | channel(b) << 16 | channel(a) << 24;
+}
+
+// GL_SRC_ALPHA / GL_ONE_MINUS_SRC_ALPHA，四个通道都按 (s * a + d * (255 - a)) / 255 四舍五入
+static inline uint32_t Blend(uint32_t s, uint32_t d) {
+    uint32_t a = s >> 24, ia = 255 - a, out = 0;
+    for (int c = 0; c < 32; c += 8) {
+        uint32_t t = ((s >> c) & 255) * a + ((d >> c) & 255) * ia + 128;
+        out |= ((t + (t >> 8)) >> 8) << c;
+    }
+    return out;
+}
+
+static inline int TexelIndex(const SpanJob& j, float u, float v) {
+    float tu = u * j.tw + j.tb, tv = v * j.th + j.tv;
+    tu = tu < 0.0f ? 0.0f : tu;
+    tu = tu > j.maxT ? j.maxT : tu;
+    tv = tv < 0.0f ? 0.0f : tv;
+    tv = tv > j.maxT ? j.maxT : tv;
+    return (int)tv * j.texSize + (int)tu;
+}
+
+static void SpanScalar(const SpanJob& j, uint32_t* row, int x0, int x1) {
+    for (int x = x0; x < x1; ++x) {
+        float fx = (float)x;
+        float u = j.u0 + fx * j.ux, v = j.v0 + fx * j.vx;
+        if (!(u >= 0.0f && u < 1.0f && v >= 0.0f && v < 1.0f)) continue;
+        uint32_t src = j.texels ? j.texels[TexelIndex(j, u, v)] : j.color;
+        row[x] = Blend(src, row[x]);
+    }
+}
+
+#ifdef SNAKE_X86
+
+// 4 个像素的混合：按 16 位展开，乘加后除以 255
+static inline __m128i Blend4(__m128i s, __m128i d) {
+    const __m128i zero = _mm_setzero_si128(), c255 = _mm_set1_epi16(255), c128 = _mm_set1_epi16(128);
+    __m128i result[2];
+    for (int half = 0; half < 2; ++half) {
+        __m128i s16 = half ? _mm_unpackhi_epi8(s, zero) : _mm_unpacklo_epi8(s, zero);
+        __m128i d16 = half ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, 0xFF), 0xFF);
+        __m128i t = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s16, a), _mm_mullo_epi16(d16, _mm_sub_epi16(c255, a))), c128);
+        result[half] = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+    return _mm_packus_epi16(result[0], result[1]);
+}
+
+static void SpanSse2(const SpanJob& j, uint32_t* row, int x0, int x1) {
+    const __m128 u0 = _mm_set1_ps(j.u0), ux = _mm_set1_ps(j.ux), v0 = _mm_set1_ps(j.v0), vx = _mm_set1_ps(j.vx);
+    const __m128 tw = _mm_set1_ps(j.tw), tb = _mm_set1_ps(j.tb), th = _mm_set1_ps(j.th), tv = _mm_set1_ps(j.tv);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), maxT = _mm_set1_ps(j.maxT);
+    const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i color = _mm_set1_epi32((int)j.color);
+    int x = x0;
+    for (; x + 4 <= x1; x += 4) {
+        __m128 fx = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x), lane));
+        __m128 u = _mm_add_ps(u0, _mm_mul_ps(fx, ux));
+        __m128 v = _mm_add_ps(v0, _mm_mul_ps(fx, vx));
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmplt_ps(u, one)),
+            _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmplt_ps(v, one)));
+        if (_mm_movemask_ps(inside) == 0) continue;
+        __m128i src = color;
+        if (j.texels) {
+            __m128 fu = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(u, tw), tb), zero), maxT);
+            __m128 fv = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(v, th), tv), zero), maxT);
+            alignas(16) int iu[4], iv[4];
+            _mm_store_si128((__m128i*)iu, _mm_cvttps_epi32(fu));
+            _mm_store_si128((__m128i*)iv, _mm_cvttps_epi32(fv));
+            src = _mm_setr_epi32((int)j.texels[iv[0] * j.texSize + iu[0]], (int)j.texels[iv[1] * j.texSize + iu[1]],
+                (int)j.texels[iv[2] * j.texSize + iu[2]], (int)j.texels[iv[3] * j.texSize + iu[3]]);
+        }
+        __m128i d = _mm_loadu_si128((const __m128i*)(row + x));
+        __m128i mask = _mm_castps_si128(inside);
+        __m128i out = _mm_or_si128(_mm_and_si128(mask, Blend4(src, d)), _mm_andnot_si128(mask, d));
+        _mm_storeu_si128((__m128i*)(row + x), out);
+    }
+    SpanScalar(j, row, x, x1);
+}
+
+SNAKE_TARGET_AVX2 static inline __m256i Blend8(__m256i s, __m256i d) {
+    const __m256i zero = _mm256_setzero_si256(), c255 = _mm256_set1_epi16(255), c128 = _mm256_set1_epi16(128);
+    __m256i result[2];
+    for (int half = 0; half < 2; ++half) {
+        __m256i s16 = half ? _mm256_unpackhi_epi8(s, zero) : _mm256_unpacklo_epi8(s, zero);
+        __m256i d16 = half ? _mm256_unpackhi_epi8(d, zero) : _mm256_unpacklo_epi8(d, zero);
+        __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s16, 0xFF), 0xFF);
+        __m256i t = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s16, a), _mm256_mullo_epi16(d16, _mm256_sub_epi16(c255, a))), c128);
+        result[half] = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+    // unpack 与 packus 都在 128 位半边内进行，顺序正好还原
+    return _mm256_packus_epi16(result[0], result[1]);
+}
+
+SNAKE_TARGET_AVX2 static void SpanAvx2(const SpanJob& j, uint32_t* row, int x0, int x1) {
+    const __m256 u0 = _mm256_set1_ps(j.u0), ux = _mm256_set1_ps(j.ux), v0 = _mm256_set1_ps(j.v0), vx = _mm256_set1_ps(j.vx);
+    const __m256 tw = _mm256_set1_ps(j.tw), tb = _mm256_set1_ps(j.tb), th = _mm256_set1_ps(j.th), tv = _mm256_set1_ps(j.tv);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), maxT = _mm256_set1_ps(j.maxT);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i color = _mm256_set1_epi32((int)j.color);
+    const __m256i size = _mm256_set1_epi32(j.texSize);
+    for (int x = x0; x < x1; x += 8) {
+        __m256i column = _mm256_add_epi32(_mm256_set1_epi32(x), lane);
+        // 最后不足 8 个像素时用掩码读写，不碰 x1 之后属于别的块的像素
+        __m256i valid = _mm256_cmpgt_epi32(_mm256_set1_epi32(x1), column);
+        __m256 fx = _mm256_cvtepi32_ps(column);
+        __m256 u = _mm256_add_ps(u0, _mm256_mul_ps(fx, ux));
+        __m256 v = _mm256_add_ps(v0, _mm256_mul_ps(fx, vx));
+        __m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LT_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ), _mm256_cmp_ps(v, one, _CMP_LT_OQ)));
+        inside = _mm256_and_ps(inside, _mm256_castsi256_ps(valid));
+        if (_mm256_movemask_ps(inside) == 0) continue;
+        __m256i src = color;
+        if (j.texels) {
+            __m256 fu = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(u, tw), tb), zero), maxT);
+            __m256 fv = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(v, th), tv), zero), maxT);
+            __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(fv), size), _mm256_cvttps_epi32(fu));
+            src = _mm256_i32gather_epi32((const int*)j.texels, index, 4);
+        }
+        __m256i mask = _mm256_castps_si256(inside);
+        __m256i d = _mm256_maskload_epi32((const int*)(row + x), valid);
+        _mm256_maskstore_epi32((int*)(row + x), mask, Blend8(src, d));
+    }
+    // 回到 SSE 代码前清掉 ymm 高半部分，否则之后的每条 SSE 指令都要付状态切换的代价
+    _mm256_zeroupper();
+}
+
+#endif
+
+SoftRasterizer::Isa SoftRasterizer::BestIsa() {
+#ifdef SNAKE_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        bool osSaves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        if (osSaves && (info[1] & (1 << 5)) != 0) return AVX2;
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return AVX2;
+#endif
+    return SSE2;
+#else
+    return SCALAR;
+#endif
+}
+
+SoftRasterizer::SoftRasterizer(int w, int h, float quadHalfSize, ThreadPool* threadPool)
+    : width(w), height(h), quadHalf(quadHalfSize), pool(threadPool), isa(BestIsa()) {
+    tilesX = (width + kTileSize - 1) / kTileSize;
+    tilesY = (height + kTileSize - 1) / kTileSize;
+    pixels.assign((size_t)width * height, 0);
+    bins.resize((size_t)tilesX * tilesY);
+}
+
+void SoftRasterizer::SetIsa(Isa requested) {
+    isa = requested < BestIsa() ? requested : BestIsa();
+}
+
+bool SoftRasterizer::SetAtlas(const uint8_t* atlas, size_t size) {
+    const AtlasHeader* header;
+    const AtlasEntry* entries;
+    if (!Atlas::Parse(atlas, size, header, entries)) return false;
+    texSize = (int)header->size;
+    texLayers = (int)header->layers;
+    texels.resize((size_t)texSize * texSize * texLayers);
+    std::memcpy(texels.data(), atlas + Atlas::DataOffset(texLayers), texels.size() * 4);
+    rects.clear();
+    for (int i = 0; i < texLayers; ++i)
+        rects.insert(rects.end(), { entries[i].u0, entries[i].v0, entries[i].u1, entries[i].v1 });
+    return true;
+}
+
+void SoftRasterizer::SetBorder(float left, float right, float top, float bottom) {
+    border[0] = left;
+    border[1] = right;
+    border[2] = top;
+    border[3] = bottom;
+}
+
+void SoftRasterizer::BeginFrame(float r, float g, float b) {
+    sprites.clear();
+    clearColor = PackColor(r, g, b, 1.0f);
+    clearPending = true;
+}
+
+void SoftRasterizer::AddSprite(bool textured, const SpriteInstance& instance) {
+    // 旋转后的包围盒，多留一个像素，精确的覆盖由逐像素测试决定
+    Sprite s;
+    s.instance = instance;
+    s.textured = textured && texLayers > 0;
+    s.cosA = std::cos(instance.angle);
+    s.sinA = std::sin(instance.angle);
+    float extent = quadHalf * (std::fabs(s.cosA) + std::fabs(s.sinA));
+    float sx = 2.0f / width, sy = 2.0f / height;
+    s.minX = std::max((int)std::floor((instance.x - extent + 1.0f) / sx - 0.5f) - 1, 0);
+    s.maxX = std::min((int)std::ceil((instance.x + extent + 1.0f) / sx - 0.5f) + 1, width - 1);
+    s.minY = std::max((int)std::floor((1.0f - instance.y - extent) / sy - 0.5f) - 1, 0);
+    s.maxY = std::min((int)std::ceil((1.0f - instance.y + extent) / sy - 0.5f) + 1, height - 1);
+    if (s.minX > s.maxX || s.minY > s.maxY) return;
+    sprites.push_back(s);
+}
+
+void SoftRasterizer::Flush() {
+    if (sprites.empty() && !clearPending) return;
+    for (std::vector<uint32_t>& bin : bins) bin.clear();
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        const Sprite& s = sprites[i];
+        for (int ty = s.minY / kTileSize; ty <= s.maxY / kTileSize; ++ty)
+            for (int tx = s.minX / kTileSize; tx <= s.maxX / kTileSize; ++tx)
+                bins[(size_t)ty * tilesX + tx].push_back((uint32_t)i);
+    }
+    size_t tileCount = bins.size();
+    auto job = [this](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) RasterTile((int)t);
+    };
+    if (pool) pool->ParallelFor(tileCount, 1, job);
+    else job(0, tileCount);
+    sprites.clear();
+    clearPending = false;
+}
+
+void SoftRasterizer::RasterTile(int tile) {
+    int x0 = (tile % tilesX) * kTileSize, y0 = (tile / tilesX) * kTileSize;
+    int x1 = std::min(x0 + kTileSize, width), y1 = std::min(y0 + kTileSize, height);
+    if (clearPending)
+        for (int y = y0; y < y1; ++y) std::fill(&pixels[(size_t)y * width + x0], &pixels[(size_t)y * width + x1], clearColor);
+
+    void (*span)(const SpanJob&, uint32_t*, int, int) = SpanScalar;
+#ifdef SNAKE_X86
+    if (isa == SSE2) span = SpanSse2;
+    if (isa == AVX2) span = SpanAvx2;
+#endif
+
+    float sx = 2.0f / width, sy = 2.0f / height;
+    float k = 0.5f / quadHalf;
+    for (uint32_t index : bins[tile]) {
+        const Sprite& s = sprites[index];
+        const SpriteInstance& in = s.instance;
+        float c = s.cosA, sn = s.sinA;
+        // 像素中心到精灵中心的 NDC 偏移 dx = x * sx + bx，逆旋转后缩放到 [0, 1)
+        float bx = 0.5f * sx - 1.0f - in.x;
+        SpanJob j;
+        j.ux = c * sx * k;
+        j.vx = sn * sx * k;
+        j.texels = nullptr;
+        j.texSize = texSize;
+        j.color = PackColor(in.r, in.g, in.b, in.a);
+        j.tw = j.tb = j.th = j.tv = j.maxT = 0.0f;
+        if (s.textured) {
+            int layer = std::min(std::max((int)in.layer, 0), texLayers - 1);
+            const float* r = &rects[(size_t)layer * 4];
+            j.texels = &texels[(size_t)layer * texSize * texSize];
+            j.tw = (r[2] - r[0]) * texSize;
+            j.tb = r[0] * texSize;
+            j.th = (r[3] - r[1]) * texSize;
+            j.tv = r[1] * texSize;
+            j.maxT = (float)(texSize - 1);
+        }
+        int rowMin = std::max(s.minY, y0), rowMax = std::min(s.maxY, y1 - 1);
+        int colMin = std::max(s.minX, x0), colMax = std::min(s.maxX, x1 - 1);
+        for (int y = rowMin; y <= rowMax; ++y) {
+            float dy = 1.0f - (y + 0.5f) * sy - in.y;
+            j.u0 = (c * bx - sn * dy) * k + 0.5f;
+            j.v0 = (sn * bx + c * dy) * k + 0.5f;
+            // 本行落在精灵里的列区间，两端各放宽一列，由逐像素测试裁掉；窄的精灵直接扫整个包围盒
+            if (colMax - colMin < 16) {
+                span(j, &pixels[(size_t)y * width], colMin, colMax + 1);
+                continue;
+            }
+            float lo = (float)colMin, hi = (float)colMax;
+            const float coef[2][2] = { { j.u0, j.ux }, { j.v0, j.vx } };
+            bool empty = false;
+            for (const auto& e : coef) {
+                if (std::fabs(e[1]) > 1e-12f) {
+                    float a = -e[0] / e[1], b = (1.0f - e[0]) / e[1];
+                    lo = std::max(lo, std::min(a, b) - 1.0f);
+                    hi = std::min(hi, std::max(a, b) + 1.0f);
+                }
+                else if (e[0] < 0.0f || e[0] >= 1.0f) {
+                    empty = true;
+                }
+            }
+            if (empty || lo > hi) continue;
+            int xa = std::max((int)std::floor(lo), colMin), xb = std::min((int)std::ceil(hi), colMax);
+            span(j, &pixels[(size_t)y * width], xa, xb + 1);
+        }
+    }
+}
+
+void SoftRasterizer::DrawLine(int x0, int y0, int x1, int y1, uint32_t color) {
+    int dx = std::abs(x1 - x0), dy = -std::abs(y1 - y0);
+    int stepX = x0 < x1 ? 1 : -1, stepY = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        if (x0 >= 0 && x0 < width && y0 >= 0 && y0 < height) pixels[(size_t)y0 * width + x0] = color;
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += stepX;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += stepY;
+        }
+    }
+}
+
+void SoftRasterizer::DrawBorder() {
+    Flush();
+    // 与 MapBorder 的顶点顺序相同：左下、右下、右上、左上
+    float xs[4] = { border[0], border[1], border[1], border[0] };
+    float ys[4] = { border[3], border[3], border[2], border[2] };
+    int px[4], py[4];
+    for (int i = 0; i < 4; ++i) {
+        px[i] = std::min(std::max((int)std::floor((xs[i] + 1.0f) * 0.5f * width), 0), width - 1);
+        py[i] = std::min(std::max((int)std::floor((1.0f - ys[i]) * 0.5f * height), 0), height - 1);
+    }
+    uint32_t white = PackColor(1.0f, 1.0f, 1.0f, 1.0f);
+    for (int i = 0; i < 4; ++i) DrawLine(px[i], py[i], px[(i + 1) % 4], py[(i + 1) % 4], white);
+}
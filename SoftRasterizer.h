@@ -0,0 +1,76 @@
+// SoftRasterizer.h
+#pragma once
+#include "Renderer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// CPU 渲染后端：按 64x64 像素分块，精灵先按包围盒分进各块，再由线程池逐块光栅化
+// 每块内按提交顺序画，块与块互不重叠，所以多线程与单线程的结果逐像素相同
+// 每行扫描由 AVX2（8 像素）、SSE2（4 像素）或标量实现，三者的浮点运算顺序一致，结果也逐像素相同
+// 与 GL 后端的差别：纹理只取第 0 级的最近纹素，线宽固定 1 像素；瓦片层（大地图的墙）不在这里画
+// 帧缓冲为 RGBA8，首行在上
+class SoftRasterizer : public Renderer {
+public:
+    enum Isa { SCALAR, SSE2, AVX2 };
+
+    // quadHalfSize 为精灵四边形的半边长（NDC），与精灵 VBO 一致；pool 为空时单线程
+    SoftRasterizer(int width, int height, float quadHalfSize, ThreadPool* pool = nullptr);
+
+    // 精灵纹理：atlas 为 .atlas 文件的内容，只取第 0 级
+    bool SetAtlas(const uint8_t* atlas, size_t size);
+    void SetBorder(float left, float right, float top, float bottom);
+    void SetQuadHalfSize(float half) { quadHalf = half; }
+
+    // 本机支持的最快实现；SetIsa 不能超过它
+    static Isa BestIsa();
+    void SetIsa(Isa isa);
+    Isa GetIsa() const { return isa; }
+
+    void BeginFrame(float r, float g, float b) override;
+    void AddSprite(bool textured, const SpriteInstance& instance) override;
+    void Flush() override;
+    void DrawBorder() override;
+    // Flush 和 DrawBorder 已经画完，这里什么也不做
+    void EndFrame() override {}
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    // Flush 之后有效
+    const uint32_t* Pixels() const { return pixels.data(); }
+
+    static const int kTileSize = 64;
+
+private:
+    struct Sprite {
+        SpriteInstance instance;
+        bool textured;
+        float cosA, sinA;
+        int minX, minY, maxX, maxY;     // 像素包围盒，含两端
+    };
+
+    void RasterTile(int tile);
+    void DrawLine(int x0, int y0, int x1, int y1, uint32_t color);
+
+    int width, height;
+    int tilesX, tilesY;
+    float quadHalf;
+    ThreadPool* pool;
+    Isa isa;
+
+    std::vector<uint32_t> pixels;
+    bool clearPending = false;
+    uint32_t clearColor = 0;
+
+    std::vector<Sprite> sprites;
+    std::vector<std::vector<uint32_t>> bins;    // 每块的精灵下标，按提交顺序
+
+    // 纹理：layers 张 texSize² 的 RGBA8，首行在下（与 GL 一致）
+    std::vector<uint32_t> texels;
+    std::vector<float> rects;                   // 每层 u0, v0, u1, v1
+    int texSize = 0, texLayers = 0;
+
+    float border[4] = { -0.9f, 0.9f, 0.9f, -0.9f };     // left, right, top, bottom
+};
@@ -0,0 +1,10 @@
+// Sprite.h
+#pragma once
+
+// 每个精灵实例的数据，对应精灵着色器 location 2/3；GL 与 CPU 渲染后端共用
+struct SpriteInstance {
+    float x, y;         // NDC 偏移
+    float angle;        // 旋转（弧度）
+    float layer;        // 纹理层，数组纹理时使用
+    float r, g, b, a;   // 纯色材质的颜色
+};
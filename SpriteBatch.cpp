@@ -0,0 +1,167 @@
+#include "SpriteBatch.h"
+#include "GlExt.h"
+#include <cstring>
+
+SpriteBatch::SpriteBatch(GLuint shaderProgram, GLuint quadVBO, size_t initialCapacity, GLenum target)
+    : program(shaderProgram), textureTarget(target), instanceVBO(0) {
+    useTexLoc = glGetUniformLocation(program, "useTexture");
+
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    // 四边形顶点：每个实例共用
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 实例属性：offset/angle/layer 与 color，每个实例前进一次
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    CreateBuffer(initialCapacity);
+    glBindVertexArray(0);
+}
+
+SpriteBatch::~SpriteBatch() {
+    DestroyBuffer();
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void SpriteBatch::CreateBuffer(size_t newCapacity) {
+    capacity = newCapacity;
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+    persistent = glExt.bufferStorage;
+    if (persistent) {
+        GLsizeiptr bytes = (GLsizeiptr)(capacity * kRingFrames * sizeof(SpriteInstance));
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glExt.BufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+        mapped = (SpriteInstance*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags);
+        persistent = mapped != nullptr;
+    }
+    if (!persistent) {
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+    }
+    ringIndex = 0;
+}
+
+void SpriteBatch::DestroyBuffer() {
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        mapped = nullptr;
+    }
+    glDeleteBuffers(1, &instanceVBO);
+    instanceVBO = 0;
+}
+
+void SpriteBatch::Begin() {
+    for (size_t i = 0; i < groupCount; ++i) groups[i].items.clear();
+    groupCount = 0;
+    lastGroup = 0;
+}
+
+void SpriteBatch::Add(GLuint texture, const SpriteInstance& instance) {
+    // 连续添加的精灵大多属于同一材质，先查上一次命中的分组
+    if (lastGroup < groupCount && groups[lastGroup].texture == texture) {
+        groups[lastGroup].items.push_back(instance);
+        return;
+    }
+    for (size_t i = 0; i < groupCount; ++i) {
+        if (groups[i].texture == texture) {
+            lastGroup = i;
+            groups[i].items.push_back(instance);
+            return;
+        }
+    }
+    if (groupCount == groups.size()) groups.push_back(Group());
+    lastGroup = groupCount++;
+    groups[lastGroup].texture = texture;
+    groups[lastGroup].items.push_back(instance);
+}
+
+// 取得本帧可写入的实例区域，返回其在缓冲中的起始实例号
+SpriteInstance* SpriteBatch::Reserve(size_t count, size_t& firstInstance) {
+    if (count > capacity) {
+        size_t newCapacity = capacity;
+        while (newCapacity < count) newCapacity *= 2;
+        DestroyBuffer();
+        CreateBuffer(newCapacity);
+        reallocations++;
+    }
+    if (!persistent) {
+        // 孤立旧存储，避免等待上一帧的绘制
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(SpriteInstance), nullptr, GL_STREAM_DRAW);
+        firstInstance = 0;
+        return nullptr;
+    }
+    GLsync& fence = fences[ringIndex];
+    if (fence) {
+        // 这一段三帧前提交过，GPU 读完之后才能覆盖
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    firstInstance = ringIndex * capacity;
+    return mapped + firstInstance;
+}
+
+void SpriteBatch::Flush(RenderQueue& queue) {
+    size_t total = 0;
+    for (size_t i = 0; i < groupCount; ++i) total += groups[i].items.size();
+    if (total == 0) return;
+
+    size_t firstInstance = 0;
+    SpriteInstance* dst = Reserve(total, firstInstance);
+    if (!dst) glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+    size_t cursor = firstInstance;
+    for (size_t i = 0; i < groupCount; ++i) {
+        const Group& group = groups[i];
+        size_t count = group.items.size();
+        if (count == 0) continue;
+
+        size_t bytes = count * sizeof(SpriteInstance);
+        if (dst) {
+            std::memcpy(dst, group.items.data(), bytes);
+            dst += count;
+        }
+        else {
+            glBufferSubData(GL_ARRAY_BUFFER, (cursor - firstInstance) * sizeof(SpriteInstance), bytes, group.items.data());
+        }
+
+        RenderCommand& c = queue.Add(PASS_SPRITES);
+        c.program = program;
+        c.vao = VAO;
+        c.texture = group.texture;
+        c.textureTarget = textureTarget;
+        c.count = 6;
+        c.instances = (GLsizei)count;
+        // GL 3.3 没有 baseInstance，通过属性指针的偏移选中本组实例
+        c.instanceBuffer = instanceVBO;
+        c.instanceOffset = cursor * sizeof(SpriteInstance);
+        c.instanceStride = sizeof(SpriteInstance);
+        c.instanceAttribs[0] = 4;       // offset/angle/layer
+        c.instanceAttribs[1] = 4;       // color
+        c.SetInt(useTexLoc, group.texture != 0);
+        cursor += count;
+    }
+    pendingFence = persistent;
+}
+
+void SpriteBatch::Fence() {
+    if (!pendingFence) return;
+    fences[ringIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ringIndex = (ringIndex + 1) % kRingFrames;
+    pendingFence = false;
+}
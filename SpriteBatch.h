@@ -0,0 +1,59 @@
+// SpriteBatch.h
+#pragma once
+#include <glad/glad.h>
+#include "Sprite.h"
+#include "RenderQueue.h"
+#include <vector>
+#include <cstddef>
+
+// 实例化精灵批次：同一材质（纹理）的所有四边形合并为一次 glDrawArraysInstanced
+// Flush 上传实例数据并为每个分组往 RenderQueue 里放一条命令；队列 Submit 之后调用 Fence
+class SpriteBatch {
+public:
+    // quadVBO 为 6 个顶点的四边形（aPos.xy, aTexCoord.xy）
+    // textureTarget 为 GL_TEXTURE_2D_ARRAY 时各精灵用 layer 选层，同一张数组纹理只占一个分组
+    SpriteBatch(GLuint shaderProgram, GLuint quadVBO, size_t initialCapacity = 1024, GLenum textureTarget = GL_TEXTURE_2D);
+    ~SpriteBatch();
+
+    void Begin();
+    // texture 为 0 时使用纯色
+    void Add(GLuint texture, const SpriteInstance& instance);
+    // 每次队列 Submit 之前最多 Flush 一次
+    void Flush(RenderQueue& queue);
+    // 本帧的命令提交之后调用，保护持久映射缓冲里刚写入的一段
+    void Fence();
+
+    bool Persistent() const { return persistent; }
+    // 实例缓冲重新分配的次数；GL 可能复用旧缓冲的名字，变了之后 GlStateCache 要 Invalidate
+    unsigned Reallocations() const { return reallocations; }
+
+private:
+    struct Group {
+        GLuint texture;
+        std::vector<SpriteInstance> items;
+    };
+
+    static const int kRingFrames = 3;
+
+    void CreateBuffer(size_t capacity);
+    void DestroyBuffer();
+    SpriteInstance* Reserve(size_t count, size_t& firstInstance);
+
+    GLuint program;
+    GLenum textureTarget;
+    GLuint VAO, instanceVBO;
+    GLint useTexLoc;
+
+    std::vector<Group> groups;
+    size_t groupCount = 0;
+    size_t lastGroup = 0;
+
+    // 实例缓冲：持久映射时划分为 kRingFrames 段轮流写入，每段用 fence 保护
+    bool persistent = false;
+    size_t capacity = 0;        // 每段可容纳的实例数
+    int ringIndex = 0;
+    SpriteInstance* mapped = nullptr;
+    GLsync fences[kRingFrames] = {};
+    bool pendingFence = false;
+    unsigned reallocations = 0;
+};
@@ -0,0 +1,33 @@
+// SpscQueue.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者的无锁环形队列，容量 N 必须是 2 的幂
+// 生产者只写 head，消费者只写 tail，两个下标分开放在不同的缓存行
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+public:
+    // 队列满时返回 false，不阻塞
+    bool Push(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N) return false;
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        item = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head{ 0 };
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    T items[N];
+};
@@ -0,0 +1,112 @@
+#include "TextureAtlas.h"
+#include "ThreadPool.h"
+#include "Vfs.h"
+#include "./external/stb/stb_image.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static double MsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TextureAtlas::~TextureAtlas() {
+    if (texture) glDeleteTextures(1, &texture);
+}
+
+int TextureAtlas::Layer(const char* name) const {
+    for (size_t i = 0; i < entries.size(); ++i)
+        if (std::strncmp(entries[i].name, name, sizeof(entries[i].name)) == 0) return (int)i;
+    return -1;
+}
+
+void TextureAtlas::Upload(const uint8_t* data, size_t bytes, int size, int levels) {
+    int layers = (int)entries.size();
+    if (texture) glDeleteTextures(1, &texture);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, Atlas::LevelCount(size) - 1);
+
+    // 像素先进 PBO，glTexImage3D 的数据指针是缓冲内的偏移，驱动可以异步拷贝
+    GLuint pbo;
+    glGenBuffers(1, &pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)bytes, nullptr, GL_STREAM_DRAW);
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (dst) {
+        std::memcpy(dst, data, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    else {
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes, data);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    size_t offset = 0;
+    for (int level = 0; level < levels; ++level) {
+        int edge = size >> level;
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, edge, edge, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, (void*)offset);
+        offset += Atlas::LevelBytes(size, layers, level);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(1, &pbo);
+    if (levels == 1) glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+bool TextureAtlas::LoadBaked(const uint8_t* data, size_t size) {
+    auto start = std::chrono::steady_clock::now();
+    const AtlasHeader* header;
+    const AtlasEntry* table;
+    if (!Atlas::Parse(data, size, header, table)) {
+        std::cerr << "图集文件无效" << std::endl;
+        return false;
+    }
+    entries.assign(table, table + header->layers);
+    size_t offset = Atlas::DataOffset((int)header->layers);
+    Upload(data + offset, size - offset, (int)header->size, (int)header->levels);
+    loadMs = MsSince(start);
+    return true;
+}
+
+bool TextureAtlas::LoadImages(Vfs& vfs, const std::vector<std::string>& names, int layerSize, ThreadPool& pool) {
+    auto start = std::chrono::steady_clock::now();
+    int layers = (int)names.size();
+    if (layers == 0 || layers > Atlas::kMaxLayers) return false;
+    entries.assign(layers, AtlasEntry());
+    std::vector<uint8_t> pixels(Atlas::LevelBytes(layerSize, layers, 0));
+    std::vector<char> failed(layers, 0);
+    size_t layerBytes = (size_t)layerSize * layerSize * 4;
+
+    // Vfs 只能在一个线程里用，先在这里取出所有文件；归档里的文件不拷贝
+    std::vector<Span> files(layers);
+    for (int i = 0; i < layers; ++i) {
+        files[i] = vfs.Read(names[i]);
+        size_t slash = names[i].find_last_of('/');
+        std::string name = slash == std::string::npos ? names[i] : names[i].substr(slash + 1);
+        std::strncpy(entries[i].name, name.c_str(), sizeof(entries[i].name) - 1);
+    }
+
+    // 每张图一块：解码、缩放都在线程池里，各写各的层
+    pool.ParallelFor((size_t)layers, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            int width, height, channels;
+            unsigned char* data = files[i] ? stbi_load_from_memory(files[i].data, (int)files[i].size, &width, &height, &channels, 4) : nullptr;
+            if (!data) {
+                failed[i] = 1;
+                continue;
+            }
+            Atlas::FitToLayer(data, width, height, layerSize, &pixels[layerBytes * i], entries[i]);
+            stbi_image_free(data);
+        }
+    });
+    for (int i = 0; i < layers; ++i)
+        if (failed[i]) std::cerr << "纹理加载失败: " << names[i] << std::endl;
+
+    Upload(pixels.data(), pixels.size(), layerSize, 1);
+    loadMs = MsSince(start);
+    return true;
+}
@@ -0,0 +1,41 @@
+// TextureAtlas.h
+#pragma once
+#include <glad/glad.h>
+#include "AtlasFormat.h"
+#include <string>
+#include <vector>
+
+class ThreadPool;
+class Vfs;
+
+// 精灵纹理：所有图片放进一张 GL_TEXTURE_2D_ARRAY，每张一层，整帧只绑定这一张纹理
+// LoadBaked 读 atlas_baker 烘焙好的 .atlas：整块拷进 PBO，各级 mip 直接从 PBO 上传，不解码也不生成 mip
+// LoadImages 是没有烘焙文件时的退路：图片在线程池上解码、缩放，主线程经 PBO 上传后 glGenerateMipmap
+class TextureAtlas {
+public:
+    TextureAtlas() = default;
+    ~TextureAtlas();
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // data 为整个 .atlas 文件的内容，通常是 Vfs 给出的映射内存
+    bool LoadBaked(const uint8_t* data, size_t size);
+    // names 为 Vfs 中的路径，层名取其中的文件名；解码失败的图片留下透明的一层，其余照常加载
+    bool LoadImages(Vfs& vfs, const std::vector<std::string>& names, int layerSize, ThreadPool& pool);
+
+    GLuint Texture() const { return texture; }
+    int LayerCount() const { return (int)entries.size(); }
+    // 按文件名（如 "food.png"）查层号，找不到时返回 -1
+    int Layer(const char* name) const;
+    // 第 i 层的 UV 范围
+    const AtlasEntry& Entry(int i) const { return entries[i]; }
+    double LoadMs() const { return loadMs; }
+
+private:
+    // data 为全部 mip 级的像素，levels 为 1 时由驱动生成其余各级
+    void Upload(const uint8_t* data, size_t bytes, int size, int levels);
+
+    GLuint texture = 0;
+    std::vector<AtlasEntry> entries;
+    double loadMs = 0.0;
+};
@@ -0,0 +1,88 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    queuesStorage.reset(new Queue[threads]);
+    for (unsigned i = 0; i < threads; ++i) queues.push_back(&queuesStorage[i]);
+    // 0 号队列属于调用 ParallelFor 的线程
+    for (unsigned i = 1; i < threads; ++i) workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+void ThreadPool::RunChunks(unsigned self) {
+    unsigned n = Size();
+    for (unsigned k = 0; k < n; ++k) {
+        // 先做自己的，再按顺序偷别人的
+        Queue& q = *queues[(self + k) % n];
+        for (;;) {
+            size_t chunk = q.next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= q.end) break;
+            size_t begin = chunk * jobGrain;
+            size_t end = begin + jobGrain < jobCount ? begin + jobGrain : jobCount;
+            (*job)(begin, end);
+            chunksLeft.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop(unsigned index) {
+    unsigned long long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            busyWorkers.fetch_add(1, std::memory_order_relaxed);
+        }
+        RunChunks(index);
+        busyWorkers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    size_t chunks = (count + grain - 1) / grain;
+    unsigned n = Size();
+    if (n == 1 || chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        // 上一轮的线程可能还在 RunChunks 的尾部检查队列，等它们全部退出再改共享状态；
+        // 线程进入 RunChunks 前要先拿锁登记，所以拿着锁看到 0 就不会再有人读旧状态
+        std::unique_lock<std::mutex> lock(mutex);
+        while (busyWorkers.load(std::memory_order_acquire) != 0) {
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+        job = &fn;
+        jobCount = count;
+        jobGrain = grain;
+        chunksLeft.store(chunks, std::memory_order_relaxed);
+        size_t begin = 0;
+        for (unsigned i = 0; i < n; ++i) {
+            size_t share = chunks / n + (i < chunks % n ? 1 : 0);
+            queues[i]->next.store(begin, std::memory_order_relaxed);
+            queues[i]->end = begin + share;
+            begin += share;
+        }
+        generation++;
+    }
+    wake.notify_all();
+
+    RunChunks(0);
+    while (chunksLeft.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+}
@@ -0,0 +1,52 @@
+// ThreadPool.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻线程池，只提供一个 ParallelFor
+// 任务按 grain 切块后平均分给各线程；线程做完自己的块就去别的线程那里偷，
+// 调用线程自己也参与计算，ParallelFor 返回时所有块都已完成
+// 同一时间只能有一个线程调用 ParallelFor
+class ThreadPool {
+public:
+    // threads 为 0 时使用全部硬件线程
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned Size() const { return (unsigned)queues.size(); }
+
+    // fn(begin, end) 处理 [begin, end)
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    // 每个线程一段连续的块号，next 只会被 fetch_add，所以偷取不会重复执行
+    struct alignas(64) Queue {
+        std::atomic<size_t> next{ 0 };
+        size_t end = 0;
+    };
+
+    void WorkerLoop(unsigned index);
+    void RunChunks(unsigned self);
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queuesStorage;
+    std::vector<Queue*> queues;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    unsigned long long generation = 0;
+    bool stopping = false;
+
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t jobCount = 0, jobGrain = 1;
+    std::atomic<size_t> chunksLeft{ 0 };
+    std::atomic<unsigned> busyWorkers{ 0 };
+};
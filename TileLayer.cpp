@@ -0,0 +1,115 @@
+#include "TileLayer.h"
+
+// 块内坐标加上块原点相对相机的偏移，偏移在 CPU 上用 double 算好，
+// 10 万格外的块也不会因为 float 精度抖动
+static const char* tileVertexSource = R"(
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 2) in vec2 aCell;
+
+uniform vec2 chunkOffset;   // 块原点相对相机中心，单位为格
+uniform float cellScale;    // 每格的 NDC 尺寸
+
+void main() {
+    gl_Position = vec4((aCell + chunkOffset + 0.5) * cellScale + aPos, 0.0, 1.0);
+}
+)";
+
+static const char* tileFragmentSource = R"(
+#version 330 core
+out vec4 FragColor;
+uniform vec4 color;
+
+void main() {
+    FragColor = color;
+}
+)";
+
+TileLayer::TileLayer(GLuint quadVBO, ShaderManager& shaderManager) : shaders(shaderManager) {
+    shader = shaders.AddSource("tile", tileVertexSource, tileFragmentSource);
+
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // 实例属性：块内坐标，缓冲在绘制每一块时切换
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+}
+
+TileLayer::~TileLayer() {
+    Clear();
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void TileLayer::Clear() {
+    for (auto& kv : chunks)
+        if (kv.second.vbo) glDeleteBuffers(1, &kv.second.vbo);
+    chunks.clear();
+    uploaded = 0;
+}
+
+void TileLayer::AddTile(Vec2i cell) {
+    Chunk& chunk = chunks[Key(cell.x >> kShift, cell.y >> kShift)];
+    chunk.cells.push_back((float)(cell.x & (kSize - 1)));
+    chunk.cells.push_back((float)(cell.y & (kSize - 1)));
+}
+
+void TileLayer::AddBorder(int width, int height) {
+    for (int x = 0; x < width; ++x) {
+        AddTile({ x, 0 });
+        AddTile({ x, height - 1 });
+    }
+    for (int y = 1; y < height - 1; ++y) {
+        AddTile({ 0, y });
+        AddTile({ width - 1, y });
+    }
+}
+
+void TileLayer::Draw(RenderQueue& queue, double cameraX, double cameraY, float cellSize, int minX, int minY, int maxX, int maxY) {
+    drawCalls = 0;
+    GLuint program = shaders.Program(shader);
+    if (!program) return;
+    if (program != cachedProgram) {
+        // 位置只在换了程序时查询一次
+        offsetLoc = shaders.Uniform(shader, "chunkOffset");
+        scaleLoc = shaders.Uniform(shader, "cellScale");
+        colorLoc = shaders.Uniform(shader, "color");
+        cachedProgram = program;
+    }
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX < minX || maxY < minY) return;
+
+    for (int cy = minY >> kShift; cy <= maxY >> kShift; ++cy) {
+        for (int cx = minX >> kShift; cx <= maxX >> kShift; ++cx) {
+            auto it = chunks.find(Key(cx, cy));
+            if (it == chunks.end()) continue;
+            Chunk& chunk = it->second;
+            if (!chunk.vbo) {
+                // 第一次进入视野：上传后 CPU 端的数据只留个数
+                glGenBuffers(1, &chunk.vbo);
+                glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+                glBufferData(GL_ARRAY_BUFFER, chunk.cells.size() * sizeof(float), chunk.cells.data(), GL_STATIC_DRAW);
+                chunk.count = (GLsizei)(chunk.cells.size() / 2);
+                std::vector<float>().swap(chunk.cells);
+                uploaded++;
+            }
+            // 缩放和颜色每块都一样，只有第一块真正上传，之后由状态缓存跳过
+            RenderCommand& c = queue.Add(PASS_WALLS);
+            c.program = program;
+            c.vao = VAO;
+            c.count = 6;
+            c.instances = chunk.count;
+            c.instanceBuffer = chunk.vbo;
+            c.instanceStride = 2 * sizeof(float);
+            c.instanceAttribs[0] = 2;
+            c.SetFloat(scaleLoc, cellSize);
+            c.SetVec4(colorLoc, 0.85f, 0.85f, 0.85f, 1.0f);
+            c.SetVec2(offsetLoc, (float)((double)cx * kSize - cameraX), (float)((double)cy * kSize - cameraY));
+            drawCalls++;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// TileLayer.h
+#pragma once
+#include <glad/glad.h>
+#include "SnakeBody.h"
+#include "RenderQueue.h"
+#include "ShaderManager.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// 静态地图（墙、障碍）的分块瓦片层
+// 瓦片按 64x64 格分块，每块一个只存块内坐标的实例缓冲，第一次进入视野时上传，之后不再改动
+// 每帧只画与视野相交的块，开销取决于屏幕上能看到的块数，与地图大小无关
+class TileLayer {
+public:
+    static const int kShift = 6;
+    static const int kSize = 1 << kShift;
+
+    // quadVBO 与 SpriteBatch 共用（aPos.xy, aTexCoord.xy）
+    // 着色器登记到 shaders 里，须在 shaders.Submit() 之前构造；程序在 Finish 之后才能用，之前的 Draw 什么也不画
+    TileLayer(GLuint quadVBO, ShaderManager& shaders);
+    ~TileLayer();
+
+    void Clear();
+    // 须在该块第一次 Draw 之前添加
+    void AddTile(Vec2i cell);
+    // 棋盘外圈一格的墙
+    void AddBorder(int width, int height);
+
+    // 相机中心 (cameraX, cameraY) 以格为单位，cellSize 为每格的 NDC 尺寸
+    // 只为与 [minX, maxX] x [minY, maxY] 相交的块往队列里放命令（PASS_WALLS），每块一条
+    void Draw(RenderQueue& queue, double cameraX, double cameraY, float cellSize, int minX, int minY, int maxX, int maxY);
+
+    size_t ChunkCount() const { return chunks.size(); }
+    size_t UploadedChunks() const { return uploaded; }
+    unsigned DrawCalls() const { return drawCalls; }
+
+private:
+    struct Chunk {
+        std::vector<float> cells;   // 块内坐标 x, y 交错，上传后释放
+        GLuint vbo = 0;
+        GLsizei count = 0;
+    };
+
+    static uint64_t Key(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+
+    std::unordered_map<uint64_t, Chunk> chunks;
+    ShaderManager& shaders;
+    ShaderManager::Handle shader;
+    GLuint cachedProgram = 0, VAO;
+    GLint offsetLoc = -1, scaleLoc = -1, colorLoc = -1;
+    size_t uploaded = 0;
+    unsigned drawCalls = 0;
+};
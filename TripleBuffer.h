@@ -0,0 +1,33 @@
+// TripleBuffer.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// 无锁三缓冲：写端总有一份可写，读端总能拿到最新发布的一份，双方都不等待
+// 三个槽位的下标里，写端持有 back，读端持有 front，中间一份放在 state 里，
+// 交换时用一个原子 exchange，最高位标记中间这份是否比读端手里的新
+template <typename T>
+class TripleBuffer {
+public:
+    // 写端
+    T& Back() { return slots[back]; }
+    void Publish() {
+        back = state.exchange((uint8_t)(back | kFresh), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // 读端：有新发布的数据时换到手里，返回是否换过
+    bool Update() {
+        if (!(state.load(std::memory_order_relaxed) & kFresh)) return false;
+        front = state.exchange(front, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+    const T& Front() const { return slots[front]; }
+
+private:
+    static const uint8_t kFresh = 0x80;
+    static const uint8_t kIndexMask = 0x03;
+
+    T slots[3];
+    std::atomic<uint8_t> state{ 1 };
+    uint8_t back = 0, front = 2;
+};
@@ -0,0 +1,83 @@
+#include "Vfs.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+bool Vfs::Mount(const char* archivePath) {
+    header = nullptr;
+    entries = nullptr;
+    names = nullptr;
+    checked.clear();
+    stats.fileOpens++;
+    if (!archive.Open(archivePath)) return false;
+    if (!AssetPack::Parse(archive.Data(), archive.Size(), header, entries, names)) {
+        std::cerr << "资源包无效: " << archivePath << std::endl;
+        header = nullptr;
+        archive.Close();
+        return false;
+    }
+    checked.assign(header->count, 0);
+    return true;
+}
+
+std::string Vfs::OverlayPath(const std::string& name) const {
+    if (overlay.empty()) return std::string();
+    std::string path = overlay + "/" + name;
+    std::error_code ec;
+    return fs::is_regular_file(path, ec) ? path : std::string();
+}
+
+bool Vfs::Check(int index) {
+    if (checked[index] == 0) {
+        const PakEntry& e = entries[index];
+        bool ok = AssetPack::Crc32(archive.Data() + e.offset, (size_t)e.size) == e.crc;
+        checked[index] = ok ? 1 : 2;
+        if (!ok) {
+            stats.checksumFailures++;
+            std::cerr << "资源校验失败: " << std::string(names + e.nameOffset, e.nameLength) << std::endl;
+        }
+    }
+    return checked[index] == 1;
+}
+
+Span Vfs::Read(const std::string& name) {
+    Span span;
+    std::string path = OverlayPath(name);
+    if (!path.empty()) {
+        FILE* f = std::fopen(path.c_str(), "rb");
+        if (f) {
+            stats.fileOpens++;
+            std::vector<uint8_t>& bytes = overlayFiles[name];
+            std::fseek(f, 0, SEEK_END);
+            long size = std::ftell(f);
+            std::fseek(f, 0, SEEK_SET);
+            bytes.resize(size > 0 ? (size_t)size : 0);
+            bool ok = size >= 0 && std::fread(bytes.data(), 1, bytes.size(), f) == bytes.size();
+            std::fclose(f);
+            if (ok) {
+                stats.overlayReads++;
+                // 空文件也要返回非空指针
+                static const uint8_t empty = 0;
+                span.data = bytes.empty() ? &empty : bytes.data();
+                span.size = bytes.size();
+                return span;
+            }
+        }
+    }
+    if (!header) return span;
+    int index = AssetPack::Find(*header, entries, names, name);
+    if (index < 0 || !Check(index)) return span;
+    stats.archiveReads++;
+    span.data = archive.Data() + entries[index].offset;
+    span.size = (size_t)entries[index].size;
+    return span;
+}
+
+unsigned Vfs::VerifyAll() {
+    unsigned failures = 0;
+    for (int i = 0; i < (int)EntryCount(); ++i)
+        if (!Check(i)) failures++;
+    return failures;
+}
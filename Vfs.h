@@ -0,0 +1,62 @@
+// Vfs.h
+#pragma once
+#include "AssetPack.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// 一段只读数据，不拥有内存
+struct Span {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+    std::string Str() const { return std::string((const char*)data, size); }
+};
+
+// 资源文件系统：映射一个 .pak，按名字返回指向映射内存的 Span，不拷贝
+// 设置覆盖目录后，目录里存在的同名文件优先，开发时改了资源不用重新打包
+// 每项的 CRC32 在第一次读取时校验，校验失败的项当作不存在
+// 只能在一个线程里使用
+class Vfs {
+public:
+    struct Stats {
+        unsigned fileOpens = 0;     // 打开归档与覆盖文件的次数
+        unsigned archiveReads = 0;
+        unsigned overlayReads = 0;
+        unsigned checksumFailures = 0;
+    };
+
+    // 一次 open + 一次 mmap，之后读取不再有文件 I/O
+    bool Mount(const char* archivePath);
+    bool Mounted() const { return header != nullptr; }
+    void SetOverlay(const std::string& dir) { overlay = dir; }
+    bool HasOverlay() const { return !overlay.empty(); }
+
+    // 找不到时返回空 Span；覆盖文件的 Span 在同名文件下次读取前有效，归档的 Span 在 Vfs 销毁前有效
+    Span Read(const std::string& name);
+    // 覆盖目录里存在该文件时返回它的路径（用于热重载），否则返回空字符串
+    std::string OverlayPath(const std::string& name) const;
+
+    unsigned EntryCount() const { return header ? header->count : 0; }
+    std::string EntryName(int i) const { return std::string(names + entries[i].nameOffset, entries[i].nameLength); }
+    // 校验全部项，返回失败的个数
+    unsigned VerifyAll();
+
+    const Stats& GetStats() const { return stats; }
+
+private:
+    bool Check(int index);
+
+    MappedFile archive;
+    const PakHeader* header = nullptr;
+    const PakEntry* entries = nullptr;
+    const char* names = nullptr;
+    std::vector<char> checked;          // 0 未校验，1 通过，2 失败
+    std::string overlay;
+    std::map<std::string, std::vector<uint8_t>> overlayFiles;
+    Stats stats;
+};
@@ -0,0 +1,110 @@
+// RenderScenes.h
+#pragma once
+#include "../RenderQueue.h"
+#include "../GlApiMock.h"
+#include <functional>
+#include <vector>
+
+// 基准程序和 snake_tests 共用的几种典型帧：命令的内容照搬 SpriteBatch / TileLayer / MapBorder 的写法，GL 对象名是假的
+// 每帧应该发出多少次调用由 tests/render_tests.cpp 核对，基准程序只报告
+enum : GLuint { SPRITE_PROGRAM = 3, BORDER_PROGRAM = 4, TILE_PROGRAM = 5, PARTICLE_PROGRAM = 6 };
+enum : GLuint { SPRITE_VAO = 1, BORDER_VAO = 2, TILE_VAO = 3, PARTICLE_VAO = 4 };
+enum : GLuint { ATLAS = 1, INSTANCE_VBO = 7 };
+const GLint kUseTexture = 0, kBorderColor = 0, kScale = 0, kColor = 1, kOffset = 2, kCamera = 1;
+
+inline void SpriteGroup(RenderQueue& q, GLuint texture, size_t first, GLsizei count) {
+    RenderCommand& c = q.Add(PASS_SPRITES);
+    c.program = SPRITE_PROGRAM;
+    c.vao = SPRITE_VAO;
+    c.texture = texture;
+    c.textureTarget = GL_TEXTURE_2D_ARRAY;
+    c.count = 6;
+    c.instances = count;
+    c.instanceBuffer = INSTANCE_VBO;
+    c.instanceOffset = first * 32;
+    c.instanceStride = 32;
+    c.instanceAttribs[0] = 4;
+    c.instanceAttribs[1] = 4;
+    c.SetInt(kUseTexture, texture != 0);
+}
+
+inline void Border(RenderQueue& q) {
+    RenderCommand& c = q.Add(PASS_OVERLAY);
+    c.program = BORDER_PROGRAM;
+    c.vao = BORDER_VAO;
+    c.mode = GL_LINE_LOOP;
+    c.count = 4;
+    c.lineWidth = 3.0f;
+    c.SetVec3(kBorderColor, 1.0f, 1.0f, 1.0f);
+}
+
+inline void WallChunk(RenderQueue& q, GLuint vbo, float x, float y) {
+    RenderCommand& c = q.Add(PASS_WALLS);
+    c.program = TILE_PROGRAM;
+    c.vao = TILE_VAO;
+    c.count = 6;
+    c.instances = 64;
+    c.instanceBuffer = vbo;
+    c.instanceStride = 8;
+    c.instanceAttribs[0] = 2;
+    c.SetFloat(kScale, 0.1f);
+    c.SetVec4(kColor, 0.85f, 0.85f, 0.85f, 1.0f);
+    c.SetVec2(kOffset, x, y);
+}
+
+// ParticleLayer：属性指针固定在 VAO 里，命令不带实例缓冲
+inline void Particles(RenderQueue& q, GLsizei count) {
+    RenderCommand& c = q.Add(PASS_PARTICLES);
+    c.program = PARTICLE_PROGRAM;
+    c.vao = PARTICLE_VAO;
+    c.count = 6;
+    c.instances = count;
+    c.SetVec2(kCamera, 10.0f, 10.0f);
+    c.SetFloat(kScale, 0.1f);
+}
+
+// 一个场景是一串命令，每个函数往队列里添加一条
+struct Scene {
+    const char* name;
+    std::vector<std::function<void(RenderQueue&)>> commands;
+};
+
+inline void Build(const Scene& scene, RenderQueue& q) {
+    for (auto& add : scene.commands) add(q);
+}
+
+inline std::vector<Scene> Scenes() {
+    std::vector<Scene> scenes;
+    {
+        // 菜单：几块纯色方块
+        Scene s{ "menu", { [](RenderQueue& q) { SpriteGroup(q, 0, 0, 3); } } };
+        scenes.push_back(s);
+    }
+    {
+        // 普通棋盘：一组带纹理的蛇和食物，加上边框
+        Scene s{ "game", { [](RenderQueue& q) { SpriteGroup(q, ATLAS, 0, 40); }, Border } };
+        scenes.push_back(s);
+    }
+    {
+        // 普通棋盘加上吃到食物时炸开的粒子，相机固定在棋盘中心
+        Scene s{ "particles", { [](RenderQueue& q) { SpriteGroup(q, ATLAS, 0, 40); }, Border, [](RenderQueue& q) { Particles(q, 48); } } };
+        scenes.push_back(s);
+    }
+    {
+        // 大地图：蛇加上视野里的 4 块墙，每块墙只有偏移不同
+        Scene s{ "large arena", { [](RenderQueue& q) { SpriteGroup(q, ATLAS, 0, 400); } } };
+        for (int i = 0; i < 4; ++i)
+            s.commands.push_back([i](RenderQueue& q) { WallChunk(q, 20 + i, -10.0f + i, 5.0f); });
+        scenes.push_back(s);
+    }
+    {
+        // 添加顺序交错：边框、纯色和带纹理的精灵、墙穿插着添加，排序后每个程序只切换一次
+        Scene s{ "interleaved", { Border } };
+        for (int i = 0; i < 8; ++i) {
+            s.commands.push_back([i](RenderQueue& q) { SpriteGroup(q, i % 2 ? (GLuint)ATLAS : 0u, i * 10, 10); });
+            s.commands.push_back([i](RenderQueue& q) { WallChunk(q, 20 + i, (float)i, 0.0f); });
+        }
+        scenes.push_back(s);
+    }
+    return scenes;
+}
@@ -0,0 +1,97 @@
+// 大地图基准：100k x 100k 棋盘上，蛇长从 1000 到 1,000,000
+// 对比逐节遍历整条蛇与按分块索引只取视野内的节，以及每 tick 维护索引的开销
+#include "../SnakeSim.h"
+#include "../BodyChunks.h"
+#include <chrono>
+#include <cstdio>
+
+using Clock = std::chrono::steady_clock;
+
+static const int kArena = 100000;
+static const int kView = 22;        // 一屏 20 格加两侧各一格余量
+static const int kBlock = 1024;     // 蛇身按 kBlock 宽的蛇形排布
+
+// 第 k 节在蛇形排布中的位置，相邻的 k 一定是相邻格
+static Vec2i SerpentineCell(size_t k) {
+    int row = (int)(k / kBlock), col = (int)(k % kBlock);
+    if (row % 2) col = kBlock - 1 - col;
+    return { kArena / 4 + col, kArena / 4 + row };
+}
+
+template <typename Fn>
+static double Measure(Fn fn, double budget) {
+    unsigned long long n = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        fn(n++);
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < budget);
+    return elapsed * 1e9 / n;
+}
+
+int main() {
+    const size_t lengths[] = { 1000, 10000, 100000, 1000000 };
+    volatile size_t sink = 0;
+
+    std::printf("%10s %8s %16s %16s %12s %14s\n",
+        "length", "chunks", "full walk ns", "culled ns", "visible", "index ns/tick");
+    for (size_t length : lengths) {
+        SnakeBody body(length + 1);
+        BodyChunks chunks;
+        for (size_t k = 0; k < length; ++k) {
+            body.PushFront(SerpentineCell(k));
+            chunks.Insert(body.Front(), body.Serial(0));
+        }
+        Vec2i head = body.Front();
+        int minX = head.x - kView / 2, minY = head.y - kView / 2;
+        int maxX = minX + kView, maxY = minY + kView;
+
+        // 原来的画法：每节都算一遍位置再判断是否在屏幕上
+        double fullNs = Measure([&](unsigned long long) {
+            size_t visible = 0;
+            for (size_t i = 0; i < body.Size(); ++i) {
+                Vec2i c = body[i];
+                if (c.x >= minX && c.x <= maxX && c.y >= minY && c.y <= maxY) visible++;
+            }
+            sink = sink + visible;
+        }, 0.3);
+
+        size_t visible = 0;
+        double culledNs = Measure([&](unsigned long long) {
+            visible = 0;
+            chunks.ForEachInRect(minX, minY, maxX, maxY, [&](const BodyChunks::Entry& e) {
+                visible += body.IndexOfSerial(e.serial) < body.Size();
+            });
+            sink = sink + visible;
+        }, 0.3);
+
+        // 沿蛇形继续前进：每 tick 进一格出一格
+        size_t next = length;
+        double tickNs = Measure([&](unsigned long long) {
+            for (int i = 0; i < 64; ++i) {
+                chunks.RemoveOldest(body.Back());
+                body.BeginTick();
+                body.PushFront(SerpentineCell(next++));
+                body.PopBack();
+                chunks.Insert(body.Front(), body.Serial(0));
+            }
+        }, 0.3) / 64;
+
+        std::printf("%10zu %8zu %16.0f %16.0f %12zu %14.1f\n",
+            length, chunks.ChunkCount(), fullNs, culledNs, visible, tickNs);
+    }
+
+    // 整个 SnakeSim 在 100k x 100k 棋盘上：不建整张位图，食物拒绝采样
+    auto start = Clock::now();
+    SnakeSim sim(kArena, kArena, 7);
+    double createMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    static const Vec2i loop[4] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+    double simNs = Measure([&](unsigned long long n) {
+        if (n % 16 == 0) sim.QueueDirection(loop[(n / 16) % 4]);
+        sim.Step();
+    }, 0.3);
+    std::printf("SnakeSim %dx%d: create %.2f ms, %.1f ns/tick, alive=%d\n",
+        kArena, kArena, createMs, simNs, (int)sim.Alive());
+    return 0;
+}
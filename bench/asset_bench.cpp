@@ -0,0 +1,77 @@
+// 资源加载基准：逐个打开散文件读取，与映射一次资源包后按名字取数据的对比
+// 用法: asset_bench [assets.pak] [资源根目录] [轮数]
+// 两种方式都读完包里的每个文件并算一遍 CRC32，页缓存是热的，比较的是系统调用和查找的开销
+#include "../Vfs.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double MicrosSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const char* pakPath = argc > 1 ? argv[1] : "assets.pak";
+    std::string root = argc > 2 ? argv[2] : "..";
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    Vfs probe;
+    if (!probe.Mount(pakPath)) {
+        std::fprintf(stderr, "%s: cannot open, build the pack_assets target first\n", pakPath);
+        return 1;
+    }
+    // 只比较资源根目录里也存在的文件（烘焙出的图集只在包里）
+    std::vector<std::string> names;
+    for (int i = 0; i < (int)probe.EntryCount(); ++i) {
+        std::string name = probe.EntryName(i);
+        FILE* f = std::fopen((root + "/" + name).c_str(), "rb");
+        if (!f) continue;
+        std::fclose(f);
+        names.push_back(name);
+    }
+    if (names.empty()) {
+        std::fprintf(stderr, "%s: none of the packed files exist here\n", root.c_str());
+        return 1;
+    }
+
+    uint32_t sink = 0;
+    size_t bytes = 0;
+    std::vector<uint8_t> buffer;
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const std::string& name : names) {
+            FILE* f = std::fopen((root + "/" + name).c_str(), "rb");
+            std::fseek(f, 0, SEEK_END);
+            long size = std::ftell(f);
+            std::fseek(f, 0, SEEK_SET);
+            buffer.resize((size_t)size);
+            size_t got = std::fread(buffer.data(), 1, buffer.size(), f);
+            std::fclose(f);
+            sink += AssetPack::Crc32(buffer.data(), got);
+            if (r == 0) bytes += got;
+        }
+    }
+    double looseUs = MicrosSince(start) / rounds;
+
+    unsigned opens = 0;
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        Vfs vfs;
+        vfs.Mount(pakPath);
+        for (const std::string& name : names) {
+            Span span = vfs.Read(name);
+            sink += (uint32_t)span.size;
+        }
+        opens = vfs.GetStats().fileOpens;
+    }
+    double packUs = MicrosSince(start) / rounds;
+
+    std::printf("%zu files, %zu bytes per load (sink %08x)\n", names.size(), bytes, sink);
+    std::printf("loose files : %8.1f us/load, %zu opens\n", looseUs, names.size());
+    std::printf("assets.pak  : %8.1f us/load, %u open + 1 mmap (checksums verified on first read)\n", packUs, opens);
+    return 0;
+}
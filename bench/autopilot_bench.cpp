@@ -0,0 +1,72 @@
+// 自动驾驶基准：20x20、256x256、2048x2048 棋盘上的路径查询速度
+// “查询”为强制重新搜索；“tick”为带路径复用的正常驾驶
+#include "../Autopilot.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> allocCount{ 0 };
+
+void* operator new(std::size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+// 驾驶 ticks 步，返回耗时（秒）；forceSearch 时每步都丢弃缓存的路径
+static double Drive(SnakeSim& sim, Autopilot& pilot, unsigned long long ticks, bool forceSearch,
+    unsigned long long& deaths, size_t& maxLength) {
+    auto start = Clock::now();
+    for (unsigned long long i = 0; i < ticks; ++i) {
+        if (forceSearch) pilot.Invalidate();
+        Vec2i d = pilot.NextDirection(sim);
+        if (!(d == sim.Direction())) sim.QueueDirection(d);
+        if (sim.Step() == DIED) {
+            deaths++;
+            sim.Reset();
+        }
+        else if (sim.Food().x < 0) {
+            sim.Reset();    // 填满了棋盘
+        }
+        if (sim.Body().Size() > maxLength) maxLength = sim.Body().Size();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main() {
+    struct Board { int size; unsigned long long ticks; };
+    const Board boards[] = { { 20, 200000 }, { 256, 20000 }, { 2048, 2000 } };
+
+    std::printf("%10s %16s %14s %14s %12s %10s %8s\n",
+        "board", "queries/sec", "ticks/sec", "reuse rate", "allocs/tick", "max len", "deaths");
+    for (const Board& b : boards) {
+        SnakeSim sim(b.size, b.size, 2024);
+        Autopilot pilot(b.size, b.size);
+        unsigned long long deaths = 0;
+        size_t maxLength = 0;
+
+        unsigned long long searchesBefore = pilot.Searches();
+        double forced = Drive(sim, pilot, b.ticks / 4, true, deaths, maxLength);
+        double queriesPerSec = (pilot.Searches() - searchesBefore) / forced;
+
+        sim.Reset();
+        pilot.Invalidate();
+        unsigned long long reusedBefore = pilot.Reused();
+        unsigned long long allocsBefore = allocCount.load();
+        double normal = Drive(sim, pilot, b.ticks, false, deaths, maxLength);
+        double allocsPerTick = (double)(allocCount.load() - allocsBefore) / b.ticks;
+        double reuseRate = (double)(pilot.Reused() - reusedBefore) / b.ticks;
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "%dx%d", b.size, b.size);
+        std::printf("%10s %16.0f %14.0f %13.1f%% %12.4f %10zu %8llu\n",
+            name, queriesPerSec, b.ticks / normal, reuseRate * 100.0, allocsPerTick, maxLength, deaths);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// 批量环境基准：线程数从 1 到全部核心时的吞吐量
+// 先与 SnakeSim 逐步对照，确认两边的规则一致
+// 用法: batch_env_bench [局数] [步数] [最大线程数]
+#include "../BatchEnv.h"
+#include "../SnakeSim.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const Vec2i kDirs[4] = { { 0, 1 }, { 0, -1 }, { -1, 0 }, { 1, 0 } };
+
+// 预先生成一批动作循环使用，避免把生成动作的开销算进去
+static std::vector<int8_t> MakeActions(size_t count, size_t steps) {
+    std::vector<int8_t> actions(count * steps);
+    Rng rng(7);
+    for (int8_t& a : actions) {
+        uint64_t r = rng.Below(8);
+        a = r < 4 ? (int8_t)r : BatchEnv::kKeep;
+    }
+    return actions;
+}
+
+static bool CrossCheck() {
+    const size_t steps = 200000;
+    BatchEnv env(1, 20, 20, 99);
+    SnakeSim sim(20, 20, env.Seeds()[0]);
+    std::vector<int8_t> actions = MakeActions(1, steps);
+    for (size_t i = 0; i < steps; ++i) {
+        int8_t a = actions[i];
+        SimInput input;
+        if (a >= 0) input.dir = kDirs[a];
+        bool died = sim.Step(input) == DIED;
+        if (died) sim.Reset();
+        env.StepBatch(&a);
+
+        Vec2i food = sim.Food();
+        uint8_t envFood = food.x < 0 ? 0 : env.Observations()[food.y * 20 + food.x];
+        if (died != (env.Dones()[0] != 0) || env.Lengths()[0] != sim.Body().Size() ||
+            env.Seeds()[0] != sim.Seed() || (food.x >= 0 && envFood != BatchEnv::FOOD)) {
+            std::printf("cross-check FAILED at step %zu\n", i);
+            return false;
+        }
+    }
+    std::printf("cross-check with SnakeSim: %zu steps ok\n", steps);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16384;
+    size_t steps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 400;
+    if (!CrossCheck()) return 1;
+
+    const size_t actionSteps = 64;
+    std::vector<int8_t> actions = MakeActions(count, actionSteps);
+    unsigned hw = argc > 3 ? (unsigned)std::atoi(argv[3]) : std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+
+    std::printf("envs: %zu (20x20), steps: %zu\n", count, steps);
+    std::printf("%8s %16s %12s %12s %18s\n", "threads", "env-steps/sec", "speedup", "efficiency", "checksum");
+    double base = 0.0;
+    for (unsigned threads = 1; threads <= hw; threads = threads < hw && threads * 2 > hw ? hw : threads * 2) {
+        ThreadPool pool(threads);
+        BatchEnv env(count, 20, 20, 1, &pool);
+        env.StepBatch(actions.data());
+
+        auto start = Clock::now();
+        for (size_t s = 0; s < steps; ++s)
+            env.StepBatch(&actions[(s % actionSteps) * count]);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        double rate = count * steps / seconds;
+        if (threads == 1) base = rate;
+
+        // 结果与线程数无关，校验和在每一行都应相同
+        uint64_t checksum = 1469598103934665603ULL;
+        const uint8_t* obs = env.Observations();
+        for (size_t i = 0; i < count * 400; ++i) checksum = (checksum ^ obs[i]) * 1099511628211ULL;
+        std::printf("%8u %16.0f %12.2f %11.0f%% %18llx\n", threads, rate, rate / base, rate / base / threads * 100.0,
+            (unsigned long long)checksum);
+        if (threads == hw) break;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// 占用位图基准：99% 占用率下的食物生成、碰撞查询和增删
+// 对比原来“随机坐标直到落在空格”的拒绝采样
+#include "../OccupancyGrid.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+static uint64_t NextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static double NsPerOp(Clock::time_point start, unsigned long long ops) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+}
+
+int main() {
+    const int sizes[] = { 20, 256, 1024, 4096 };
+    const unsigned long long ops = 2000000;
+    volatile uint64_t sink = 0;
+
+    std::printf("%10s %8s %14s %16s %14s %16s\n",
+        "grid", "free", "spawn ns", "rejection ns", "query ns", "occupy+free ns");
+    for (int size : sizes) {
+        OccupancyGrid grid(size, size);
+        size_t interior = grid.FreeCount();
+        size_t target = interior / 100;
+        if (target < 1) target = 1;
+
+        auto start = Clock::now();
+        while (grid.FreeCount() > target)
+            grid.Occupy(grid.FreeCell(NextRandom() % grid.FreeCount()));
+        double fillMs = NsPerOp(start, 1) * 1e-6;
+
+        // 空格集合：一次取模加一次数组访问
+        start = Clock::now();
+        for (unsigned long long i = 0; i < ops; ++i) {
+            Vec2i cell = grid.FreeCell(NextRandom() % grid.FreeCount());
+            sink = sink + cell.x;
+        }
+        double spawnNs = NsPerOp(start, ops);
+
+        // 拒绝采样：期望要抽 100 次才落到空格
+        unsigned long long rejectionOps = ops / 20;
+        start = Clock::now();
+        for (unsigned long long i = 0; i < rejectionOps; ++i) {
+            Vec2i cell;
+            do {
+                cell = { (int)(NextRandom() % (size - 2)) + 1, (int)(NextRandom() % (size - 2)) + 1 };
+            } while (grid.Occupied(cell));
+            sink = sink + cell.x;
+        }
+        double rejectionNs = NsPerOp(start, rejectionOps);
+
+        start = Clock::now();
+        for (unsigned long long i = 0; i < ops; ++i) {
+            Vec2i cell = { (int)(NextRandom() % size), (int)(NextRandom() % size) };
+            sink = sink + grid.Occupied(cell);
+        }
+        double queryNs = NsPerOp(start, ops);
+
+        // 模拟蛇头占格、蛇尾让格，占用率保持不变
+        start = Clock::now();
+        for (unsigned long long i = 0; i < ops; ++i) {
+            Vec2i cell = grid.FreeCell(NextRandom() % grid.FreeCount());
+            grid.Occupy(cell);
+            grid.Release(cell);
+        }
+        double churnNs = NsPerOp(start, ops);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "%dx%d", size, size);
+        std::printf("%10s %8zu %14.2f %16.2f %14.2f %16.2f   (fill %.0f ms)\n",
+            name, grid.FreeCount(), spawnNs, rejectionNs, queryNs, churnNs, fillMs);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// 粒子更新基准：默认 100 万个活着的粒子，按 60 fps 的步长推进，比较标量 / SSE2 / AVX2
+// 用法: particle_bench [粒子数] [帧数]
+// 两个场景：寿命很长、没有粒子死掉时只测积分；寿命 1 秒左右、每帧补满时测积分加移除（约 1.5% 的粒子每帧死掉）
+// 各实现跑完之后的粒子数组算 FNV 摘要，必须与标量实现相同
+#include "../ParticleSystem.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Clock = std::chrono::steady_clock;
+
+static const float kDt = 1.0f / 60.0f;
+
+static double Seconds(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+// 按游戏里压测的方式补满：每团 4096 个，散在 20x20 格的视野里
+static void TopUp(ParticleSystem& particles, size_t target, float life, Rng& rng) {
+    while (particles.Size() < target) {
+        int burst = (int)(target - particles.Size() < 4096 ? target - particles.Size() : 4096);
+        particles.Emit({ rng.Below(2000) * 0.01f, rng.Below(2000) * 0.01f, burst, 4.0f, life, 0xC0FFC060u });
+    }
+}
+
+static uint64_t Hash(const ParticleSystem& particles) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const void* data, size_t bytes) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < bytes; ++i) h = (h ^ p[i]) * 1099511628211ULL;
+    };
+    size_t n = particles.Size();
+    mix(&n, sizeof(n));
+    mix(particles.X(), n * sizeof(float));
+    mix(particles.Y(), n * sizeof(float));
+    mix(particles.Life(), n * sizeof(float));
+    mix(particles.Color(), n * sizeof(uint32_t));
+    return h;
+}
+
+struct Result {
+    double integrateNs;     // 每个粒子
+    double updateNs;        // 积分加移除，每个粒子
+    double emitNs;          // 每个新粒子
+    double died;            // 每帧死掉的比例
+    uint64_t hash;
+};
+
+static Result Run(ParticleSystem::Isa isa, size_t count, int frames) {
+    Result r = {};
+    ParticleSystem particles(count);
+    particles.SetIsa(isa);
+
+    // 场景一：寿命远长于测试时间，只有积分
+    Rng rng(7);
+    particles.Seed(1);
+    TopUp(particles, count, 1e6f, rng);
+    particles.Update(kDt);
+    Clock::time_point t0 = Clock::now();
+    for (int f = 0; f < frames; ++f) particles.Integrate(kDt);
+    r.integrateNs = Seconds(t0, Clock::now()) * 1e9 / ((double)frames * count);
+
+    // 场景二：寿命 0.5~1 秒，每帧死掉一批、再补满
+    particles.Clear();
+    particles.Seed(2);
+    rng.Seed(9);
+    TopUp(particles, count, 1.0f, rng);
+    // 先跑一秒，让寿命分布稳定下来
+    for (int f = 0; f < 60; ++f) {
+        particles.Update(kDt);
+        TopUp(particles, count, 1.0f, rng);
+    }
+    double update = 0.0, emit = 0.0;
+    size_t updated = 0, emitted = 0;
+    for (int f = 0; f < frames; ++f) {
+        size_t before = particles.Size();
+        Clock::time_point a = Clock::now();
+        particles.Update(kDt);
+        Clock::time_point b = Clock::now();
+        size_t after = particles.Size();
+        TopUp(particles, count, 1.0f, rng);
+        Clock::time_point c = Clock::now();
+        update += Seconds(a, b);
+        emit += Seconds(b, c);
+        updated += before;
+        emitted += count - after;
+    }
+    r.updateNs = update * 1e9 / updated;
+    r.emitNs = emitted ? emit * 1e9 / emitted : 0.0;
+    r.died = (double)emitted / updated;
+    r.hash = Hash(particles);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? (size_t)std::atoll(argv[1]) : 1000000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (count < 1) count = 1;
+    if (frames < 1) frames = 1;
+
+    static const char* names[] = { "scalar", "sse2", "avx2" };
+    ParticleSystem::Isa best = ParticleSystem::BestIsa();
+    std::printf("%zu particles, %d frames at 60 fps steps, best ISA %s\n", count, frames, names[best]);
+    std::printf("%-8s %14s %14s %12s %10s %16s\n", "isa", "integrate ns/p", "update ns/p", "emit ns/p", "died/frm", "update ms/frame");
+
+    uint64_t reference = 0;
+    bool mismatch = false;
+    double scalarUpdate = 0.0;
+    for (int i = ParticleSystem::SCALAR; i <= best; ++i) {
+        Result r = Run((ParticleSystem::Isa)i, count, frames);
+        if (i == ParticleSystem::SCALAR) {
+            reference = r.hash;
+            scalarUpdate = r.updateNs;
+        }
+        bool same = r.hash == reference;
+        mismatch |= !same;
+        std::printf("%-8s %14.3f %14.3f %12.2f %9.2f%% %16.2f  x%.2f%s\n", names[i], r.integrateNs, r.updateNs, r.emitNs,
+            r.died * 100.0, r.updateNs * count / 1e6, scalarUpdate / r.updateNs, same ? "" : "  MISMATCH");
+    }
+    // 每帧上传给 GPU 的量：x、y、life 各 4 字节，颜色 4 字节
+    std::printf("upload: %.1f MB/frame (16 B/particle)\n", count * 16.0 / 1048576.0);
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+// CPU 光栅化基准：1920x1080 上画 100k 节的蛇，比较标量 / SSE2 / AVX2 与线程数
+// 用法: raster_bench [宽] [高] [节数]
+// 两个场景：缩小到整条蛇都在屏幕上（每节都提交），以及游戏里的 20 格视野（只提交视野内的节）
+// 每种配置的画面都算 CRC32，必须与第一种配置相同
+#include "../SoftRasterizer.h"
+#include "../AtlasFormat.h"
+#include "../AssetPack.h"
+#include "../ThreadPool.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// 三层 32x32 的测试纹理：不同颜色的棋盘格，边缘一圈半透明
+static std::vector<uint8_t> MakeAtlas() {
+    const int size = 32, layers = 3;
+    std::vector<uint8_t> file(Atlas::DataOffset(layers));
+    AtlasHeader* header = (AtlasHeader*)file.data();
+    std::memcpy(header->magic, "SNKA", 4);
+    header->version = Atlas::kVersion;
+    header->size = size;
+    header->layers = layers;
+    header->levels = Atlas::LevelCount(size);
+    AtlasEntry* entries = (AtlasEntry*)(file.data() + sizeof(AtlasHeader));
+    const char* names[layers] = { "snake_head.png", "snake_body1.png", "food.png" };
+    for (int i = 0; i < layers; ++i) {
+        std::memset(entries[i].name, 0, sizeof(entries[i].name));
+        std::strcpy(entries[i].name, names[i]);
+        entries[i].u0 = entries[i].v0 = 0.0f;
+        entries[i].u1 = entries[i].v1 = 1.0f;
+    }
+    for (int i = 0; i < layers; ++i) {
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                bool dark = ((x / 4) + (y / 4)) % 2 != 0;
+                bool edge = x < 2 || y < 2 || x >= size - 2 || y >= size - 2;
+                uint8_t px[4] = { (uint8_t)(i == 0 ? 240 : 40), (uint8_t)(dark ? 90 : 200), (uint8_t)(i == 2 ? 220 : 60), (uint8_t)(edge ? 96 : 255) };
+                file.insert(file.end(), px, px + 4);
+            }
+        }
+    }
+    Atlas::AppendLevels(file, size, layers);
+    return file;
+}
+
+// 第 k 节在 side 宽的蛇形排布中的位置
+static void Serpentine(size_t k, int side, int& x, int& y) {
+    y = (int)(k / side);
+    x = (int)(k % side);
+    if (y % 2) x = side - 1 - x;
+}
+
+struct Scene {
+    const char* name;
+    int viewCells;
+};
+
+static void Submit(SoftRasterizer& r, size_t length, int side, int viewCells) {
+    float cell = 2.0f / viewCells;
+    // 视野中心放在蛇身中段
+    int cx, cy;
+    Serpentine(length / 2, side, cx, cy);
+    double camX = viewCells >= side ? side / 2.0 : cx + 0.5, camY = viewCells >= side ? side / 2.0 : cy + 0.5;
+    double half = viewCells / 2.0 + 1.0;
+    r.BeginFrame(0.2f, 0.3f, 0.25f);
+    for (size_t k = 0; k < length; ++k) {
+        int x, y;
+        Serpentine(k, side, x, y);
+        if (std::fabs(x + 0.5 - camX) > half || std::fabs(y + 0.5 - camY) > half) continue;
+        float px = (float)((x + 0.5 - camX) * cell), py = (float)((y + 0.5 - camY) * cell);
+        bool head = k == length - 1;
+        r.AddSprite(true, { px, py, head ? 1.5707963f : 0.0f, head ? 0.0f : 1.0f, 1.0f, 1.0f, 1.0f, 1.0f });
+    }
+    r.AddSprite(true, { 0.0f, 0.0f, 0.3f, 2.0f, 1.0f, 1.0f, 1.0f, 1.0f });
+    r.Flush();
+    r.DrawBorder();
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 1920;
+    int height = argc > 2 ? std::atoi(argv[2]) : 1080;
+    size_t length = argc > 3 ? (size_t)std::atoll(argv[3]) : 100000;
+    int side = (int)std::ceil(std::sqrt((double)length));
+
+    std::vector<uint8_t> atlas = MakeAtlas();
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    const char* isaNames[] = { "scalar", "sse2", "avx2" };
+    Scene scenes[] = { { "whole snake", side + 1 }, { "game view", 20 } };
+
+    std::printf("%dx%d, %zu segments, best ISA %s, %u hardware threads\n",
+        width, height, length, isaNames[SoftRasterizer::BestIsa()], hw);
+    std::printf("%-12s %-7s %8s %10s %10s %10s\n", "scene", "isa", "threads", "ms/frame", "fps", "crc");
+    for (const Scene& scene : scenes) {
+        uint32_t reference = 0;
+        bool first = true, mismatch = false;
+        std::vector<unsigned> threadCounts = { 1 };
+        if (hw > 1) threadCounts.push_back(hw);
+        for (unsigned threads : threadCounts) {
+            ThreadPool pool(threads);
+            for (int isa = SoftRasterizer::SCALAR; isa <= SoftRasterizer::BestIsa(); ++isa) {
+                SoftRasterizer r(width, height, 1.0f / (scene.viewCells + 1), threads > 1 ? &pool : nullptr);
+                r.SetAtlas(atlas.data(), atlas.size());
+                r.SetIsa((SoftRasterizer::Isa)isa);
+                Submit(r, length, side, scene.viewCells);
+                int frames = 0;
+                auto start = Clock::now();
+                double elapsed = 0.0;
+                do {
+                    Submit(r, length, side, scene.viewCells);
+                    frames++;
+                    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                } while (elapsed < 1.0);
+                uint32_t crc = AssetPack::Crc32(r.Pixels(), (size_t)width * height * 4);
+                if (first) reference = crc;
+                mismatch |= crc != reference;
+                first = false;
+                double ms = elapsed * 1000.0 / frames;
+                std::printf("%-12s %-7s %8u %10.2f %10.1f   %08x\n", scene.name, isaNames[isa], threads, ms, 1000.0 / ms, crc);
+            }
+        }
+        if (mismatch) {
+            std::printf("%s: configurations disagree\n", scene.name);
+            return 1;
+        }
+    }
+    return 0;
+}
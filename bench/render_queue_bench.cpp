@@ -0,0 +1,93 @@
+// 渲染命令队列基准：用只计数的 GlApi（GlApiMock.h）跑几种典型的帧，报告每帧发出的 GL 调用次数
+// 用法: render_queue_bench [命令数]
+// 每个场景三行：每条命令都重新设置全部状态（相当于没有队列和缓存）、冷启动第一帧、之后每一帧
+// 最后报告随机命令排序后的切换次数和提交耗时，以及基数排序与 std::sort 的耗时
+// 场景定义在 RenderScenes.h，snake_bench 和 snake_tests 也用同样的场景；调用次数和排序结果由 snake_tests 核对
+#include "RenderScenes.h"
+#include "../Rng.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void Print(const char* scene, const char* frame, const GlCallCounts& c) {
+    std::printf("%-12s %-8s %8u %8u %8u %8u %8u %8u %8u %8u\n", scene, frame,
+        c.useProgram, c.bindVertexArray, c.bindBuffer, c.bindTexture, c.uniforms, c.attribPointers, c.draws, c.Total());
+}
+
+// 随机状态的命令：排序后程序、纹理、VAO 各切换了几次
+static void RandomCommands(const GlApi& api, size_t n) {
+    static const int kPrograms = 4, kTextures = 8, kVaos = 4;
+    Rng rng(n);
+    RenderQueue q;
+    for (size_t i = 0; i < n; ++i) {
+        RenderCommand& c = q.Add((RenderPass)rng.Below(PASS_COUNT));
+        c.program = 1 + (GLuint)rng.Below(kPrograms);
+        c.texture = 1 + (GLuint)rng.Below(kTextures);
+        c.vao = 1 + (GLuint)rng.Below(kVaos);
+        c.count = 6;
+    }
+    GlStateCache cache(api);
+    GlMock::counts = GlCallCounts();
+    auto start = Clock::now();
+    q.Submit(cache);
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    const GlCallCounts& c = GlMock::counts;
+    std::printf("random %zu commands: %u program, %u texture, %u vao binds, submit %.2f ms (%.1f ns/command)\n",
+        n, c.useProgram, c.bindTexture, c.bindVertexArray, ms, ms * 1e6 / n);
+}
+
+static void SortTiming(size_t n) {
+    Rng rng(n * 7 + 1);
+    std::vector<uint64_t> keys(n), scratch;
+    // 高位只有几种取值、低位是序号，和真实的排序键一样
+    for (size_t i = 0; i < n; ++i)
+        keys[i] = ((uint64_t)rng.Below(3) << 60) | ((uint64_t)rng.Below(16) << 48) | ((uint64_t)rng.Below(64) << 32) | (i & 0xFFFFF);
+    std::vector<uint64_t> copy = keys;
+    auto start = Clock::now();
+    RenderQueue::RadixSort(keys, scratch);
+    double radixMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    start = Clock::now();
+    std::sort(copy.begin(), copy.end());
+    double stdMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("sort %8zu keys: radix %8.3f ms, std::sort %8.3f ms\n", n, radixMs, stdMs);
+}
+
+int main(int argc, char** argv) {
+    size_t randomCommands = argc > 1 ? (size_t)std::atol(argv[1]) : 100000;
+    if (randomCommands == 0 || randomCommands > RenderQueue::kMaxCommands) randomCommands = 100000;
+    GlApi api = GlMock::Api();
+
+    std::printf("%-12s %-8s %8s %8s %8s %8s %8s %8s %8s %8s\n", "scene", "frame", "program", "vao", "buffer", "texture", "uniform", "attrib", "draw", "total");
+    for (const Scene& scene : Scenes()) {
+        // 不排序、不缓存：每条命令单独提交，提交前忘掉全部影子状态
+        {
+            GlStateCache cache(api);
+            GlMock::counts = GlCallCounts();
+            for (auto& add : scene.commands) {
+                RenderQueue q;
+                add(q);
+                cache.Invalidate();
+                q.Submit(cache);
+            }
+            Print(scene.name, "naive", GlMock::counts);
+        }
+        GlStateCache cache(api);
+        RenderQueue q;
+        GlMock::counts = GlCallCounts();
+        Build(scene, q);
+        q.Submit(cache);
+        Print(scene.name, "cold", GlMock::counts);
+        GlMock::counts = GlCallCounts();
+        Build(scene, q);
+        q.Submit(cache);
+        Print(scene.name, "warm", GlMock::counts);
+    }
+
+    RandomCommands(api, randomCommands);
+    for (size_t n : { (size_t)1, (size_t)100, (size_t)10000, (size_t)1 << 20 }) SortTiming(n);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// 录像基准：机器人打若干局并写成 .snkr，再逐个 mmap 重新模拟校验
+// 用法: replay_bench [局数] [输出目录]
+#include "../Replay.h"
+#include "../MappedFile.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// 朝食物走，避开墙和蛇身；偶尔随机转向，让录像里有足够多的事件
+static Vec2i ChooseDirection(const SnakeSim& sim, Rng& rng) {
+    static const Vec2i dirs[4] = { { 0, 1 }, { 0, -1 }, { -1, 0 }, { 1, 0 } };
+    Vec2i head = sim.Body().Front();
+    Vec2i food = sim.Food();
+    Vec2i best = sim.Direction();
+    int bestScore = -1000000;
+    for (Vec2i d : dirs) {
+        if (d.x == -sim.Direction().x && d.y == -sim.Direction().y) continue;
+        Vec2i next = { head.x + d.x, head.y + d.y };
+        int score = -(std::abs(food.x - next.x) + std::abs(food.y - next.y));
+        if (sim.Occupied(next) && !(next == sim.Body().Back())) score -= 100000;
+        score += (int)rng.Below(3);
+        if (score > bestScore) { bestScore = score; best = d; }
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::string dir = argc > 2 ? argv[2] : ".";
+    const unsigned long long maxTicks = 200000;
+
+    // 录制
+    SnakeSim sim(20, 20);
+    ReplayWriter writer;
+    Rng bot(12345);
+    std::vector<std::string> paths;
+    unsigned long long recordedTicks = 0, bytes = 0;
+    for (int g = 0; g < games; ++g) {
+        sim.Reset(bot.Next());
+        writer.Begin(sim);
+        while (sim.Alive() && sim.Tick() < maxTicks) {
+            Vec2i d = ChooseDirection(sim, bot);
+            if (!(d == sim.Direction()) && sim.QueueDirection(d)) writer.Record(sim.Tick(), d);
+            sim.Step();
+        }
+        writer.Finish(sim);
+        recordedTicks += sim.Tick();
+        bytes += writer.Bytes().size();
+        paths.push_back(dir + "/replay_bench_" + std::to_string(g) + ".snkr");
+        if (!writer.Save(paths.back().c_str())) {
+            std::fprintf(stderr, "cannot write %s\n", paths.back().c_str());
+            return 1;
+        }
+    }
+
+    // 校验
+    ReplayPlayer player;
+    MappedFile file;
+    int failures = 0;
+    unsigned long long verifiedTicks = 0;
+    auto start = Clock::now();
+    for (const std::string& path : paths) {
+        ReplayResult r;
+        if (file.Open(path.c_str())) r = player.Verify(file.Data(), file.Size());
+        if (!r.matches) failures++;
+        verifiedTicks += r.simulated.ticks;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const std::string& path : paths) std::remove(path.c_str());
+
+    std::printf("games: %d, ticks: %llu, avg %.1f ticks/game\n", games, recordedTicks, (double)recordedTicks / games);
+    std::printf("replay size: %.1f bytes/game, %.3f bytes/tick\n", (double)bytes / games, (double)bytes / recordedTicks);
+    std::printf("verify: %.0f ticks/sec, %.0f replays/min, %d mismatches\n",
+        verifiedTicks / seconds, games / seconds * 60.0, failures);
+    return failures ? 1 : 0;
+}
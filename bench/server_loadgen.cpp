@@ -0,0 +1,281 @@
+// 联机服务器负载测试：同一进程里起一个 RoomServer，在本机回环上开很多机器人客户端
+// 每个机器人一个 UDP socket，收快照、维护自己的局面副本并核对摘要，朝最近的食物走
+// 报告服务器推进一次的耗时分位数、每个客户端每秒收发的字节数、输入从发出到被快照确认的延迟
+// 用法: server_loadgen [--bots N] [--seconds S] [--rooms N] [--snakes N] [--room-size N] [--loss P] [--threads N] [--server IP:PORT]
+// --loss P 让机器人按概率丢掉收到的快照，检验丢包后按已确认的基准补发；--server 连外部的 snake_server
+// 有客户端的局面与服务器对不上时返回 1
+#include "../RoomServer.h"
+#include "../SimThread.h"
+#include "../Rng.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace Net;
+
+struct Bot {
+    int fd = -1;
+    uint32_t nonce = 0;
+    uint32_t id = 0;
+    double lastJoin = -1.0;
+    std::unique_ptr<ArenaSim> arena;
+    bool valid = false;
+    int slot = -1;
+    // 还没被服务器确认的输入：序号 acked+1 .. seq
+    uint16_t seq = 0, acked = 0;
+    uint8_t pending[kMaxInputs];
+    double sentAt[kMaxInputs];
+};
+
+struct Totals {
+    unsigned long long packetsIn = 0, bytesIn = 0, packetsOut = 0, bytesOut = 0;
+    unsigned long long full = 0, delta = 0, stale = 0, gaps = 0, corrupt = 0, lost = 0;
+    unsigned long long inputs = 0, rejects = 0;
+    LatencyHistogram inputAck;
+};
+
+static int Distance(Vec2i a, Vec2i b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+// 不会马上撞死的方向里选离最近的食物最近的；都不行就保持方向
+static int ChooseDirection(const ArenaSim& arena, int slot, Rng& rng) {
+    const ArenaSim::Snake& snake = arena.GetSnake(slot);
+    Vec2i head = snake.body.Front();
+    int best = -1, bestScore = 1 << 30;
+    int start = (int)rng.Below(4);
+    for (int k = 0; k < 4; ++k) {
+        int d = (start + k) % 4;
+        Vec2i dir = ArenaSim::kDirs[d];
+        if (dir.x == -snake.direction.x && dir.y == -snake.direction.y) continue;
+        Vec2i cell = { head.x + dir.x, head.y + dir.y };
+        if (arena.Occupied(cell) && !(cell == snake.body.Back())) continue;
+        int score = 1 << 20;
+        for (Vec2i f : arena.Food()) score = std::min(score, Distance(cell, f));
+        if (score < bestScore) {
+            bestScore = score;
+            best = d;
+        }
+    }
+    return best < 0 ? ArenaSim::DirCode(snake.direction) : best;
+}
+
+static void SendInput(Bot& bot, Totals& totals) {
+    uint8_t packet[12 + kMaxInputs] = { MSG_INPUT };
+    PutU32(packet + 1, bot.id);
+    PutU32(packet + 5, bot.valid ? (uint32_t)bot.arena->Tick() : 0);
+    PutU16(packet + 9, bot.seq);
+    int count = (uint16_t)(bot.seq - bot.acked);
+    packet[11] = (uint8_t)count;
+    for (int k = 0; k < count; ++k) packet[12 + k] = bot.pending[(bot.seq - count + 1 + k) % kMaxInputs];
+    size_t size = 12 + count;
+    if (send(bot.fd, packet, size, 0) == (ssize_t)size) {
+        totals.packetsOut++;
+        totals.bytesOut += size;
+    }
+}
+
+static void HandleSnapshot(Bot& bot, const uint8_t* data, size_t size, Totals& totals, Rng& rng, double now) {
+    if (data[0] == MSG_FULL) totals.full++;
+    else totals.delta++;
+    ApplyResult r = ApplySnapshot(data, size, *bot.arena, bot.valid);
+    if (r == STALE) totals.stale++;
+    if (r == GAP) totals.gaps++;
+    if (r == CORRUPT) totals.corrupt++;
+
+    // 服务器已经处理到的输入序号：之前的都不用再带，确认延迟从第一次发出算起
+    uint16_t processed = GetU16(data + 5);
+    while ((int16_t)(processed - bot.acked) > 0 && bot.acked != bot.seq) {
+        bot.acked++;
+        totals.inputAck.Record(now - bot.sentAt[bot.acked % kMaxInputs]);
+    }
+
+    if (r == APPLIED && bot.arena->GetSnake(bot.slot).alive && bot.seq == bot.acked) {
+        int d = ChooseDirection(*bot.arena, bot.slot, rng);
+        if (!(ArenaSim::kDirs[d] == bot.arena->GetSnake(bot.slot).direction)) {
+            bot.seq++;
+            bot.pending[bot.seq % kMaxInputs] = (uint8_t)d;
+            bot.sentAt[bot.seq % kMaxInputs] = now;
+            totals.inputs++;
+        }
+    }
+    // 每个快照都回一个包：确认 tick，并带上还没被确认的输入
+    SendInput(bot, totals);
+}
+
+int main(int argc, char** argv) {
+    int bots = 1000, rooms = 0, snakes = 16, roomSize = 48;
+    unsigned threads = 0;
+    double seconds = 10.0, loss = 0.0;
+    std::string external;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* name = argv[i];
+        const char* value = argv[i + 1];
+        if (std::strcmp(name, "--bots") == 0) bots = std::max(std::atoi(value), 1);
+        else if (std::strcmp(name, "--seconds") == 0) seconds = std::atof(value);
+        else if (std::strcmp(name, "--rooms") == 0) rooms = std::atoi(value);
+        else if (std::strcmp(name, "--snakes") == 0) snakes = std::atoi(value);
+        else if (std::strcmp(name, "--room-size") == 0) roomSize = std::atoi(value);
+        else if (std::strcmp(name, "--loss") == 0) loss = std::atof(value);
+        else if (std::strcmp(name, "--threads") == 0) threads = (unsigned)std::atoi(value);
+        else if (std::strcmp(name, "--server") == 0) external = value;
+        else {
+            std::fprintf(stderr, "unknown option %s\n", name);
+            return 2;
+        }
+    }
+    snakes = std::min(std::max(snakes, 1), ArenaSim::kMaxSnakes);
+    if (rooms <= 0) rooms = (bots + snakes - 1) / snakes;
+
+    // 每个机器人一个 socket，默认的 1024 个描述符不够
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    sockaddr_in serverAddr = {};
+    serverAddr.sin_family = AF_INET;
+    std::unique_ptr<RoomServer> server;
+    std::thread serverThread;
+    if (external.empty()) {
+        ServerConfig config;
+        config.bindAddress = "127.0.0.1";
+        config.port = 0;
+        config.rooms = rooms;
+        config.roomSize = roomSize;
+        config.snakesPerRoom = snakes;
+        config.threads = threads;
+        server.reset(new RoomServer(config));
+        if (!server->Open()) return 1;
+        inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
+        serverAddr.sin_port = htons(server->Port());
+        serverThread = std::thread([&server] { server->Run(); });
+    }
+    else {
+        size_t colon = external.rfind(':');
+        if (colon == std::string::npos || inet_pton(AF_INET, external.substr(0, colon).c_str(), &serverAddr.sin_addr) != 1) {
+            std::fprintf(stderr, "bad server address %s\n", external.c_str());
+            return 2;
+        }
+        serverAddr.sin_port = htons((uint16_t)std::atoi(external.c_str() + colon + 1));
+    }
+
+    int epollFd = epoll_create1(0);
+    std::vector<Bot> crowd(bots);
+    Rng rng(12345);
+    for (int b = 0; b < bots; ++b) {
+        Bot& bot = crowd[b];
+        bot.fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        if (bot.fd < 0 || connect(bot.fd, (sockaddr*)&serverAddr, sizeof(serverAddr)) != 0) {
+            std::perror("bot socket");
+            return 1;
+        }
+        bot.nonce = (uint32_t)rng.Next();
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)b;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, bot.fd, &ev);
+    }
+
+    Totals totals;
+    // 前 2 秒用来进房间，之后才开始计数
+    const double warmup = 2.0;
+    double start = SimThread::Now(), measureStart = start + warmup, end = measureStart + seconds;
+    bool measuring = false;
+    int joined = 0;
+    std::vector<epoll_event> events(256);
+    uint8_t buffer[kMaxPacket];
+    while (SimThread::Now() < end) {
+        double now = SimThread::Now();
+        if (!measuring && now >= measureStart) {
+            totals = Totals();
+            measuring = true;
+        }
+        // 没进房间的每秒重发一次 JOIN
+        for (Bot& bot : crowd) {
+            if (bot.id != 0 || now - bot.lastJoin < 1.0) continue;
+            uint8_t join[5] = { MSG_JOIN };
+            PutU32(join + 1, bot.nonce);
+            if (send(bot.fd, join, sizeof(join), 0) == (ssize_t)sizeof(join)) {
+                totals.packetsOut++;
+                totals.bytesOut += sizeof(join);
+            }
+            bot.lastJoin = now;
+        }
+        int n = epoll_wait(epollFd, events.data(), (int)events.size(), 10);
+        now = SimThread::Now();
+        for (int i = 0; i < n; ++i) {
+            Bot& bot = crowd[events[i].data.u32];
+            for (;;) {
+                ssize_t size = recv(bot.fd, buffer, sizeof(buffer), 0);
+                if (size <= 0) break;
+                totals.packetsIn++;
+                totals.bytesIn += (unsigned long long)size;
+                uint8_t type = buffer[0];
+                if (type == MSG_WELCOME && size >= 14 && bot.id == 0 && GetU32(buffer + 1) == bot.nonce) {
+                    bot.id = GetU32(buffer + 5);
+                    bot.slot = buffer[11];
+                    bot.arena.reset(new ArenaSim(buffer[12], buffer[13], 1, 0));
+                    joined++;
+                }
+                else if (type == MSG_REJECT) {
+                    totals.rejects++;
+                }
+                else if ((type == MSG_FULL || type == MSG_DELTA) && bot.arena) {
+                    if (loss > 0.0 && rng.Below(1000000) < loss * 1000000) {
+                        totals.lost++;
+                        continue;
+                    }
+                    HandleSnapshot(bot, buffer, (size_t)size, totals, rng, now);
+                }
+            }
+        }
+    }
+    double measured = SimThread::Now() - measureStart;
+
+    for (Bot& bot : crowd) {
+        if (bot.id != 0) {
+            uint8_t leave[5] = { MSG_LEAVE };
+            PutU32(leave + 1, bot.id);
+            if (send(bot.fd, leave, sizeof(leave), 0) < 0) {}
+        }
+    }
+    if (server) {
+        // 等 LEAVE 都被处理
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        server->Stop();
+        serverThread.join();
+    }
+    for (Bot& bot : crowd) close(bot.fd);
+    close(epollFd);
+
+    std::printf("%d bots (%d joined), %d rooms x %d snakes, %dx%d, %.1f s measured, loss %.1f%%\n",
+        bots, joined, rooms, snakes, roomSize, roomSize, measured, loss * 100.0);
+    if (server) {
+        const RoomServer::Stats& st = server->GetStats();
+        std::printf("server tick: n=%llu late %llu, p50 %.1f ms  p90 %.1f ms  p99 %.1f ms  max %.2f ms\n",
+            st.ticks, st.lateTicks, st.tickTime.PercentileMs(0.5), st.tickTime.PercentileMs(0.9),
+            st.tickTime.PercentileMs(0.99), st.tickTime.MaxMs());
+    }
+    double perClient = 1.0 / (std::max(joined, 1) * measured);
+    std::printf("down: %.0f B/client/s payload, %.0f B/client/s with IP/UDP headers, %.1f packets/client/s\n",
+        totals.bytesIn * perClient, (totals.bytesIn + 28.0 * totals.packetsIn) * perClient, totals.packetsIn * perClient);
+    std::printf("up:   %.0f B/client/s payload, %.0f B/client/s with IP/UDP headers\n",
+        totals.bytesOut * perClient, (totals.bytesOut + 28.0 * totals.packetsOut) * perClient);
+    std::printf("snapshots: %llu delta, %llu full, %llu stale, %llu gaps, %llu lost, %llu desync\n",
+        totals.delta, totals.full, totals.stale, totals.gaps, totals.lost, totals.corrupt);
+    std::printf("inputs: %llu, ack latency p50 %.1f ms  p99 %.1f ms  max %.1f ms\n",
+        totals.inputs, totals.inputAck.PercentileMs(0.5), totals.inputAck.PercentileMs(0.99), totals.inputAck.MaxMs());
+    return totals.corrupt ? 1 : 0;
+}
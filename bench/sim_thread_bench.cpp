@@ -0,0 +1,56 @@
+// 逻辑线程基准：模拟一个忙碌的渲染线程，随机时刻送入按键事件
+// 输出按键到 tick 的延迟分布、tick 的准时程度，以及渲染线程读快照的耗时
+#include "../SimThread.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+static void Report(const char* name, const LatencyHistogram& h) {
+    std::printf("%-16s n=%-6llu mean %6.2f ms  p50 %6.1f ms  p99 %6.1f ms  max %6.2f ms\n",
+        name, h.Count(), h.MeanMs(), h.PercentileMs(0.5), h.PercentileMs(0.99), h.MaxMs());
+}
+
+int main() {
+    const double duration = 3.0;
+    // 大棋盘上随便转向也不容易死
+    SnakeSim sim(512, 512, 11, true);
+    ReplayWriter replay;
+    SimThread simThread(sim, replay, 20);
+    Rng rng(99);
+
+    simThread.Start(rng.Next());
+    double start = SimThread::Now(), nextInput = start;
+    unsigned long long frames = 0, reads = 0, events = 0;
+    double readNs = 0.0;
+    int turn = 0;
+    while (SimThread::Now() - start < duration) {
+        // 渲染帧：读最新快照
+        auto t0 = std::chrono::steady_clock::now();
+        const SimSnapshot& snap = simThread.Latest();
+        readNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        reads++;
+        if (!snap.alive) break;
+
+        // 按键：沿一个方形兜圈，间隔 20~120 ms
+        double now = SimThread::Now();
+        if (now >= nextInput) {
+            static const Vec2i loop[4] = { { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, 0 } };
+            InputEvent e;
+            e.dir = loop[turn++ % 4];
+            e.time = now;
+            simThread.PushInput(e);
+            events++;
+            nextInput = now + 0.02 + rng.Below(100) * 0.001;
+        }
+        // 每帧 4~20 ms 不等，模拟时快时慢的渲染
+        std::this_thread::sleep_for(std::chrono::milliseconds(4 + rng.Below(17)));
+        frames++;
+    }
+    simThread.Stop();
+
+    std::printf("frames %llu, events %llu, ticks %llu, snapshot read %.0f ns\n",
+        frames, events, simThread.Latest().tick, readNs / reads);
+    Report("input->tick", simThread.Latency());
+    Report("tick jitter", simThread.TickJitter());
+    return 0;
+}
@@ -0,0 +1,263 @@
+// 基准套件：逻辑 tick（按蛇长分档）、食物生成、输入队列吞吐、渲染提交（计数用的 GL 替身），全部不需要窗口和显卡
+// 用法: snake_bench [--json FILE] [--filter 名字] [--quick]
+// --json FILE 另外把结果写成 JSON，便于跟踪回归；FILE 为 - 时 JSON 写到标准输出，不打印表格
+// --filter 只跑名字里含有该字符串的分组（tick、food、input、render）；--quick 缩短各项的运行时间
+// 渲染场景的调用次数只报告，是否符合预期由 snake_tests 核对
+#include "RenderScenes.h"
+#include "../SnakeSim.h"
+#include "../Autopilot.h"
+#include "../SimThread.h"
+#include "../SpscQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Metric {
+    std::string name;
+    std::string unit;
+    double value;
+};
+
+struct Suite {
+    std::vector<Metric> metrics;
+    bool quick = false;
+    bool table = true;
+    int failures = 0;
+
+    void Add(const std::string& name, const char* unit, double value) {
+        metrics.push_back({ name, unit, value });
+        if (table) std::printf("%-40s %14.2f  %s\n", name.c_str(), value, unit);
+    }
+};
+
+static double Ns(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::nano>(b - a).count();
+}
+
+// 连续两次读时钟的平均间隔，逐 tick 计时的结果里要减掉
+static double TimerOverhead() {
+    const int n = 100000;
+    Clock::time_point start = Clock::now(), t = start;
+    for (int i = 0; i < n; ++i) t = Clock::now();
+    return Ns(start, t) / n;
+}
+
+// 蛇长分档：[1, 16)、[16, 64)、[64, 256)、[256, 1024)
+static const size_t kBounds[] = { 1, 16, 64, 256, 1024 };
+static const int kBuckets = 4;
+
+static int Bucket(size_t length) {
+    for (int b = kBuckets - 1; b >= 0; --b)
+        if (length >= kBounds[b]) return b;
+    return 0;
+}
+
+static std::string BucketName(int b) {
+    return "len_" + std::to_string(kBounds[b]) + "-" + std::to_string(kBounds[b + 1] - 1);
+}
+
+// 32x32 的棋盘由自动驾驶一直玩到填满，逐 tick 计时（自动驾驶本身不计），按 tick 开始时的蛇长分档
+// 普通 tick 取 MOVED 的平均；吃到食物的 tick 比同档的普通 tick 多出来的就是长一节加生成食物的开销
+static void TickAndFood(Suite& suite, bool tick, bool food) {
+    const int grid = 32;
+    unsigned long long maxTicks = suite.quick ? 300000 : 3000000;
+    SnakeSim sim(grid, grid, 2024);
+    Autopilot pilot(grid, grid);
+    // 找不到安全的路时马上改走哈密顿回路，否则蛇会在 200 节左右一直追着尾巴转，长不到最后一档
+    pilot.cycleThreshold = 0.0f;
+    double overhead = TimerOverhead();
+    double moved[kBuckets] = {}, ate[kBuckets] = {};
+    unsigned long long movedCount[kBuckets] = {}, ateCount[kBuckets] = {};
+    for (unsigned long long i = 0; i < maxTicks; ++i) {
+        Vec2i d = pilot.NextDirection(sim);
+        if (!(d == sim.Direction())) sim.QueueDirection(d);
+        int b = Bucket(sim.Body().Size());
+        Clock::time_point t0 = Clock::now();
+        StepResult r = sim.Step();
+        Clock::time_point t1 = Clock::now();
+        if (r == MOVED) {
+            moved[b] += Ns(t0, t1);
+            movedCount[b]++;
+        }
+        else if (r == ATE) {
+            ate[b] += Ns(t0, t1);
+            ateCount[b]++;
+        }
+        if (r == DIED || sim.Food().x < 0) {
+            sim.Reset();
+            pilot.Invalidate();
+        }
+    }
+    for (int b = 0; b < kBuckets; ++b) {
+        if (!movedCount[b]) continue;
+        double movedNs = std::max(moved[b] / movedCount[b] - overhead, 0.0);
+        if (tick) suite.Add("tick/grid32/" + BucketName(b), "ns/tick", movedNs);
+        if (food && ateCount[b]) suite.Add("food/grid32/" + BucketName(b), "ns/meal", std::max(ate[b] / ateCount[b] - overhead - movedNs, 0.0));
+    }
+}
+
+// 超过 kMaxDenseCells 的大地图：没有占用位图，食物靠拒绝采样；蛇很短，一直朝食物直走
+static void SparseFood(Suite& suite, bool tick, bool food) {
+    const int grid = 8192;
+    int meals = suite.quick ? 20 : 200;
+    SnakeSim sim(grid, grid, 7);
+    double overhead = TimerOverhead();
+    double moved = 0.0, ate = 0.0;
+    unsigned long long movedCount = 0, ateCount = 0;
+    while ((int)ateCount < meals) {
+        Vec2i head = sim.Body().Front(), f = sim.Food(), dir = sim.Direction();
+        Vec2i want = f.x != head.x ? Vec2i{ f.x > head.x ? 1 : -1, 0 } : Vec2i{ 0, f.y > head.y ? 1 : -1 };
+        // 食物在正后方时先拐一下
+        if (want.x == -dir.x && want.y == -dir.y) want = dir.x != 0 ? Vec2i{ 0, head.y * 2 < grid ? 1 : -1 } : Vec2i{ head.x * 2 < grid ? 1 : -1, 0 };
+        if (!(want == dir)) sim.QueueDirection(want);
+        Clock::time_point t0 = Clock::now();
+        StepResult r = sim.Step();
+        Clock::time_point t1 = Clock::now();
+        if (r == MOVED) {
+            moved += Ns(t0, t1);
+            movedCount++;
+        }
+        else if (r == ATE) {
+            ate += Ns(t0, t1);
+            ateCount++;
+        }
+        else {
+            sim.Reset();
+        }
+    }
+    double movedNs = std::max(moved / movedCount - overhead, 0.0);
+    if (tick) suite.Add("tick/grid8192/sparse", "ns/tick", movedNs);
+    if (food) suite.Add("food/grid8192/sparse", "ns/meal", std::max(ate / ateCount - overhead - movedNs, 0.0));
+}
+
+// 窗口线程到逻辑线程的按键队列：一个线程压、一个线程取，满了或空了就让出 CPU
+static void InputQueue(Suite& suite) {
+    const unsigned long long n = suite.quick ? 200000 : 5000000;
+    static SpscQueue<InputEvent, 256> queue;
+    Clock::time_point start = Clock::now();
+    std::thread producer([n] {
+        InputEvent e;
+        for (unsigned long long i = 0; i < n; ++i) {
+            e.time = (double)i;
+            while (!queue.Push(e)) std::this_thread::yield();
+        }
+    });
+    InputEvent e;
+    double sum = 0.0;
+    for (unsigned long long i = 0; i < n; ++i) {
+        while (!queue.Pop(e)) std::this_thread::yield();
+        sum += e.time;
+    }
+    producer.join();
+    double ns = Ns(start, Clock::now());
+    // 顺序和内容都要对：0 + 1 + ... + (n - 1)
+    if (sum != (double)n * (n - 1) / 2) {
+        std::fprintf(stderr, "input queue lost or reordered events\n");
+        suite.failures++;
+    }
+    suite.Add("input/spsc_throughput", "Mevents/s", n / ns * 1e3);
+
+    // SnakeSim 自己的按键队列：每个 tick 压两个转向，下一个 tick 取走一个
+    SnakeSim sim(64, 64, 3);
+    const Vec2i turns[4] = { { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 } };
+    unsigned long long ticks = suite.quick ? 200000 : 2000000, keys = 0;
+    start = Clock::now();
+    for (unsigned long long i = 0; i < ticks; ++i) {
+        keys += sim.QueueDirection(turns[i % 4]);
+        keys += sim.QueueDirection(turns[(i + 1) % 4]);
+        if (sim.Step() == DIED) sim.Reset();
+    }
+    ns = Ns(start, Clock::now());
+    suite.Add("input/sim_queue_tick", "ns/tick", ns / ticks);
+    suite.Add("input/sim_queue_accepted", "keys/tick", (double)keys / ticks);
+}
+
+// 每个场景：没有队列和缓存时每帧的 GL 调用数、缓存热了之后每帧的调用数，以及建队列加提交一帧的 CPU 耗时
+static void RenderSubmit(Suite& suite) {
+    GlApi api = GlMock::Api();
+    int frames = suite.quick ? 2000 : 20000;
+    for (const Scene& scene : Scenes()) {
+        std::string prefix = std::string("render/") + scene.name;
+        for (char& c : prefix) if (c == ' ') c = '_';
+        {
+            GlStateCache cache(api);
+            GlMock::counts = GlCallCounts();
+            for (auto& add : scene.commands) {
+                RenderQueue q;
+                add(q);
+                cache.Invalidate();
+                q.Submit(cache);
+            }
+            suite.Add(prefix + "/naive_gl_calls", "calls/frame", GlMock::counts.Total());
+        }
+        GlStateCache cache(api);
+        RenderQueue q;
+        Build(scene, q);
+        q.Submit(cache);
+        Clock::time_point start = Clock::now();
+        for (int f = 0; f < frames; ++f) {
+            GlMock::counts = GlCallCounts();
+            Build(scene, q);
+            q.Submit(cache);
+        }
+        double ns = Ns(start, Clock::now()) / frames;
+        const GlCallCounts& c = GlMock::counts;
+        suite.Add(prefix + "/gl_calls", "calls/frame", c.Total());
+        suite.Add(prefix + "/draw_calls", "calls/frame", c.draws);
+        suite.Add(prefix + "/state_calls", "calls/frame", c.Total() - c.draws);
+        suite.Add(prefix + "/submit", "ns/frame", ns);
+    }
+}
+
+static bool WriteJson(const Suite& suite, const char* path) {
+    FILE* f = std::strcmp(path, "-") == 0 ? stdout : std::fopen(path, "w");
+    if (!f) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return false;
+    }
+    std::fprintf(f, "{\n  \"suite\": \"snake_bench\",\n  \"version\": 1,\n  \"quick\": %s,\n  \"results\": [\n", suite.quick ? "true" : "false");
+    for (size_t i = 0; i < suite.metrics.size(); ++i) {
+        const Metric& m = suite.metrics[i];
+        std::fprintf(f, "    { \"name\": \"%s\", \"unit\": \"%s\", \"value\": %.6g }%s\n",
+            m.name.c_str(), m.unit.c_str(), m.value, i + 1 < suite.metrics.size() ? "," : "");
+    }
+    std::fprintf(f, "  ],\n  \"failures\": %d\n}\n", suite.failures);
+    if (f != stdout) std::fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Suite suite;
+    const char* jsonPath = nullptr;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+        else if (std::strcmp(argv[i], "--quick") == 0) suite.quick = true;
+        else {
+            std::fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    suite.table = !(jsonPath && std::strcmp(jsonPath, "-") == 0);
+    auto wanted = [&filter](const char* group) { return filter.empty() || std::strstr(group, filter.c_str()) != nullptr; };
+
+    bool tick = wanted("tick"), food = wanted("food");
+    if (tick || food) {
+        TickAndFood(suite, tick, food);
+        SparseFood(suite, tick, food);
+    }
+    if (wanted("input")) InputQueue(suite);
+    if (wanted("render")) RenderSubmit(suite);
+
+    if (jsonPath && !WriteJson(suite, jsonPath)) return 1;
+    if (suite.failures && suite.table) std::printf("%d check(s) failed\n", suite.failures);
+    return suite.failures ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+// 蛇身存储基准：不同长度下每个 tick 的耗时
+// 对比原来的 deque 整条复制与环形缓冲
+#include "../SnakeBody.h"
+#include <chrono>
+#include <cstdio>
+#include <deque>
+
+using Clock = std::chrono::steady_clock;
+
+// 绕一个方形来回走，保证每步都是合法的相邻格
+static Vec2i NextCell(Vec2i head, unsigned long long tick) {
+    static const Vec2i dirs[4] = { {1, 0}, {0, 1}, {-1, 0}, {0, -1} };
+    Vec2i d = dirs[(tick / 64) % 4];
+    return { head.x + d.x, head.y + d.y };
+}
+
+// 跑满 budget 秒，返回 ns/tick
+template <typename TickFn>
+static double Measure(TickFn tick, double budget) {
+    unsigned long long n = 0;
+    auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int i = 0; i < 64; ++i) tick(n++);
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < budget);
+    return elapsed * 1e9 / n;
+}
+
+int main() {
+    const size_t lengths[] = { 10, 1000, 100000, 1000000 };
+    volatile int sink = 0;
+
+    std::printf("%10s %16s %16s\n", "length", "deque ns/tick", "ring ns/tick");
+    for (size_t length : lengths) {
+        std::deque<Vec2i> snake, oldSnake;
+        SnakeBody body(length + 1);
+        for (size_t i = 0; i < length; ++i) {
+            snake.push_back({ 0, 0 });
+            body.PushFront({ 0, 0 });
+        }
+
+        double dequeNs = Measure([&](unsigned long long t) {
+            oldSnake = snake;
+            snake.push_front(NextCell(snake.front(), t));
+            snake.pop_back();
+            sink = sink + oldSnake.back().x;
+        }, 0.25);
+
+        double ringNs = Measure([&](unsigned long long t) {
+            body.BeginTick();
+            body.PushFront(NextCell(body.Front(), t));
+            body.PopBack();
+            sink = sink + body.Previous(body.Size() - 1).x;
+        }, 0.25);
+
+        std::printf("%10zu %16.2f %16.2f\n", length, dequeNs, ringNs);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// 无窗口的逻辑 tick 基准：输出 ns/tick 与 allocations/tick
+// 用法: snake_sim_bench [tick 数] [网格边长]
+#include "../SnakeSim.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> allocCount{ 0 };
+
+void* operator new(std::size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// 简单的贪心策略：朝食物走，快撞墙时转向，让蛇尽量活得久一些
+static SimInput ChooseInput(const SnakeSim& sim) {
+    Vec2i head = sim.Body().Front();
+    Vec2i food = sim.Food();
+    Vec2i dir = sim.Direction();
+    SimInput input;
+    if (food.x != head.x && dir.x == 0) input.dir = { food.x > head.x ? 1 : -1, 0 };
+    else if (food.y != head.y && dir.y == 0) input.dir = { 0, food.y > head.y ? 1 : -1 };
+
+    Vec2i next = { head.x + dir.x, head.y + dir.y };
+    if (input.dir.x == 0 && input.dir.y == 0 &&
+        (next.x < 1 || next.x >= sim.Width() - 1 || next.y < 1 || next.y >= sim.Height() - 1)) {
+        input.dir = dir.x != 0 ? Vec2i{ 0, head.y * 2 < sim.Height() ? 1 : -1 }
+                               : Vec2i{ head.x * 2 < sim.Width() ? 1 : -1, 0 };
+    }
+    return input;
+}
+
+int main(int argc, char** argv) {
+    unsigned long long ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000ULL;
+    int grid = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    SnakeSim sim(grid, grid);
+    unsigned long long deaths = 0, meals = 0, maxLength = 0;
+    // 蛇身不可能比棋盘内部更长，到这个长度就重开一局
+    size_t fullLength = (size_t)(grid - 2) * (grid - 2);
+
+    using Clock = std::chrono::steady_clock;
+    unsigned long long allocsBefore = allocCount.load();
+    auto start = Clock::now();
+    for (unsigned long long i = 0; i < ticks; ++i) {
+        StepResult r = sim.Step(ChooseInput(sim));
+        if (r == ATE) {
+            meals++;
+            if (sim.Body().Size() > maxLength) maxLength = sim.Body().Size();
+            if (sim.Body().Size() >= fullLength) sim.Reset();
+        }
+        else if (r == DIED) {
+            deaths++;
+            sim.Reset();
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    unsigned long long allocs = allocCount.load() - allocsBefore;
+
+    std::printf("grid: %dx%d, ticks: %llu\n", grid, grid, ticks);
+    std::printf("ns/tick:      %.2f\n", ns / ticks);
+    std::printf("ticks/sec:    %.0f\n", ticks / (ns * 1e-9));
+    std::printf("allocs/tick:  %.4f\n", (double)allocs / ticks);
+    std::printf("meals: %llu, deaths: %llu, max length: %llu\n", meals, deaths, maxLength);
+    return 0;
+}
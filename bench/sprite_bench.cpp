@@ -0,0 +1,213 @@
+// 精灵提交基准：逐段 uniform 路径 vs 实例化批次
+// 用法: sprite_bench [段数] [帧数]
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "../SpriteBatch.h"
+#include "../GlExt.h"
+#include "../GlApi.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+static const char* legacyVS = R"(
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTexCoord;
+out vec2 texCoord;
+uniform vec2 offset;
+uniform float angle;
+void main() {
+    mat2 rotation = mat2(cos(angle), -sin(angle), sin(angle), cos(angle));
+    gl_Position = vec4(rotation * aPos + offset, 0.0, 1.0);
+    texCoord = aTexCoord;
+}
+)";
+
+static const char* instancedVS = R"(
+#version 330 core
+layout(location = 0) in vec2 aPos;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec4 aInstance;
+layout(location = 3) in vec4 aColor;
+out vec2 texCoord;
+out vec4 color;
+void main() {
+    mat2 rotation = mat2(cos(aInstance.z), -sin(aInstance.z), sin(aInstance.z), cos(aInstance.z));
+    gl_Position = vec4(rotation * aPos + aInstance.xy, 0.0, 1.0);
+    texCoord = aTexCoord;
+    color = aColor;
+}
+)";
+
+static const char* legacyFS = R"(
+#version 330 core
+in vec2 texCoord;
+out vec4 FragColor;
+uniform vec3 color;
+uniform sampler2D ourTexture;
+uniform bool useTexture;
+void main() {
+    FragColor = useTexture ? texture(ourTexture, texCoord) : vec4(color, 1.0);
+}
+)";
+
+static const char* instancedFS = R"(
+#version 330 core
+in vec2 texCoord;
+in vec4 color;
+out vec4 FragColor;
+uniform sampler2D ourTexture;
+uniform bool useTexture;
+void main() {
+    FragColor = useTexture ? texture(ourTexture, texCoord) : color;
+}
+)";
+
+static GLuint BuildProgram(const char* vs, const char* fs) {
+    GLuint v = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(v, 1, &vs, nullptr);
+    glCompileShader(v);
+    GLuint f = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(f, 1, &fs, nullptr);
+    glCompileShader(f);
+    GLuint p = glCreateProgram();
+    glAttachShader(p, v);
+    glAttachShader(p, f);
+    glLinkProgram(p);
+    glDeleteShader(v);
+    glDeleteShader(f);
+    return p;
+}
+
+static GLuint MakeTexture(unsigned char r, unsigned char g, unsigned char b) {
+    unsigned char pixels[4 * 4 * 4];
+    for (int i = 0; i < 16; ++i) {
+        pixels[i * 4 + 0] = r; pixels[i * 4 + 1] = g; pixels[i * 4 + 2] = b; pixels[i * 4 + 3] = 255;
+    }
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    return tex;
+}
+
+int main(int argc, char** argv) {
+    int segments = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 30;
+
+    if (!glfwInit()) return -1;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(800, 800, "sprite_bench", nullptr, nullptr);
+    if (!window) { glfwTerminate(); return -1; }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return -1;
+    LoadGlExtensions((GLADloadproc)glfwGetProcAddress);
+    LoadGlApi();
+    std::printf("renderer: %s\n", (const char*)glGetString(GL_RENDERER));
+
+    float h = 1.0f / 400.0f;
+    float quad[] = {
+        -h, -h, 0.0f, 0.0f,   h, -h, 1.0f, 0.0f,   h, h, 1.0f, 1.0f,
+        -h, -h, 0.0f, 0.0f,   h,  h, 1.0f, 1.0f,  -h, h, 0.0f, 1.0f
+    };
+    GLuint VBO;
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+
+    GLuint texHead = MakeTexture(255, 0, 0);
+    GLuint texBody = MakeTexture(0, 255, 0);
+    GLuint texFood = MakeTexture(0, 0, 255);
+
+    // 螺旋排列的蛇身
+    std::vector<float> xs(segments), ys(segments);
+    for (int i = 0; i < segments; ++i) {
+        float a = i * 0.01f;
+        float r = 0.9f * (float)i / segments;
+        xs[i] = r * std::cos(a);
+        ys[i] = r * std::sin(a);
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    // 逐段 uniform 路径（原 main 中的写法）
+    GLuint legacy = BuildProgram(legacyVS, legacyFS);
+    GLuint legacyVAO;
+    glGenVertexArrays(1, &legacyVAO);
+    glBindVertexArray(legacyVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    GLint offsetLoc = glGetUniformLocation(legacy, "offset");
+    GLint angleLoc = glGetUniformLocation(legacy, "angle");
+    GLint useTexLoc = glGetUniformLocation(legacy, "useTexture");
+
+    unsigned legacyDraws = 0, legacyChanges = 0;
+    glFinish();
+    auto start = Clock::now();
+    for (int f = 0; f < frames; ++f) {
+        legacyDraws = legacyChanges = 0;
+        glClear(GL_COLOR_BUFFER_BIT);
+        glUseProgram(legacy);
+        glBindVertexArray(legacyVAO);
+        legacyChanges += 2;
+        for (int i = 0; i < segments; ++i) {
+            glUniform2f(offsetLoc, xs[i], ys[i]);
+            glBindTexture(GL_TEXTURE_2D, i == 0 ? texHead : texBody);
+            glUniform1i(useTexLoc, 1);
+            glUniform1f(angleLoc, 0.0f);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            legacyChanges += 4;
+            legacyDraws++;
+        }
+        glUniform2f(offsetLoc, 0.0f, 0.0f);
+        glBindTexture(GL_TEXTURE_2D, texFood);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        legacyChanges += 2;
+        legacyDraws++;
+        glfwSwapBuffers(window);
+    }
+    glFinish();
+    double legacyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+    // 实例化批次
+    GLuint instanced = BuildProgram(instancedVS, instancedFS);
+    SpriteBatch sprites(instanced, VBO);
+    RenderQueue queue;
+    GlStateCache cache;
+    glFinish();
+    start = Clock::now();
+    for (int f = 0; f < frames; ++f) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        sprites.Begin();
+        for (int i = 0; i < segments; ++i)
+            sprites.Add(i == 0 ? texHead : texBody, { xs[i], ys[i], 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f });
+        sprites.Add(texFood, { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f });
+        sprites.Flush(queue);
+        cache.ResetStats();
+        queue.Submit(cache);
+        sprites.Fence();
+        glfwSwapBuffers(window);
+    }
+    glFinish();
+    double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+    const RenderStats& stats = cache.Stats();
+
+    std::printf("segments: %d, frames: %d\n", segments, frames);
+    std::printf("%-10s %12s %12s %14s\n", "path", "ms/frame", "draw calls", "state changes");
+    std::printf("%-10s %12.3f %12u %14u\n", "uniform", legacyMs, legacyDraws, legacyChanges);
+    std::printf("%-10s %12.3f %12u %14u  (%s)\n", "instanced", batchMs, stats.drawCalls, stats.StateChanges(),
+        sprites.Persistent() ? "persistent ring" : "orphaned buffer");
+
+    glfwTerminate();
+    return 0;
+}
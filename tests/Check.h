@@ -0,0 +1,52 @@
+// Check.h
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// snake_tests 用的最小断言：TEST 定义的用例在启动前自动登记，CHECK 失败时打印位置、记一次失败并继续
+// 不依赖第三方测试框架，测试程序与基准程序一样直接用 CMake 构建
+namespace Check {
+
+    struct Case {
+        const char* name;
+        void (*run)();
+    };
+
+    inline std::vector<Case>& Cases() {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    inline int failures = 0;
+
+    // 命令行参数，用例自己取需要的（资源包、黄金值文件的路径）
+    inline std::string assetsPath, goldenPath;
+
+    struct Register {
+        Register(const char* name, void (*run)()) { Cases().push_back({ name, run }); }
+    };
+
+    inline bool Fail(const char* file, int line, const char* expr) {
+        std::printf("  %s:%d: CHECK(%s) failed\n", file, line, expr);
+        failures++;
+        return false;
+    }
+
+    inline bool FailEq(const char* file, int line, const char* a, const char* b, unsigned long long x, unsigned long long y) {
+        std::printf("  %s:%d: CHECK_EQ(%s, %s) failed: %llu != %llu\n", file, line, a, b, x, y);
+        failures++;
+        return false;
+    }
+
+}
+
+#define TEST(name) \
+    static void name(); \
+    static Check::Register name##Register(#name, name); \
+    static void name()
+
+// 返回条件是否成立，前置条件不满足时可以 if (!CHECK(...)) return;
+#define CHECK(cond) ((cond) ? true : Check::Fail(__FILE__, __LINE__, #cond))
+#define CHECK_EQ(a, b) ((unsigned long long)(a) == (unsigned long long)(b) ? true : \
+    Check::FailEq(__FILE__, __LINE__, #a, #b, (unsigned long long)(a), (unsigned long long)(b)))
@@ -0,0 +1,118 @@
+// 联机：客户端用 Apply 重放服务器 Step 算出的增量，每个 tick 的局面都必须与服务器相同
+#include "Check.h"
+#include "../ArenaSim.h"
+#include "../NetProtocol.h"
+#include <cstring>
+
+// 整个局面打成 FULL 包，客户端用它入场
+static size_t FullPacket(const ArenaSim& arena, uint8_t* out, size_t capacity) {
+    out[0] = Net::MSG_FULL;
+    Net::PutU32(out + 1, (uint32_t)arena.Tick());
+    Net::PutU16(out + 5, 0);
+    Net::PutU32(out + 7, arena.StateHash());
+    size_t bytes = Net::WriteFull(arena, out + Net::kSnapshotHeader, capacity - Net::kSnapshotHeader);
+    return bytes ? Net::kSnapshotHeader + bytes : 0;
+}
+
+static void CheckSame(const ArenaSim& a, const ArenaSim& b) {
+    CHECK_EQ(a.Tick(), b.Tick());
+    CHECK_EQ(a.AliveMask(), b.AliveMask());
+    CHECK_EQ(a.StateHash(), b.StateHash());
+    CHECK_EQ(a.Food().size(), b.Food().size());
+    for (int s = 0; s < ArenaSim::kMaxSnakes; ++s) {
+        const ArenaSim::Snake& x = a.GetSnake(s);
+        const ArenaSim::Snake& y = b.GetSnake(s);
+        if (!x.alive || !y.alive) continue;
+        if (!CHECK_EQ(x.body.Size(), y.body.Size())) continue;
+        for (size_t i = 0; i < x.body.Size(); ++i) CHECK(x.body[i] == y.body[i]);
+    }
+}
+
+TEST(ArenaStepApplyEquivalence) {
+    // 小房间挤满随机乱走的蛇，撞墙、撞身体、迎头相撞、重生、有人进出都会出现
+    const int size = 24;
+    ArenaSim server(size, size, 12, 2024);
+    ArenaSim client(size, size, 12, 1);
+    ArenaSim late(size, size, 12, 1);
+    bool lateValid = false;
+    for (int i = 0; i < 16; ++i) CHECK(server.Join() == i);
+
+    Rng input(7);
+    uint8_t packet[Net::kMaxPacket];
+    int deaths = 0, spawns = 0;
+    for (int t = 0; t < 3000; ++t) {
+        for (int s = 0; s < 16; ++s)
+            if (input.Below(4) == 0) server.QueueDirection(s, ArenaSim::kDirs[input.Below(4)]);
+        if (t % 500 == 250) server.Leave((int)input.Below(16));
+        if (t % 500 == 260) server.Join();
+
+        server.Step();
+        const ArenaSim::TickEvents& e = server.Events();
+        for (int s = 0; s < ArenaSim::kMaxSnakes; ++s)
+            if ((e.aliveBefore >> s & 1) && (e.result[s] & ArenaSim::kDied)) deaths++;
+        spawns += (int)e.spawns.size();
+
+        // 直接应用事件
+        size_t bytes = Net::WriteEvents(e, size, size, packet, sizeof(packet));
+        if (!CHECK(bytes > 0)) return;
+        ArenaSim::TickEvents decoded;
+        if (!CHECK(Net::ReadEvents(packet, bytes, client.AliveMask(), size, size, decoded))) return;
+        if (!CHECK(client.Apply(decoded))) return;
+        CheckSame(server, client);
+        if (Check::failures) return;
+
+        // 中途入场的客户端先收完整快照，之后与第一个客户端一样应用增量
+        if (t == 1000) {
+            size_t n = FullPacket(server, packet, sizeof(packet));
+            if (!CHECK(n > 0)) return;
+            CHECK_EQ(Net::ApplySnapshot(packet, n, late, lateValid), Net::APPLIED);
+            CHECK(lateValid);
+        }
+        else if (t > 1000) {
+            CHECK(Net::ReadEvents(packet, bytes, late.AliveMask(), size, size, decoded));
+            CHECK(late.Apply(decoded));
+        }
+        if (t >= 1000) CheckSame(server, late);
+    }
+    // 规则里的各种情况都要真的发生过
+    CHECK(deaths > 100);
+    CHECK(spawns > 100);
+}
+
+TEST(ArenaApplyRejectsMismatch) {
+    // 第一个 tick 蛇出生，第二个 tick 的增量里它是活的；没有收到第一个 tick 的客户端必须拒绝
+    ArenaSim server(16, 16, 4, 5);
+    ArenaSim client(16, 16, 4, 1);
+    server.Join();
+    server.Step();
+    CHECK_EQ(server.Events().spawns.size(), 1);
+    server.Step();
+    CHECK(server.Events().aliveBefore != 0);
+    CHECK(!client.Apply(server.Events()));
+}
+
+// 两条一节的蛇摆在 (5, 5) 和 (6, 5)，各自朝给定的方向走一个 tick，返回结束时活着的蛇
+// 摆放用客户端的 PlaceSnake，Step 只看蛇的状态；没有 Join，死了也不会重生
+static uint32_t StepPair(Vec2i dirA, Vec2i dirB) {
+    ArenaSim server(16, 16, 0, 5);
+    ArenaSim client(16, 16, 0, 1);
+    for (ArenaSim* arena : { &server, &client }) {
+        Vec2i a = { 5, 5 }, b = { 6, 5 };
+        arena->ResetTo(0);
+        CHECK(arena->PlaceSnake(0, &a, 1, dirA));
+        CHECK(arena->PlaceSnake(1, &b, 1, dirB));
+    }
+    server.Step();
+    CHECK(client.Apply(server.Events()));
+    CheckSame(server, client);
+    return server.AliveMask();
+}
+
+TEST(ArenaSwappedHeadsBothDie) {
+    // 面对面同时朝对方走：各自走进对方让开的格子，不能互相穿过去
+    CHECK_EQ(StepPair({ 1, 0 }, { -1, 0 }), 0);
+    // 一前一后同向走：后面的蛇走进前面的蛇让开的格子，都活着
+    CHECK_EQ(StepPair({ 1, 0 }, { 1, 0 }), 3);
+    // 背对背分开
+    CHECK_EQ(StepPair({ -1, 0 }, { 1, 0 }), 3);
+}
@@ -0,0 +1,31 @@
+// CPU 渲染后端的黄金图像：每个场景用每种指令集、单线程与 4 线程画出的 CRC 都等于 tools/golden/ 里的记录
+// 场景与 render_golden 共用 tools/GoldenScenes.h；需要 --assets 与 --golden
+#include "Check.h"
+#include "../tools/GoldenScenes.h"
+#include "../ThreadPool.h"
+#include "../Vfs.h"
+
+TEST(GoldenSoftwareRenderer) {
+    if (!CHECK(!Check::assetsPath.empty() && !Check::goldenPath.empty())) return;
+    Vfs assets;
+    Span atlas;
+    if (assets.Mount(Check::assetsPath.c_str())) atlas = assets.Read("textures.atlas");
+    if (!CHECK(atlas)) return;
+    Golden::Layers l;
+    if (!CHECK(Golden::FindLayers(atlas.data, atlas.size, l))) return;
+    std::map<std::string, uint32_t> golden = Golden::ReadRecords(Check::goldenPath.c_str());
+    CHECK_EQ(golden.size(), sizeof(Golden::kScenes) / sizeof(Golden::kScenes[0]));
+
+    ThreadPool pool(4);
+    for (const Golden::Scene& scene : Golden::kScenes) {
+        auto it = golden.find(scene.name);
+        if (!CHECK(it != golden.end())) continue;
+        for (int threaded = 0; threaded < 2; ++threaded) {
+            for (int isa = SoftRasterizer::SCALAR; isa <= SoftRasterizer::BestIsa(); ++isa) {
+                uint32_t crc = Golden::Render(scene, l, atlas.data, atlas.size, (SoftRasterizer::Isa)isa, threaded ? &pool : nullptr);
+                if (!CHECK_EQ(crc, it->second))
+                    std::printf("  %s: isa %d, %s\n", scene.name, isa, threaded ? "4 threads" : "1 thread");
+            }
+        }
+    }
+}
@@ -0,0 +1,243 @@
+// 渲染提交：RenderQueue 排序之后经 GlStateCache 提交，缓存热了以后每一帧发出的 GL 调用次数
+// 场景与基准程序共用 bench/RenderScenes.h，预期的次数只在这里
+#include "Check.h"
+#include "../bench/RenderScenes.h"
+#include "../Rng.h"
+#include <algorithm>
+#include <cstring>
+
+struct Expected {
+    const char* scene;
+    GlCallCounts counts;
+};
+
+static std::vector<Expected> WarmCounts() {
+    std::vector<Expected> all;
+    GlCallCounts c;
+    // 菜单：只有一组纯色方块，程序、VAO 都没变，只重新绑实例缓冲
+    c = GlCallCounts();
+    c.bindBuffer = 1;
+    c.draws = 1;
+    c.instances = 3;
+    all.push_back({ "menu", c });
+    // 普通棋盘：精灵和边框各切换一次程序与 VAO
+    c = GlCallCounts();
+    c.useProgram = 2;
+    c.bindVertexArray = 2;
+    c.bindBuffer = 1;
+    c.draws = 2;
+    c.instances = 41;
+    all.push_back({ "game", c });
+    // 加上粒子多一次切换，粒子的 uniform 与上一帧相同
+    c = GlCallCounts();
+    c.useProgram = 3;
+    c.bindVertexArray = 3;
+    c.bindBuffer = 1;
+    c.draws = 3;
+    c.instances = 41 + 48;
+    all.push_back({ "particles", c });
+    // 大地图：每块墙换实例缓冲和属性指针，偏移 uniform 每块都不同
+    c = GlCallCounts();
+    c.useProgram = 2;
+    c.bindVertexArray = 2;
+    c.bindBuffer = 5;
+    c.attribPointers = 4;
+    c.uniforms = 4;
+    c.draws = 5;
+    c.instances = 400 + 4 * 64;
+    all.push_back({ "large arena", c });
+    // 交错添加：排序后每个程序只切换一次，纯色与带纹理的精灵各改一次 useTexture
+    c = GlCallCounts();
+    c.useProgram = 3;
+    c.bindVertexArray = 3;
+    c.bindBuffer = 9;
+    c.attribPointers = 2 * 8 + 8;
+    c.uniforms = 2 + 8;
+    c.draws = 17;
+    c.instances = 80 + 8 * 64 + 1;
+    all.push_back({ "interleaved", c });
+    return all;
+}
+
+static void CheckCounts(const GlCallCounts& a, const GlCallCounts& b) {
+    CHECK_EQ(a.useProgram, b.useProgram);
+    CHECK_EQ(a.bindVertexArray, b.bindVertexArray);
+    CHECK_EQ(a.bindBuffer, b.bindBuffer);
+    CHECK_EQ(a.bindTexture, b.bindTexture);
+    CHECK_EQ(a.enable, b.enable);
+    CHECK_EQ(a.disable, b.disable);
+    CHECK_EQ(a.lineWidth, b.lineWidth);
+    CHECK_EQ(a.uniforms, b.uniforms);
+    CHECK_EQ(a.attribPointers, b.attribPointers);
+    CHECK_EQ(a.draws, b.draws);
+    CHECK_EQ(a.instances, b.instances);
+}
+
+TEST(RenderWarmFrameCalls) {
+    GlApi api = GlMock::Api();
+    std::vector<Scene> scenes = Scenes();
+    std::vector<Expected> expected = WarmCounts();
+    CHECK_EQ(scenes.size(), expected.size());
+    for (const Expected& e : expected) {
+        const Scene* scene = nullptr;
+        for (const Scene& s : scenes)
+            if (std::strcmp(s.name, e.scene) == 0) scene = &s;
+        if (!CHECK(scene != nullptr)) continue;
+        std::printf("  %s\n", e.scene);
+
+        GlStateCache cache(api);
+        RenderQueue q;
+        GlMock::counts = GlCallCounts();
+        Build(*scene, q);
+        q.Submit(cache);
+        GlCallCounts cold = GlMock::counts;
+        // 冷启动的第一帧画的东西与之后相同，状态调用只多不少
+        CHECK_EQ(cold.draws, e.counts.draws);
+        CHECK_EQ(cold.instances, e.counts.instances);
+        CHECK(cold.Total() >= e.counts.Total());
+
+        // 与 GlRenderer::EndFrame 一样每帧清零统计
+        for (int frame = 0; frame < 3; ++frame) {
+            GlMock::counts = GlCallCounts();
+            cache.ResetStats();
+            Build(*scene, q);
+            q.Submit(cache);
+            CheckCounts(GlMock::counts, e.counts);
+            CHECK_EQ(cache.Stats().drawCalls, e.counts.draws);
+        }
+    }
+}
+
+TEST(RenderInvalidateResendsState) {
+    // Invalidate 之后缓存忘掉全部影子状态，下一帧与冷启动的第一帧相同
+    GlApi api = GlMock::Api();
+    for (const Scene& scene : Scenes()) {
+        GlStateCache cache(api);
+        RenderQueue q;
+        GlMock::counts = GlCallCounts();
+        Build(scene, q);
+        q.Submit(cache);
+        GlCallCounts cold = GlMock::counts;
+        Build(scene, q);
+        q.Submit(cache);
+        cache.Invalidate();
+        GlMock::counts = GlCallCounts();
+        Build(scene, q);
+        q.Submit(cache);
+        CheckCounts(GlMock::counts, cold);
+    }
+}
+
+TEST(RenderGroupsRandomCommands) {
+    // 随机状态的命令：排序后每种 (遍, 程序) 最多切换一次程序，每种 (遍, 程序, 纹理) 最多绑一次纹理
+    static const int kPrograms = 4, kTextures = 8, kVaos = 4;
+    const size_t n = 20000;
+    Rng rng(n);
+    RenderQueue q;
+    for (size_t i = 0; i < n; ++i) {
+        RenderCommand& c = q.Add((RenderPass)rng.Below(PASS_COUNT));
+        c.program = 1 + (GLuint)rng.Below(kPrograms);
+        c.texture = 1 + (GLuint)rng.Below(kTextures);
+        c.vao = 1 + (GLuint)rng.Below(kVaos);
+        c.count = 6;
+    }
+    GlApi api = GlMock::Api();
+    GlStateCache cache(api);
+    GlMock::counts = GlCallCounts();
+    q.Submit(cache);
+    const GlCallCounts& c = GlMock::counts;
+    CHECK_EQ(c.draws, n);
+    CHECK(c.useProgram <= PASS_COUNT * kPrograms);
+    CHECK(c.bindTexture <= PASS_COUNT * kPrograms * kTextures);
+    CHECK(c.bindVertexArray <= PASS_COUNT * kPrograms * kTextures * kVaos);
+    CHECK_EQ(q.Size(), 0);
+}
+
+TEST(RenderRadixSortMatchesStdSort) {
+    for (size_t n : { (size_t)0, (size_t)1, (size_t)2, (size_t)100, (size_t)10000, (size_t)1 << 18 }) {
+        Rng rng(n * 7 + 1);
+        std::vector<uint64_t> keys(n), scratch;
+        // 高位只有几种取值、低位是序号，和真实的排序键一样；再混进一些完全随机的键
+        for (size_t i = 0; i < n; ++i)
+            keys[i] = i % 16 == 0 ? rng.Next() :
+                ((uint64_t)rng.Below(3) << 60) | ((uint64_t)rng.Below(16) << 48) | ((uint64_t)rng.Below(64) << 32) | (i & 0xFFFFF);
+        std::vector<uint64_t> expected = keys;
+        std::sort(expected.begin(), expected.end());
+        RenderQueue::RadixSort(keys, scratch);
+        CHECK(keys == expected);
+    }
+}
+
+static std::vector<GLint> drawOrder;
+static void APIENTRY RecordDraw(GLenum, GLint first, GLsizei) { drawOrder.push_back(first); }
+
+TEST(RenderKeepsAddOrderWithinState) {
+    // 状态完全相同的命令仍按添加顺序画：用 first 区分，提交时记录画的顺序
+    GlApi api = GlMock::Api();
+    api.DrawArrays = RecordDraw;
+    drawOrder.clear();
+    RenderQueue q;
+    for (int i = 0; i < 10; ++i) {
+        RenderCommand& c = q.Add(i % 2 ? PASS_OVERLAY : PASS_SPRITES);
+        c.program = 1;
+        c.first = i;
+        c.count = 3;
+    }
+    GlStateCache cache(api);
+    q.Submit(cache);
+    const GLint expected[] = { 0, 2, 4, 6, 8, 1, 3, 5, 7, 9 };
+    if (!CHECK_EQ(drawOrder.size(), 10)) return;
+    for (int i = 0; i < 10; ++i) CHECK_EQ(drawOrder[i], expected[i]);
+}
+
+static std::vector<GLuint> programOrder;
+static void APIENTRY RecordProgram(GLuint program) { programOrder.push_back(program); }
+
+TEST(RenderPassOrder) {
+    // 精灵、墙、粒子、边框，不管按什么顺序添加、程序名谁大谁小，画的先后只看遍
+    for (GLuint particleProgram : { (GLuint)1, (GLuint)PARTICLE_PROGRAM, (GLuint)100 }) {
+        GlApi api = GlMock::Api();
+        api.UseProgram = RecordProgram;
+        programOrder.clear();
+        RenderQueue q;
+        Border(q);
+        Particles(q, 10);
+        q.Add(PASS_PARTICLES).program = particleProgram;
+        WallChunk(q, 20, 0.0f, 0.0f);
+        SpriteGroup(q, ATLAS, 0, 10);
+        GlStateCache cache(api);
+        q.Submit(cache);
+        std::vector<GLuint> expected = { SPRITE_PROGRAM, TILE_PROGRAM };
+        // 同一遍里按程序名排序
+        if (particleProgram < PARTICLE_PROGRAM) expected.insert(expected.end(), { particleProgram, PARTICLE_PROGRAM });
+        else if (particleProgram > PARTICLE_PROGRAM) expected.insert(expected.end(), { PARTICLE_PROGRAM, particleProgram });
+        else expected.push_back(PARTICLE_PROGRAM);
+        expected.push_back(BORDER_PROGRAM);
+        CHECK(programOrder == expected);
+    }
+}
+
+static std::vector<int> passOrder;
+static void RecordPass(void* user, RenderPass pass) {
+    passOrder.push_back(pass);
+    (*(int*)user)++;
+}
+
+TEST(RenderPassCallback) {
+    // 每进入一遍通知一次，空的遍跳过，最后以 PASS_COUNT 收尾；队列为空时一次也不通知
+    int calls = 0;
+    passOrder.clear();
+    RenderQueue q;
+    GlApi api = GlMock::Api();
+    GlStateCache cache(api);
+    q.Submit(cache, RecordPass, &calls);
+    CHECK_EQ(calls, 0);
+    Border(q);
+    SpriteGroup(q, ATLAS, 0, 10);
+    SpriteGroup(q, 0, 10, 10);
+    Particles(q, 10);
+    q.Submit(cache, RecordPass, &calls);
+    const std::vector<int> expected = { PASS_SPRITES, PASS_PARTICLES, PASS_OVERLAY, PASS_COUNT };
+    CHECK(passOrder == expected);
+    CHECK_EQ(calls, 4);
+}
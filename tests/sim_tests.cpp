@@ -0,0 +1,113 @@
+// SnakeSim 的规则：撞墙、蛇尾让开的例外、食物只放在空格上
+#include "Check.h"
+#include "../SnakeSim.h"
+#include "../SnakeRules.h"
+#include "../Autopilot.h"
+
+// 蛇短于 5 节时撞不到自己，朝食物直走即可；食物在正后方时先拐向棋盘中央
+static bool GrowTo(SnakeSim& sim, size_t length) {
+    for (int i = 0; i < 10000 && sim.Body().Size() < length; ++i) {
+        Vec2i head = sim.Body().Front(), f = sim.Food(), dir = sim.Direction();
+        Vec2i want = f.x != head.x ? Vec2i{ f.x > head.x ? 1 : -1, 0 } : Vec2i{ 0, f.y > head.y ? 1 : -1 };
+        if (want.x == -dir.x && want.y == -dir.y)
+            want = dir.x != 0 ? Vec2i{ 0, head.y * 2 < sim.Height() ? 1 : -1 } : Vec2i{ head.x * 2 < sim.Width() ? 1 : -1, 0 };
+        if (!(want == dir)) sim.QueueDirection(want);
+        if (sim.Step() == DIED) return false;
+    }
+    return sim.Body().Size() == length;
+}
+
+TEST(SimWallDeath) {
+    // 20x20 的棋盘从 (10, 10) 向右出发，x = 19 是墙：走 8 步到 (18, 10)，第 9 步撞墙
+    SnakeSim sim(20, 20, 1);
+    for (int i = 0; i < 8; ++i) CHECK(sim.Step() != DIED);
+    CHECK(sim.Body().Front() == (Vec2i{ 18, 10 }));
+    CHECK_EQ(sim.Step(), DIED);
+    CHECK_EQ(sim.Death(), HIT_WALL);
+    CHECK(!sim.Alive());
+    // 死了之后不再推进
+    unsigned long long tick = sim.Tick();
+    CHECK_EQ(sim.Step(), DIED);
+    CHECK_EQ(sim.Tick(), tick);
+    CHECK(sim.Body().Front() == (Vec2i{ 18, 10 }));
+}
+
+TEST(SimTailException) {
+    CHECK(!SnakeRules::HitsBody(true, true, false));
+    CHECK(SnakeRules::HitsBody(true, true, true));
+    CHECK(SnakeRules::HitsBody(true, false, false));
+    CHECK(!SnakeRules::HitsBody(false, false, true));
+
+    // 4 节的蛇先拉直，再连续左转绕 2x2 的方块：每一步蛇头都走进正在让开的尾格
+    // 拉直和绕圈的路上不能有食物，换种子直到有一局满足
+    int played = 0;
+    for (uint64_t seed = 1; seed <= 64 && !played; ++seed) {
+        SnakeSim sim(20, 20, seed);
+        if (!GrowTo(sim, 4)) continue;
+        Vec2i d = sim.Direction(), head = sim.Body().Front();
+        Vec2i left = { -d.y, d.x };
+        bool clear = true;
+        for (int k = 1; k <= 3; ++k) {
+            Vec2i c = { head.x + d.x * k, head.y + d.y * k };
+            clear &= !SnakeRules::HitsWall(c, 20, 20) && !sim.Occupied(c) && !(c == sim.Food());
+        }
+        Vec2i corner = { head.x + d.x * 3 + left.x, head.y + d.y * 3 + left.y };
+        Vec2i back = { corner.x - d.x, corner.y - d.y };
+        clear &= !SnakeRules::HitsWall(corner, 20, 20) && !SnakeRules::HitsWall(back, 20, 20) &&
+            !sim.Occupied(corner) && !sim.Occupied(back) && !(corner == sim.Food()) && !(back == sim.Food());
+        if (!clear) continue;
+
+        for (int k = 0; k < 3; ++k) CHECK_EQ(sim.Step(), MOVED);
+        Vec2i dir = d;
+        for (int k = 0; k < 12; ++k) {
+            dir = { -dir.y, dir.x };
+            Vec2i tail = sim.Body().Back();
+            sim.QueueDirection(dir);
+            StepResult r = sim.Step();
+            CHECK_EQ(r, MOVED);
+            if (r == DIED) break;
+            // 第二次左转之后，每一步的新头都是上一个 tick 的尾格
+            if (k >= 2) CHECK(sim.Body().Front() == tail);
+            CHECK_EQ(sim.Body().Size(), 4);
+        }
+        played++;
+    }
+    CHECK(played == 1);
+}
+
+// 每次生成的食物都在棋盘内部、不在墙上也不在蛇身上；填满之后食物放到棋盘外
+static void CheckFood(const SnakeSim& sim) {
+    Vec2i f = sim.Food();
+    if (f.x < 0) return;
+    CHECK(!SnakeRules::HitsWall(f, sim.Width(), sim.Height()));
+    CHECK(!sim.Occupied(f));
+    for (size_t i = 0; i < sim.Body().Size(); ++i) CHECK(!(sim.Body()[i] == f));
+}
+
+TEST(SimFoodOnFreeCell) {
+    // 8x8 的棋盘内部 36 格，自动驾驶一直玩到填满，占用率越高越容易把食物放错
+    int full = 0;
+    for (uint64_t seed = 1; seed <= 8; ++seed) {
+        SnakeSim sim(8, 8, seed);
+        Autopilot pilot(8, 8);
+        pilot.cycleThreshold = 0.0f;
+        CheckFood(sim);
+        for (int i = 0; i < 20000 && sim.Alive() && sim.Food().x >= 0; ++i) {
+            Vec2i d = pilot.NextDirection(sim);
+            if (!(d == sim.Direction())) sim.QueueDirection(d);
+            if (sim.Step() == ATE) CheckFood(sim);
+        }
+        if (sim.Food().x < 0) {
+            CHECK_EQ(sim.Body().Size(), 36);
+            full++;
+        }
+    }
+    CHECK(full > 0);
+
+    // 超过 kMaxDenseCells 的大地图没有占用位图，食物靠拒绝采样
+    SnakeSim sparse(5000, 5000, 3);
+    CHECK(sparse.Chunks() != nullptr);
+    CheckFood(sparse);
+    CHECK(GrowTo(sparse, 4));
+    CheckFood(sparse);
+}
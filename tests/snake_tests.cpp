@@ -0,0 +1,29 @@
+// 单元测试：游戏规则、录像、联机同步、渲染提交、CPU 渲染的黄金图像，全部不需要窗口和显卡
+// 用法: snake_tests [--assets assets.pak] [--golden render_golden.txt] [名字...]
+// 给出名字时只跑名字里含有其中任一字符串的用例；有失败时返回 1
+// 黄金图像用例需要 --assets 与 --golden，ctest 会传入构建目录里的资源包和 tools/golden/ 下的记录
+#include "Check.h"
+#include <cstring>
+
+int main(int argc, char** argv) {
+    std::vector<const char*> filters;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--assets") == 0 && i + 1 < argc) Check::assetsPath = argv[++i];
+        else if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc) Check::goldenPath = argv[++i];
+        else filters.push_back(argv[i]);
+    }
+
+    int run = 0, failed = 0;
+    for (const Check::Case& c : Check::Cases()) {
+        bool wanted = filters.empty();
+        for (const char* f : filters) wanted |= std::strstr(c.name, f) != nullptr;
+        if (!wanted) continue;
+        int before = Check::failures;
+        std::printf("%s\n", c.name);
+        c.run();
+        run++;
+        if (Check::failures != before) failed++;
+    }
+    std::printf("%d test(s), %d failed, %d check(s) failed\n", run, failed, Check::failures);
+    return Check::failures ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+// GoldenScenes.h
+#pragma once
+#include "../SoftRasterizer.h"
+#include "../AssetPack.h"
+#include "../AtlasFormat.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// 黄金图像的固定场景，render_golden 和 snake_tests 共用
+// 记录文件每行 "场景 宽 高 crc32"，# 开头为注释
+namespace Golden {
+
+    const int kWidth = 320, kHeight = 240;
+    const int kViewCells = 20;
+
+    // 与游戏相同：屏幕 20 格，精灵半边长 1/21
+    inline SpriteInstance Cell(int x, int y, float angle, float layer, int viewCells = kViewCells) {
+        float cell = 2.0f / viewCells;
+        return { (x + 0.5f - viewCells / 2.0f) * cell, (y + 0.5f - viewCells / 2.0f) * cell, angle, layer, 1.0f, 1.0f, 1.0f, 1.0f };
+    }
+
+    struct Layers {
+        float head, body, food;
+    };
+
+    inline void SceneMenu(SoftRasterizer& r, const Layers&) {
+        r.SetQuadHalfSize(1.0f / (kViewCells + 1));
+        r.BeginFrame(0.2f, 0.3f, 0.25f);
+        for (int i = 0; i < 3; ++i) {
+            float y = 0.4f - i * 0.3f;
+            if (i == 1) r.AddSprite(false, { 0.0f, y, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f });
+            else r.AddSprite(false, { 0.0f, y, 0.0f, 0.0f, 0.6f, 0.6f, 0.6f, 1.0f });
+        }
+        r.Flush();
+    }
+
+    inline void SceneGame(SoftRasterizer& r, const Layers& l) {
+        r.SetQuadHalfSize(1.0f / (kViewCells + 1));
+        r.BeginFrame(0.2f, 0.3f, 0.25f);
+        // 一条拐了两个弯的蛇，蛇头朝右
+        const int body[][2] = { { 3, 4 }, { 4, 4 }, { 5, 4 }, { 6, 4 }, { 6, 5 }, { 6, 6 }, { 6, 7 }, { 7, 7 }, { 8, 7 }, { 9, 7 } };
+        for (const auto& c : body) r.AddSprite(true, Cell(c[0], c[1], 0.0f, l.body));
+        r.AddSprite(true, Cell(10, 7, 90.0f * 3.14159265f / 180.0f, l.head));
+        r.AddSprite(true, Cell(14, 12, 0.0f, l.food));
+        r.Flush();
+        r.DrawBorder();
+    }
+
+    inline void SceneBlend(SoftRasterizer& r, const Layers& l) {
+        // 大号的旋转四边形互相叠加，检查旋转方向、半透明混合和纹理坐标
+        r.SetQuadHalfSize(0.35f);
+        r.BeginFrame(0.1f, 0.1f, 0.1f);
+        r.AddSprite(false, { -0.3f, 0.1f, 0.3f, 0.0f, 1.0f, 0.2f, 0.2f, 0.5f });
+        r.AddSprite(false, { 0.0f, -0.1f, 1.0f, 0.0f, 0.2f, 1.0f, 0.2f, 0.5f });
+        r.AddSprite(true, { 0.35f, 0.2f, 2.5f, l.head, 1.0f, 1.0f, 1.0f, 1.0f });
+        r.AddSprite(false, { 0.2f, -0.4f, -0.7f, 0.0f, 0.2f, 0.3f, 1.0f, 0.25f });
+        r.Flush();
+    }
+
+    inline void SceneDense(SoftRasterizer& r, const Layers& l) {
+        // 缩小到 60 格一屏，3000 节的蛇形排布，每节只有几个像素
+        const int view = 60, length = 3000;
+        r.SetQuadHalfSize(1.0f / (view + 1));
+        r.BeginFrame(0.2f, 0.3f, 0.25f);
+        for (int k = 0; k < length; ++k) {
+            int y = k / view, x = k % view;
+            if (y % 2) x = view - 1 - x;
+            r.AddSprite(true, Cell(x, y, 0.0f, k == length - 1 ? l.head : l.body, view));
+        }
+        r.Flush();
+        r.DrawBorder();
+    }
+
+    struct Scene {
+        const char* name;
+        void (*draw)(SoftRasterizer&, const Layers&);
+    };
+
+    const Scene kScenes[] = {
+        { "menu", SceneMenu },
+        { "game", SceneGame },
+        { "blend", SceneBlend },
+        { "dense", SceneDense },
+    };
+
+    // 层号与游戏一样按文件名查；图集格式不对时返回 false
+    inline bool FindLayers(const uint8_t* atlas, size_t size, Layers& l) {
+        l = { 0.0f, 0.0f, 0.0f };
+        const AtlasHeader* header;
+        const AtlasEntry* entries;
+        if (!Atlas::Parse(atlas, size, header, entries)) return false;
+        for (uint32_t i = 0; i < header->layers; ++i) {
+            if (std::strcmp(entries[i].name, "snake_head.png") == 0) l.head = (float)i;
+            if (std::strcmp(entries[i].name, "snake_body1.png") == 0) l.body = (float)i;
+            if (std::strcmp(entries[i].name, "food.png") == 0) l.food = (float)i;
+        }
+        return true;
+    }
+
+    // 用指定的指令集和线程池画一个场景，返回 RGBA8 帧缓冲的 CRC32；image 不为空时拷出画面
+    inline uint32_t Render(const Scene& scene, const Layers& l, const uint8_t* atlas, size_t atlasSize,
+        SoftRasterizer::Isa isa, ThreadPool* pool, std::vector<uint32_t>* image = nullptr) {
+        SoftRasterizer r(kWidth, kHeight, 1.0f / (kViewCells + 1), pool);
+        r.SetAtlas(atlas, atlasSize);
+        r.SetIsa(isa);
+        scene.draw(r, l);
+        if (image) image->assign(r.Pixels(), r.Pixels() + (size_t)kWidth * kHeight);
+        return AssetPack::Crc32(r.Pixels(), (size_t)kWidth * kHeight * 4);
+    }
+
+    // 读记录，尺寸与 kWidth x kHeight 不同的行忽略；文件打不开时返回空表
+    inline std::map<std::string, uint32_t> ReadRecords(const char* path) {
+        std::map<std::string, uint32_t> golden;
+        if (FILE* f = std::fopen(path, "r")) {
+            char line[256], name[64];
+            int w, h;
+            unsigned crc;
+            while (std::fgets(line, sizeof(line), f)) {
+                if (line[0] == '#') continue;
+                if (std::sscanf(line, "%63s %d %d %x", name, &w, &h, &crc) == 4 && w == kWidth && h == kHeight) golden[name] = crc;
+            }
+            std::fclose(f);
+        }
+        return golden;
+    }
+
+}
@@ -0,0 +1,143 @@
+// 资源打包：把若干目录（递归）和单独的文件写成一个 .pak，索引按名字排序，内容按 64 字节对齐，每项带 CRC32
+// 用法: asset_packer <out.pak> <资源根目录> <目录>... [--add 名字=路径]...
+//       asset_packer --verify <file.pak>
+#include "../AssetPack.h"
+#include "../Vfs.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct Input {
+    std::string name;
+    std::string path;
+    std::vector<uint8_t> bytes;
+};
+
+static bool ReadAll(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    bool ok = size >= 0 && std::fread(out.data(), 1, out.size(), f) == out.size();
+    std::fclose(f);
+    return ok;
+}
+
+static int Verify(const char* path) {
+    Vfs vfs;
+    if (!vfs.Mount(path)) {
+        std::fprintf(stderr, "%s: cannot open or malformed\n", path);
+        return 1;
+    }
+    unsigned failures = vfs.VerifyAll();
+    std::printf("%s: %u entries, %u checksum failures\n", path, vfs.EntryCount(), failures);
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--verify") == 0) return Verify(argv[2]);
+    if (argc < 4) {
+        std::fprintf(stderr, "usage: %s <out.pak> <root> <dir>... [--add name=path]...\n"
+            "       %s --verify <file.pak>\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    std::vector<Input> inputs;
+    fs::path root = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--add") == 0 && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos || eq == 0) {
+                std::fprintf(stderr, "--add expects name=path, got %s\n", spec.c_str());
+                return 2;
+            }
+            inputs.push_back({ spec.substr(0, eq), spec.substr(eq + 1), {} });
+            continue;
+        }
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(root / argv[i], ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file()) continue;
+            // 名字用相对根目录的路径，分隔符统一为 '/'
+            inputs.push_back({ it->path().lexically_relative(root).generic_string(), it->path().string(), {} });
+        }
+        if (ec) {
+            std::fprintf(stderr, "%s: %s\n", (root / argv[i]).string().c_str(), ec.message().c_str());
+            return 1;
+        }
+    }
+    std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) { return a.name < b.name; });
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        if (inputs[i].name == inputs[i - 1].name) {
+            std::fprintf(stderr, "duplicate entry %s\n", inputs[i].name.c_str());
+            return 1;
+        }
+    }
+
+    // 索引、名字区，然后是对齐的内容
+    PakHeader header;
+    std::memcpy(header.magic, "SNPK", 4);
+    header.version = AssetPack::kVersion;
+    header.count = (uint32_t)inputs.size();
+    std::string names;
+    std::vector<PakEntry> entries(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        entries[i].nameOffset = (uint32_t)names.size();
+        entries[i].nameLength = (uint32_t)inputs[i].name.size();
+        entries[i].reserved = 0;
+        names += inputs[i].name;
+    }
+    header.namesSize = (uint32_t)names.size();
+
+    uint64_t offset = sizeof(PakHeader) + sizeof(PakEntry) * entries.size() + names.size();
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!ReadAll(inputs[i].path, inputs[i].bytes)) {
+            std::fprintf(stderr, "%s: cannot read\n", inputs[i].path.c_str());
+            return 1;
+        }
+        offset = (offset + AssetPack::kAlignment - 1) / AssetPack::kAlignment * AssetPack::kAlignment;
+        entries[i].offset = offset;
+        entries[i].size = inputs[i].bytes.size();
+        entries[i].crc = AssetPack::Crc32(inputs[i].bytes.data(), inputs[i].bytes.size());
+        offset += inputs[i].bytes.size();
+        totalBytes += inputs[i].bytes.size();
+    }
+
+    // 先写临时文件再改名，游戏同时启动也不会读到半个文件
+    std::string out = argv[1], temp = out + ".tmp";
+    FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "%s: cannot write\n", temp.c_str());
+        return 1;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+        std::fwrite(entries.data(), sizeof(PakEntry), entries.size(), f) == entries.size() &&
+        std::fwrite(names.data(), 1, names.size(), f) == names.size();
+    uint64_t written = sizeof(PakHeader) + sizeof(PakEntry) * entries.size() + names.size();
+    static const char zeros[AssetPack::kAlignment] = {};
+    for (size_t i = 0; ok && i < inputs.size(); ++i) {
+        size_t pad = (size_t)(entries[i].offset - written);
+        ok = std::fwrite(zeros, 1, pad, f) == pad &&
+            std::fwrite(inputs[i].bytes.data(), 1, inputs[i].bytes.size(), f) == inputs[i].bytes.size();
+        written = entries[i].offset + entries[i].size;
+    }
+    ok = std::fclose(f) == 0 && ok;
+    std::error_code ec;
+    if (ok) fs::rename(temp, out, ec);
+    if (!ok || ec) {
+        fs::remove(temp, ec);
+        std::fprintf(stderr, "%s: write failed\n", out.c_str());
+        return 1;
+    }
+    std::printf("%s: %zu entries, %zu bytes of content, %llu bytes total\n",
+        out.c_str(), inputs.size(), totalBytes, (unsigned long long)written);
+    return 0;
+}
@@ -0,0 +1,104 @@
+// 纹理图集烘焙：把目录里的 .png/.jpg 解码后放进同一张数组纹理，预先算好全部 mip，写成可以直接上传的 .atlas
+// 用法: atlas_baker <textures 目录> <out.atlas> [--size N]
+// 每张图占一层，层边长默认 32；比层大的图等比缩小，UV 范围记在文件里
+#define STB_IMAGE_IMPLEMENTATION
+#include "../external/stb/stb_image.h"
+#include "../AtlasFormat.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool IsImage(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <textures dir> <out.atlas> [--size N]\n", argv[0]);
+        return 2;
+    }
+    int size = 32;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = std::atoi(argv[++i]);
+    }
+    if (size < 1 || size > 8192 || (size & (size - 1)) != 0) {
+        std::fprintf(stderr, "--size must be a power of two\n");
+        return 2;
+    }
+
+    // 按文件名排序，同样的输入总是得到同样的文件
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const fs::directory_entry& e : fs::directory_iterator(argv[1], ec))
+        if (e.is_regular_file() && IsImage(e.path())) names.push_back(e.path().filename().string());
+    if (ec || names.empty()) {
+        std::fprintf(stderr, "%s: no images\n", argv[1]);
+        return 1;
+    }
+    std::sort(names.begin(), names.end());
+    if ((int)names.size() > Atlas::kMaxLayers) {
+        std::fprintf(stderr, "%zu images, at most %d layers\n", names.size(), Atlas::kMaxLayers);
+        return 1;
+    }
+
+    int layers = (int)names.size();
+    std::vector<AtlasEntry> entries(layers);
+    std::vector<uint8_t> pixels(Atlas::LevelBytes(size, layers, 0));
+    size_t layerBytes = (size_t)size * size * 4;
+    for (int i = 0; i < layers; ++i) {
+        if (names[i].size() >= sizeof(entries[i].name)) {
+            std::fprintf(stderr, "%s: name too long\n", names[i].c_str());
+            return 1;
+        }
+        std::string path = (fs::path(argv[1]) / names[i]).string();
+        int width, height, channels;
+        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (!data) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), stbi_failure_reason());
+            return 1;
+        }
+        std::memset(entries[i].name, 0, sizeof(entries[i].name));
+        std::memcpy(entries[i].name, names[i].c_str(), names[i].size());
+        Atlas::FitToLayer(data, width, height, size, &pixels[layerBytes * i], entries[i]);
+        stbi_image_free(data);
+        std::printf("  %2d %-24s %4dx%-4d -> uv %.3f x %.3f\n", i, names[i].c_str(), width, height, entries[i].u1, entries[i].v1);
+    }
+    Atlas::AppendLevels(pixels, size, layers);
+
+    AtlasHeader header;
+    std::memcpy(header.magic, "SNKA", 4);
+    header.version = Atlas::kVersion;
+    header.size = (uint32_t)size;
+    header.layers = (uint32_t)layers;
+    header.levels = (uint32_t)Atlas::LevelCount(size);
+
+    // 先写临时文件再改名，游戏同时启动也不会读到半个文件
+    std::string out = argv[2], temp = out + ".tmp";
+    FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) {
+        std::fprintf(stderr, "%s: cannot write\n", temp.c_str());
+        return 1;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+        std::fwrite(entries.data(), sizeof(AtlasEntry), entries.size(), f) == entries.size() &&
+        std::fwrite(pixels.data(), 1, pixels.size(), f) == pixels.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (ok) fs::rename(temp, out, ec);
+    if (!ok || ec) {
+        fs::remove(temp, ec);
+        std::fprintf(stderr, "%s: write failed\n", out.c_str());
+        return 1;
+    }
+    std::printf("%s: %d layers of %dx%d, %u mip levels, %zu bytes\n",
+        out.c_str(), layers, size, size, header.levels, Atlas::DataOffset(layers) + pixels.size());
+    return 0;
+}
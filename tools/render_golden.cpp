@@ -0,0 +1,111 @@
+// 黄金图像比对：用 CPU 渲染后端画几个固定场景，与记录下来的 CRC32 逐像素比对
+// 用法: render_golden <assets.pak> <golden.txt> [--update] [--dump 目录]
+// 每个场景用每种指令集、单线程与 4 线程各画一遍，结果必须完全相同；
+// 与记录不符时把画面写成 <目录>/<场景>.ppm 方便查看，--update 重新记录
+// 黄金值依赖 libm 的 sin/cos，换了平台或工具链可能需要 --update
+#include "GoldenScenes.h"
+#include "../ThreadPool.h"
+#include "../Vfs.h"
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace Golden;
+
+static bool WritePpm(const std::string& path, const uint32_t* pixels) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", kWidth, kHeight);
+    std::vector<uint8_t> rgb((size_t)kWidth * kHeight * 3);
+    for (size_t i = 0; i < (size_t)kWidth * kHeight; ++i) {
+        rgb[i * 3 + 0] = (uint8_t)(pixels[i]);
+        rgb[i * 3 + 1] = (uint8_t)(pixels[i] >> 8);
+        rgb[i * 3 + 2] = (uint8_t)(pixels[i] >> 16);
+    }
+    bool ok = std::fwrite(rgb.data(), 1, rgb.size(), f) == rgb.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <assets.pak> <golden.txt> [--update] [--dump dir]\n", argv[0]);
+        return 2;
+    }
+    bool update = false;
+    std::string dumpDir = ".";
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--update") == 0) update = true;
+        else if (std::strcmp(argv[i], "--dump") == 0 && i + 1 < argc) dumpDir = argv[++i];
+    }
+
+    Vfs assets;
+    Span atlasFile;
+    if (assets.Mount(argv[1])) atlasFile = assets.Read("textures.atlas");
+    if (!atlasFile) {
+        std::fprintf(stderr, "%s: no textures.atlas\n", argv[1]);
+        return 1;
+    }
+
+    std::map<std::string, uint32_t> golden = ReadRecords(argv[2]);
+    Layers l;
+    if (!FindLayers(atlasFile.data, atlasFile.size, l)) {
+        std::fprintf(stderr, "%s: bad textures.atlas\n", argv[1]);
+        return 1;
+    }
+
+    const char* isaNames[] = { "scalar", "sse2", "avx2" };
+    ThreadPool pool(4);
+    int failures = 0;
+    std::vector<std::pair<std::string, uint32_t>> results;
+    for (const Scene& scene : kScenes) {
+        uint32_t reference = 0;
+        std::vector<uint32_t> image;
+        bool first = true;
+        for (int threaded = 0; threaded < 2; ++threaded) {
+            for (int isa = SoftRasterizer::SCALAR; isa <= SoftRasterizer::BestIsa(); ++isa) {
+                uint32_t crc = Render(scene, l, atlasFile.data, atlasFile.size, (SoftRasterizer::Isa)isa,
+                    threaded ? &pool : nullptr, first ? &image : nullptr);
+                if (first) {
+                    reference = crc;
+                    first = false;
+                }
+                else if (crc != reference) {
+                    std::printf("%-6s %s %s: %08x, differs from the first configuration (%08x)\n",
+                        scene.name, isaNames[isa], threaded ? "4 threads" : "1 thread", crc, reference);
+                    failures++;
+                }
+            }
+        }
+        results.push_back({ scene.name, reference });
+        if (update) continue;
+        auto it = golden.find(scene.name);
+        if (it == golden.end()) {
+            std::printf("%-6s %08x  no golden value\n", scene.name, reference);
+            failures++;
+        }
+        else if (it->second != reference) {
+            std::string path = dumpDir + "/" + scene.name + ".ppm";
+            WritePpm(path, image.data());
+            std::printf("%-6s %08x  MISMATCH, expected %08x, image written to %s\n", scene.name, reference, it->second, path.c_str());
+            failures++;
+        }
+        else {
+            std::printf("%-6s %08x  ok\n", scene.name, reference);
+        }
+    }
+
+    if (update) {
+        FILE* f = std::fopen(argv[2], "w");
+        if (!f) {
+            std::fprintf(stderr, "%s: cannot write\n", argv[2]);
+            return 1;
+        }
+        std::fprintf(f, "# render_golden: scene width height crc32 of the RGBA8 framebuffer\n");
+        for (const auto& r : results) std::fprintf(f, "%s %d %d %08x\n", r.first.c_str(), kWidth, kHeight, r.second);
+        std::fclose(f);
+        std::printf("%zu golden values written to %s\n", results.size(), argv[2]);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// 录像渲染：无窗口、无显卡地把 .snkr 录像画成视频，用于在服务器上批量生成观战和报错录像
+// 用法: replay_render <file.snkr> <out.y4m | out/%05d.png> [--assets FILE] [--size WxH] [--fps N] [--threads N]
+// 画面由 CPU 渲染后端（SoftRasterizer）按游戏的相机和插值规则画出，帧率固定，与录像里的 tick 间隔无关
+// 写盘在 FrameWriter 的线程上，与下一帧的光栅化重叠；离线渲染不丢帧，写盘跟不上时等待
+#include "../SoftRasterizer.h"
+#include "../AtlasFormat.h"
+#include "../FrameWriter.h"
+#include "../MappedFile.h"
+#include "../Replay.h"
+#include "../SimThread.h"
+#include "../ThreadPool.h"
+#include "../Vfs.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 与游戏相同：一屏 20 格
+static const int kViewCells = 20;
+static const float kCellSize = 2.0f / kViewCells;
+
+static float HeadAngle(Vec2i dir) {
+    if (dir.x == 1) return 90.0f * 3.14159265f / 180.0f;
+    if (dir.x == -1) return -90.0f * 3.14159265f / 180.0f;
+    if (dir.y == -1) return 180.0f * 3.14159265f / 180.0f;
+    return 0.0f;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <file.snkr> <out.y4m | out/%%05d.png> [--assets FILE] [--size WxH] [--fps N] [--threads N]\n", argv[0]);
+        return 2;
+    }
+    const char* assetsPath = "assets.pak";
+    int width = 800, height = 800, fps = 60;
+    unsigned threads = 0;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--assets") == 0 && i + 1 < argc) assetsPath = argv[++i];
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) std::sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fps = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = (unsigned)std::max(std::atoi(argv[++i]), 1);
+    }
+
+    MappedFile file;
+    ReplayPlayer player;
+    if (!file.Open(argv[1]) || !player.Open(file.Data(), file.Size())) {
+        std::fprintf(stderr, "%s: cannot open or malformed replay\n", argv[1]);
+        return 1;
+    }
+    Vfs assets;
+    Span atlasFile;
+    if (assets.Mount(assetsPath)) atlasFile = assets.Read("textures.atlas");
+    if (!atlasFile) {
+        std::fprintf(stderr, "%s: no textures.atlas\n", assetsPath);
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    SoftRasterizer renderer(width, height, 1.0f / (kViewCells + 1), pool.Size() > 1 ? &pool : nullptr);
+    if (!renderer.SetAtlas(atlasFile.data, atlasFile.size)) {
+        std::fprintf(stderr, "%s: bad textures.atlas\n", assetsPath);
+        return 1;
+    }
+    float layerHead = 0.0f, layerBody = 0.0f, layerFood = 0.0f;
+    const AtlasHeader* header;
+    const AtlasEntry* entries;
+    Atlas::Parse(atlasFile.data, atlasFile.size, header, entries);
+    for (uint32_t i = 0; i < header->layers; ++i) {
+        if (std::strcmp(entries[i].name, "snake_head.png") == 0) layerHead = (float)i;
+        if (std::strcmp(entries[i].name, "snake_body1.png") == 0) layerBody = (float)i;
+        if (std::strcmp(entries[i].name, "food.png") == 0) layerFood = (float)i;
+    }
+
+    FrameWriter writer;
+    if (!writer.Open(argv[2], width, height, fps, false)) {
+        std::fprintf(stderr, "%s: cannot write (needs .y4m or a %%d PNG pattern)\n", argv[2]);
+        return 1;
+    }
+
+    const SnakeSim& sim = player.Sim();
+    // 大地图的墙由瓦片层画，CPU 后端没有，只在整张棋盘放得下时画边框
+    bool largeArena = sim.Width() > kViewCells || sim.Height() > kViewCells;
+    auto start = std::chrono::steady_clock::now();
+    // 与逻辑线程一样：第一个 tick 在开局后 MoveInterval 秒生效，之后每个 tick 的间隔取上一个 tick 之后的值
+    double tickTime = 0.0, interval = sim.MoveInterval();
+    bool more = true;
+    unsigned frames = 0;
+    for (;; ++frames) {
+        double now = (double)frames / fps;
+        while (more && now >= tickTime + interval) {
+            more = player.Step();
+            if (more) {
+                tickTime += interval;
+                interval = sim.MoveInterval();
+            }
+        }
+        // 最后一个 tick 的插值走完就结束
+        double t = std::min((now - tickTime) / interval, 1.0);
+        if (!more && frames > 0 && now - tickTime >= interval) break;
+
+        const SnakeBody& body = sim.Body();
+        Vec2i headOld = body.Previous(0), headNew = body.Front();
+        double cameraX = SimThread::CameraCenter(headOld.x + (headNew.x - headOld.x) * t, sim.Width(), kViewCells);
+        double cameraY = SimThread::CameraCenter(headOld.y + (headNew.y - headOld.y) * t, sim.Height(), kViewCells);
+        double half = kViewCells / 2.0 + 1.0;
+
+        renderer.BeginFrame(0.2f, 0.3f, 0.25f);
+        // 与游戏相同，从蛇头往后画
+        for (size_t i = 0; i < body.Size(); ++i) {
+            Vec2i oldPos = body.Previous(i), newPos = body[i];
+            double x = oldPos.x + (newPos.x - oldPos.x) * t + 0.5 - cameraX;
+            double y = oldPos.y + (newPos.y - oldPos.y) * t + 0.5 - cameraY;
+            if (std::fabs(x) > half || std::fabs(y) > half) continue;
+            if (i == 0)
+                renderer.AddSprite(true, { (float)(x * kCellSize), (float)(y * kCellSize), HeadAngle(sim.Direction()), layerHead, 1.0f, 1.0f, 1.0f, 1.0f });
+            else
+                renderer.AddSprite(true, { (float)(x * kCellSize), (float)(y * kCellSize), 0.0f, layerBody, 1.0f, 1.0f, 1.0f, 1.0f });
+        }
+        Vec2i food = sim.Food();
+        double fx = food.x + 0.5 - cameraX, fy = food.y + 0.5 - cameraY;
+        if (std::fabs(fx) <= half && std::fabs(fy) <= half)
+            renderer.AddSprite(true, { (float)(fx * kCellSize), (float)(fy * kCellSize), 0.0f, layerFood, 1.0f, 1.0f, 1.0f, 1.0f });
+        renderer.Flush();
+        if (!largeArena) renderer.DrawBorder();
+
+        uint8_t* frame = writer.Acquire(true);
+        std::memcpy(frame, renderer.Pixels(), (size_t)width * height * 4);
+        writer.Submit(frame);
+    }
+    writer.Close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    FrameWriter::Stats ws = writer.GetStats();
+    std::printf("%s: %llu ticks, length %zu -> %u frames (%.1f s of video) in %.2f s, %.1f frames/s, %.1f MB written%s\n",
+        argv[1], sim.Tick(), sim.Body().Size(), ws.written, (double)frames / fps, seconds, ws.written / seconds,
+        ws.bytes / 1048576.0, ws.written == frames ? "" : ", WRITE ERRORS");
+    return ws.written == frames ? 0 : 1;
+}
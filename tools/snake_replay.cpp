@@ -0,0 +1,44 @@
+// 录像校验：mmap 每个 .snkr 文件，无窗口重新模拟并与记录的结果比对
+// 用法: snake_replay <file.snkr>...
+#include "../Replay.h"
+#include "../MappedFile.h"
+#include <chrono>
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file.snkr>...\n", argv[0]);
+        return 2;
+    }
+
+    ReplayPlayer player;
+    MappedFile file;
+    int failures = 0;
+    unsigned long long totalTicks = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i < argc; ++i) {
+        if (!file.Open(argv[i])) {
+            std::fprintf(stderr, "%s: cannot open\n", argv[i]);
+            failures++;
+            continue;
+        }
+        ReplayResult r = player.Verify(file.Data(), file.Size());
+        if (!r.valid) {
+            std::fprintf(stderr, "%s: malformed replay\n", argv[i]);
+            failures++;
+        }
+        else if (!r.matches) {
+            std::fprintf(stderr, "%s: MISMATCH recorded %llu ticks / length %llu, simulated %llu ticks / length %llu\n",
+                argv[i], r.recorded.ticks, r.recorded.length, r.simulated.ticks, r.simulated.length);
+            failures++;
+        }
+        else if (argc == 2) {
+            std::printf("%s: ok, %llu ticks, length %llu\n", argv[i], r.simulated.ticks, r.simulated.length);
+        }
+        totalTicks += r.simulated.ticks;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%d replays, %d failed, %.0f ticks/sec, %.0f replays/min\n",
+        argc - 1, failures, totalTicks / seconds, (argc - 1) / seconds * 60.0);
+    return failures ? 1 : 0;
+}
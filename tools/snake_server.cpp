@@ -0,0 +1,53 @@
+// 联机房间服务器：无窗口，Ctrl+C 退出时打印统计
+// 用法: snake_server [--port N] [--bind ADDR] [--rooms N] [--room-size N] [--snakes N] [--food N] [--tick-rate HZ] [--threads N]
+#include "../RoomServer.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static RoomServer* running = nullptr;
+
+static void OnSignal(int) {
+    // Stop 只写一次 eventfd，可以在信号处理函数里调用
+    if (running) running->Stop();
+}
+
+int main(int argc, char** argv) {
+    ServerConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* name = argv[i];
+        const char* value = argv[i + 1];
+        if (std::strcmp(name, "--port") == 0) config.port = (uint16_t)std::atoi(value);
+        else if (std::strcmp(name, "--bind") == 0) config.bindAddress = value;
+        else if (std::strcmp(name, "--rooms") == 0) config.rooms = std::atoi(value);
+        else if (std::strcmp(name, "--room-size") == 0) config.roomSize = std::atoi(value);
+        else if (std::strcmp(name, "--snakes") == 0) config.snakesPerRoom = std::atoi(value);
+        else if (std::strcmp(name, "--food") == 0) config.foodPerRoom = std::atoi(value);
+        else if (std::strcmp(name, "--tick-rate") == 0) config.tickRate = std::atof(value);
+        else if (std::strcmp(name, "--threads") == 0) config.threads = (unsigned)std::atoi(value);
+        else {
+            std::fprintf(stderr, "unknown option %s\n", name);
+            return 2;
+        }
+    }
+
+    RoomServer server(config);
+    if (!server.Open()) return 1;
+    std::printf("listening on %s:%u, %d rooms of %dx%d, %d snakes each, %.0f ticks/s\n",
+        config.bindAddress.c_str(), server.Port(), config.rooms, config.roomSize, config.roomSize, config.snakesPerRoom, config.tickRate);
+    std::fflush(stdout);
+    running = &server;
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    server.Run();
+    running = nullptr;
+
+    const RoomServer::Stats& st = server.GetStats();
+    std::printf("ticks %llu (late %llu), tick time p50 %.1f ms p99 %.1f ms max %.2f ms\n",
+        st.ticks, st.lateTicks, st.tickTime.PercentileMs(0.5), st.tickTime.PercentileMs(0.99), st.tickTime.MaxMs());
+    std::printf("joins %llu, rejects %llu, timeouts %llu, clients at exit %zu\n", st.joins, st.rejects, st.timeouts, st.clients);
+    std::printf("in %llu packets / %llu bytes, out %llu packets / %llu bytes (%llu full, %llu delta snapshots)\n",
+        st.packetsIn, st.bytesIn, st.packetsOut, st.bytesOut, st.fullSnapshots, st.deltaSnapshots);
+    return 0;
+}